@@ -0,0 +1,18 @@
+// Retained layer composite shader
+// One triangle covers the screen and each fragment reads the layer texel
+// under it. Layers are the size of the target, so no sampler or UVs are
+// needed; the color is already premultiplied.
+
+@group(0) @binding(0) var layer_texture: texture_2d<f32>;
+
+@vertex
+fn vs_main(@builtin(vertex_index) vertex_index: u32) -> @builtin(position) vec4<f32> {
+    // (-1, -1), (3, -1), (-1, 3)
+    let corner = vec2<f32>(f32((vertex_index << 1u) & 2u), f32(vertex_index & 2u));
+    return vec4<f32>(corner * 2.0 - 1.0, 0.0, 1.0);
+}
+
+@fragment
+fn fs_main(@builtin(position) position: vec4<f32>) -> @location(0) vec4<f32> {
+    return textureLoad(layer_texture, vec2<i32>(position.xy), 0);
+}
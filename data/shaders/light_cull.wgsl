@@ -0,0 +1,89 @@
+// Tiled light culling
+// cs_project moves every light to scene pixels (one thread per light).
+// cs_bin then runs one workgroup per TILE_SIZE square tile: its threads
+// split the light list, test each light's circle against the tile rectangle
+// and append the hits to the tile's index list. Lit fragment shaders read
+// only the list of their own tile.
+
+const TILE_SIZE: u32 = 16u;          // LIGHT_TILE_SIZE in lighting.h
+const TILE_WORDS: u32 = 32u;         // LIGHT_TILE_WORDS: the count, then indices
+const MAX_TILE_LIGHTS: u32 = 31u;
+
+struct LightingUniforms {
+    view_proj: mat4x4<f32>,
+    ambient: vec4<f32>,
+    viewport: vec2<f32>,     // scene size in pixels
+    tile_count: vec2<u32>,   // tiles across and down
+    light_count: u32,
+};
+
+// Light as queued, in world space
+struct Light {
+    position: vec2<f32>,
+    radius: f32,
+    padding: f32,
+    color: vec4<f32>,
+};
+
+// The same light in scene pixels (y down, like @builtin(position))
+struct ScreenLight {
+    center: vec2<f32>,
+    radius: f32,
+    padding: f32,
+    color: vec4<f32>,
+};
+
+@group(0) @binding(0) var<uniform> lighting: LightingUniforms;
+@group(0) @binding(1) var<storage, read> lights: array<Light>;
+@group(0) @binding(2) var<storage, read_write> screen_lights: array<ScreenLight>;
+@group(0) @binding(3) var<storage, read_write> tiles: array<u32>;
+
+fn to_pixels(p: vec2<f32>) -> vec2<f32> {
+    let clip = lighting.view_proj * vec4<f32>(p, 0.0, 1.0);
+    let ndc = clip.xy / clip.w;
+    return vec2<f32>(ndc.x * 0.5 + 0.5, 0.5 - ndc.y * 0.5) * lighting.viewport;
+}
+
+@compute @workgroup_size(64)
+fn cs_project(@builtin(global_invocation_id) id: vec3<u32>) {
+    let i = id.x;
+    if (i >= lighting.light_count) {
+        return;
+    }
+    
+    let light = lights[i];
+    let center = to_pixels(light.position);
+    let edge = to_pixels(light.position + vec2<f32>(light.radius, 0.0));
+    screen_lights[i] = ScreenLight(center, distance(center, edge), 0.0, light.color);
+}
+
+var<workgroup> tile_hits: atomic<u32>;
+
+@compute @workgroup_size(64)
+fn cs_bin(@builtin(workgroup_id) tile: vec3<u32>, @builtin(local_invocation_index) local: u32) {
+    if (local == 0u) {
+        atomicStore(&tile_hits, 0u);
+    }
+    workgroupBarrier();
+    
+    let base = (tile.y * lighting.tile_count.x + tile.x) * TILE_WORDS;
+    let tile_min = vec2<f32>(tile.xy * TILE_SIZE);
+    let tile_max = tile_min + vec2<f32>(f32(TILE_SIZE));
+    for (var i = local; i < lighting.light_count; i += 64u) {
+        // Nearest point of the tile to the light's center
+        let light = screen_lights[i];
+        let nearest = clamp(light.center, tile_min, tile_max);
+        if (distance(nearest, light.center) < light.radius) {
+            let slot = atomicAdd(&tile_hits, 1u);
+            if (slot < MAX_TILE_LIGHTS) {
+                tiles[base + 1u + slot] = i;
+            }
+        }
+    }
+    workgroupBarrier();
+    
+    // Lights past the list's capacity are dropped for this tile
+    if (local == 0u) {
+        tiles[base] = min(atomicLoad(&tile_hits), MAX_TILE_LIGHTS);
+    }
+}
@@ -1,5 +1,6 @@
 // Sprite rendering shader with procedural arrow/triangle pattern
-// Uses transformation matrix for position, rotation, and scale
+// Uses transformation matrix for position, rotation, and scale, and is lit
+// by the lights of its screen tile
 
 struct Uniforms {
     transform: mat4x4<f32>,
@@ -8,6 +9,45 @@ struct Uniforms {
 
 @group(0) @binding(0) var<uniform> uniforms: Uniforms;
 
+// Tile light lists from light_cull.wgsl (LIGHTING_BIND_GROUP in lighting.h)
+const TILE_SIZE: u32 = 16u;
+const TILE_WORDS: u32 = 32u;
+
+struct LightingUniforms {
+    view_proj: mat4x4<f32>,
+    ambient: vec4<f32>,
+    viewport: vec2<f32>,
+    tile_count: vec2<u32>,
+    light_count: u32,
+};
+
+struct ScreenLight {
+    center: vec2<f32>,
+    radius: f32,
+    padding: f32,
+    color: vec4<f32>,
+};
+
+@group(1) @binding(0) var<uniform> lighting: LightingUniforms;
+@group(1) @binding(1) var<storage, read> screen_lights: array<ScreenLight>;
+@group(1) @binding(2) var<storage, read> tiles: array<u32>;
+
+// Ambient plus the lights binned into the pixel's tile, with a smooth
+// falloff to zero at each light's radius
+fn light_at(pixel: vec2<f32>) -> vec3<f32> {
+    let tile = min(vec2<u32>(pixel) / TILE_SIZE, lighting.tile_count - vec2<u32>(1u));
+    let base = (tile.y * lighting.tile_count.x + tile.x) * TILE_WORDS;
+    var total = lighting.ambient.rgb;
+    let count = tiles[base];
+    for (var k = 0u; k < count; k++) {
+        let light = screen_lights[tiles[base + 1u + k]];
+        let d = distance(pixel, light.center) / light.radius;
+        let falloff = saturate(1.0 - d * d);
+        total += light.color.rgb * falloff * falloff;
+    }
+    return total;
+}
+
 struct VertexInput {
     @location(0) position: vec2<f32>,
     @location(1) uv: vec2<f32>,
@@ -39,7 +79,7 @@ fn fs_main(in: VertexOutput) -> @location(0) vec4<f32> {
     let head = head_y > 0.0 && head_y < 0.3 && abs(uv.x) < (0.3 - head_y);
     
     if (body || head) {
-        return uniforms.color;
+        return vec4<f32>(uniforms.color.rgb * light_at(in.position.xy), uniforms.color.a);
     }
     
     // Transparent background - return fully transparent
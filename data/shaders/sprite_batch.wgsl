@@ -0,0 +1,104 @@
+// Batched textured sprite shader
+// One instanced draw renders every sprite: each instance picks its image by
+// texture-array layer and UV rect, so no rebinding is needed between images.
+// Sprites are drawn with their image's convex alpha mesh rather than a quad:
+// vertex_index walks a triangle fan over the mesh corners. Fragments are
+// lit by the lights of their screen tile.
+
+struct Uniforms {
+    view_proj: mat4x4<f32>,
+    mesh_vertices: u32,
+};
+
+@group(0) @binding(0) var<uniform> uniforms: Uniforms;
+@group(0) @binding(1) var sprite_texture: texture_2d_array<f32>;
+@group(0) @binding(2) var sprite_sampler: sampler;
+// mesh_vertices corners per atlas image, 0..1 over the image with v down
+@group(0) @binding(3) var<storage, read> mesh_points: array<vec2<f32>>;
+
+// Tile light lists from light_cull.wgsl (LIGHTING_BIND_GROUP in lighting.h)
+const TILE_SIZE: u32 = 16u;
+const TILE_WORDS: u32 = 32u;
+
+struct LightingUniforms {
+    view_proj: mat4x4<f32>,
+    ambient: vec4<f32>,
+    viewport: vec2<f32>,
+    tile_count: vec2<u32>,
+    light_count: u32,
+};
+
+struct ScreenLight {
+    center: vec2<f32>,
+    radius: f32,
+    padding: f32,
+    color: vec4<f32>,
+};
+
+@group(1) @binding(0) var<uniform> lighting: LightingUniforms;
+@group(1) @binding(1) var<storage, read> screen_lights: array<ScreenLight>;
+@group(1) @binding(2) var<storage, read> tiles: array<u32>;
+
+// Ambient plus the lights binned into the pixel's tile, with a smooth
+// falloff to zero at each light's radius
+fn light_at(pixel: vec2<f32>) -> vec3<f32> {
+    let tile = min(vec2<u32>(pixel) / TILE_SIZE, lighting.tile_count - vec2<u32>(1u));
+    let base = (tile.y * lighting.tile_count.x + tile.x) * TILE_WORDS;
+    var total = lighting.ambient.rgb;
+    let count = tiles[base];
+    for (var k = 0u; k < count; k++) {
+        let light = screen_lights[tiles[base + 1u + k]];
+        let d = distance(pixel, light.center) / light.radius;
+        let falloff = saturate(1.0 - d * d);
+        total += light.color.rgb * falloff * falloff;
+    }
+    return total;
+}
+
+struct VertexInput {
+    @builtin(vertex_index) vertex_index: u32,
+    // Per-instance
+    @location(0) position: vec3<f32>,
+    @location(1) rotation: f32,
+    @location(2) size: vec2<f32>,
+    @location(3) uv_rect: vec4<f32>,
+    @location(4) layer_mesh: vec2<u32>,
+    @location(5) color: vec4<f32>,
+};
+
+struct VertexOutput {
+    @builtin(position) position: vec4<f32>,
+    @location(0) uv: vec2<f32>,
+    @location(1) @interpolate(flat) layer: u32,
+    @location(2) color: vec4<f32>,
+};
+
+@vertex
+fn vs_main(in: VertexInput) -> VertexOutput {
+    // Fan triangle t uses corners 0, t + 1, t + 2
+    let triangle = in.vertex_index / 3u;
+    let k = in.vertex_index % 3u;
+    let corner_index = select(triangle + k, 0u, k == 0u);
+    let p = mesh_points[in.layer_mesh.y * uniforms.mesh_vertices + corner_index];
+    
+    // Same convention as the player sprite: angle 0 faces +y, positive
+    // angles turn clockwise. Image rows run top-down while world y runs up,
+    // so flip y.
+    let c = cos(in.rotation);
+    let s = sin(in.rotation);
+    let local = vec2<f32>(p.x - 0.5, 0.5 - p.y) * in.size;
+    let rotated = vec2<f32>(local.x * c + local.y * s, -local.x * s + local.y * c);
+    
+    var out: VertexOutput;
+    out.position = uniforms.view_proj * vec4<f32>(in.position.xy + rotated, in.position.z, 1.0);
+    out.uv = mix(in.uv_rect.xy, in.uv_rect.zw, p);
+    out.layer = in.layer_mesh.x;
+    out.color = in.color;
+    return out;
+}
+
+@fragment
+fn fs_main(in: VertexOutput) -> @location(0) vec4<f32> {
+    let texel = textureSample(sprite_texture, sprite_sampler, in.uv, in.layer);
+    return vec4<f32>(texel.rgb * light_at(in.position.xy), texel.a) * in.color;
+}
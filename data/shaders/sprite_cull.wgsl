@@ -0,0 +1,98 @@
+// GPU sprite culling
+// One thread per entity tests the circle through its image's corners
+// against the visible rectangle (grown for depth like camera_box_visible)
+// and appends an instance for each survivor. The append counter is the
+// instance count of the indirect draw, so the CPU never reads it back.
+
+// Entity record, same layout as Sprite in game.h
+struct Entity {
+    x: f32,
+    y: f32,
+    z: f32,
+    angle: f32,
+    speed: f32,
+};
+
+// Atlas image as the cull pass needs it
+struct Image {
+    uv_rect: vec4<f32>,
+    size: vec2<f32>,   // native size in pixels
+    radius: f32,       // half the diagonal
+    layer: u32,
+};
+
+// SpriteInstance in sprite_batch.h, written field by field (48 bytes)
+struct Instance {
+    x: f32,
+    y: f32,
+    z: f32,
+    rotation: f32,
+    width: f32,
+    height: f32,
+    u0: f32,
+    v0: f32,
+    u1: f32,
+    v1: f32,
+    layer_mesh: u32,   // layer in the low 16 bits, mesh in the high 16
+    color: u32,
+};
+
+// Arguments of DrawIndirect
+struct DrawArgs {
+    vertex_count: u32,
+    instance_count: atomic<u32>,
+    first_vertex: u32,
+    first_instance: u32,
+};
+
+struct CullUniforms {
+    center: vec2<f32>,       // camera center in world space
+    half_extent: vec2<f32>,  // half the visible rectangle at z = 0
+    entity_count: u32,
+    image_count: u32,
+    camera_distance: f32,
+    padding: u32,
+};
+
+@group(0) @binding(0) var<uniform> cull: CullUniforms;
+@group(0) @binding(1) var<storage, read> entities: array<Entity>;
+@group(0) @binding(2) var<storage, read> images: array<Image>;
+@group(0) @binding(3) var<storage, read_write> instances: array<Instance>;
+@group(0) @binding(4) var<storage, read_write> draw_args: DrawArgs;
+// Atlas image per entity, two u16 per word (the animation's current frame)
+@group(0) @binding(5) var<storage, read> frames: array<u32>;
+
+@compute @workgroup_size(64)
+fn cs_main(@builtin(global_invocation_id) id: vec3<u32>) {
+    let i = id.x;
+    if (i >= cull.entity_count) {
+        return;
+    }
+    
+    // Entity i shows its animation frame, as on the CPU path
+    let e = entities[i];
+    let image_index = min((frames[i / 2u] >> ((i & 1u) * 16u)) & 0xFFFFu, cull.image_count - 1u);
+    let image = images[image_index];
+    
+    let grow = select(1.0, (cull.camera_distance - e.z) / cull.camera_distance, e.z < 0.0);
+    let distance = abs(vec2<f32>(e.x, e.y) - cull.center);
+    if (any(distance > cull.half_extent * grow + vec2<f32>(image.radius))) {
+        return;
+    }
+    
+    let slot = atomicAdd(&draw_args.instance_count, 1u);
+    var out: Instance;
+    out.x = e.x;
+    out.y = e.y;
+    out.z = e.z;
+    out.rotation = e.angle;
+    out.width = image.size.x;
+    out.height = image.size.y;
+    out.u0 = image.uv_rect.x;
+    out.v0 = image.uv_rect.y;
+    out.u1 = image.uv_rect.z;
+    out.v1 = image.uv_rect.w;
+    out.layer_mesh = image.layer | (image_index << 16u);
+    out.color = 0xFFFFFFFFu;
+    instances[slot] = out;
+}
@@ -0,0 +1,33 @@
+// Dynamic resolution upscale shader
+// One triangle covers the surface and samples the drawn top-left part of
+// the scene target with bilinear filtering.
+
+struct Uniforms {
+    uv_scale: vec2<f32>,
+    uv_max: vec2<f32>,
+};
+
+@group(0) @binding(0) var<uniform> uniforms: Uniforms;
+@group(0) @binding(1) var scene_texture: texture_2d<f32>;
+@group(0) @binding(2) var scene_sampler: sampler;
+
+struct VertexOutput {
+    @builtin(position) position: vec4<f32>,
+    @location(0) uv: vec2<f32>,
+};
+
+@vertex
+fn vs_main(@builtin(vertex_index) vertex_index: u32) -> VertexOutput {
+    // (-1, -1), (3, -1), (-1, 3); uv runs 0..1 over the screen with v down
+    let corner = vec2<f32>(f32((vertex_index << 1u) & 2u), f32(vertex_index & 2u));
+    var out: VertexOutput;
+    out.position = vec4<f32>(corner * 2.0 - 1.0, 0.0, 1.0);
+    out.uv = vec2<f32>(corner.x, 1.0 - corner.y);
+    return out;
+}
+
+@fragment
+fn fs_main(in: VertexOutput) -> @location(0) vec4<f32> {
+    let uv = min(in.uv * uniforms.uv_scale, uniforms.uv_max);
+    return textureSample(scene_texture, scene_sampler, uv);
+}
@@ -0,0 +1,107 @@
+#include "anim.h"
+#include <math.h>
+#include <stdio.h>
+
+// Clip tables
+static uint16_t timeline[ANIM_MAX_TIMELINE];
+static uint32_t clip_start[ANIM_MAX_CLIPS];  // first timeline step
+static float clip_length[ANIM_MAX_CLIPS];    // seconds
+static float clip_loops[ANIM_MAX_CLIPS];     // 1 wraps, 0 holds the end
+static int clip_count = 0;
+
+// Player state, one array per field
+static float player_time[ANIM_MAX_PLAYERS];
+static float player_rate[ANIM_MAX_PLAYERS];
+static float player_length[ANIM_MAX_PLAYERS];
+static float player_inv_length[ANIM_MAX_PLAYERS];
+static float player_loops[ANIM_MAX_PLAYERS];
+static uint32_t player_start[ANIM_MAX_PLAYERS];
+static uint32_t player_step[ANIM_MAX_PLAYERS];   // timeline index of the current frame
+static uint16_t player_frame[ANIM_MAX_PLAYERS];
+
+// Steps a frame is shown for, at least one
+static int frame_steps(float duration) {
+    int steps = (int)(duration * ANIM_STEPS_PER_SECOND + 0.5f);
+    return steps < 1 ? 1 : steps;
+}
+
+int anim_bake(const AnimClipDef* clips, int count) {
+    if (count > ANIM_MAX_CLIPS) {
+        printf("Too many animation clips: %d (max %d)\n", count, ANIM_MAX_CLIPS);
+        return 1;
+    }
+    
+    int used = 0;
+    for (int c = 0; c < count; c++) {
+        const AnimClipDef* def = &clips[c];
+        if (def->frame_count < 1) {
+            printf("Animation clip %d has no frames\n", c);
+            return 1;
+        }
+        
+        // Ping-pong plays the inner frames again backwards: 0 1 2 3 2 1
+        int sequence = def->frame_count;
+        if (def->mode == ANIM_PING_PONG && def->frame_count > 2) sequence += def->frame_count - 2;
+        
+        clip_start[c] = (uint32_t)used;
+        for (int k = 0; k < sequence; k++) {
+            int frame = k < def->frame_count ? k : 2 * (def->frame_count - 1) - k;
+            int steps = frame_steps(def->durations[frame]);
+            if (used + steps + 1 > ANIM_MAX_TIMELINE) {
+                printf("Animation timeline full (%d steps)\n", ANIM_MAX_TIMELINE);
+                return 1;
+            }
+            for (int s = 0; s < steps; s++) timeline[used++] = def->images[frame];
+        }
+        clip_length[c] = (used - (int)clip_start[c]) / ANIM_STEPS_PER_SECOND;
+        clip_loops[c] = def->mode == ANIM_ONCE ? 0.0f : 1.0f;
+        
+        // One step past the end, for time landing exactly on the length:
+        // held clips stay on their last frame, looping ones are back at
+        // their first
+        timeline[used++] = def->mode == ANIM_ONCE ? def->images[def->frame_count - 1] : def->images[0];
+    }
+    clip_count = count;
+    return 0;
+}
+
+int anim_clip_count(void) {
+    return clip_count;
+}
+
+void anim_play(int player, int clip, float time, float rate) {
+    if (player < 0 || player >= ANIM_MAX_PLAYERS || clip < 0 || clip >= clip_count) return;
+    float length = clip_length[clip];
+    player_start[player] = clip_start[clip];
+    player_length[player] = length;
+    player_inv_length[player] = 1.0f / length;
+    player_loops[player] = clip_loops[clip];
+    player_rate[player] = rate > 0.0f ? rate : 0.0f;
+    player_time[player] = clip_loops[clip] > 0.0f ? fmodf(time, length) : fminf(time, length);
+    player_frame[player] = timeline[clip_start[clip]];
+}
+
+void anim_advance(int count, float dt) {
+    if (count > ANIM_MAX_PLAYERS) count = ANIM_MAX_PLAYERS;
+    
+    // Every player takes the same path: compute both the wrapped and the
+    // held time and blend by the loop flag. Times are never negative, so
+    // truncating is flooring, and the loop vectorizes.
+    for (int i = 0; i < count; i++) {
+        float t = player_time[i] + dt * player_rate[i];
+        float wrapped = t - (float)(int32_t)(t * player_inv_length[i]) * player_length[i];
+        float held = t < player_length[i] ? t : player_length[i];
+        t = held + player_loops[i] * (wrapped - held);
+        player_time[i] = t;
+        player_step[i] = player_start[i] + (uint32_t)(int32_t)(t * ANIM_STEPS_PER_SECOND);
+    }
+    
+    // The table lookup is a gather, which would keep the loop above scalar
+    for (int i = 0; i < count; i++) {
+        player_frame[i] = timeline[player_step[i]];
+    }
+}
+
+const uint16_t* anim_frames(void) {
+    return player_frame;
+}
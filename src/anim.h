@@ -0,0 +1,50 @@
+#ifndef ANIM_H
+#define ANIM_H
+
+#include <stdint.h>
+
+// Batched sprite-sheet animation
+//
+// Clips (a list of atlas images with per-frame durations and a loop mode)
+// are baked into flat tables: every clip becomes a run of a timeline that
+// holds its frame for each 1/ANIM_STEPS_PER_SECOND step, so looking a frame
+// up is one index instead of a search. Playback state is kept per player
+// in parallel arrays, with each player's clip parameters copied in when it
+// starts, so anim_advance is one branch-free loop over plain arrays that
+// writes the atlas image of every player into anim_frames().
+
+#define ANIM_MAX_CLIPS 64
+#define ANIM_MAX_TIMELINE 8192     // steps over all clips
+#define ANIM_MAX_PLAYERS 131072    // even, so the frame array packs into u32 pairs
+#define ANIM_STEPS_PER_SECOND 60.0f
+
+typedef enum {
+    ANIM_LOOP,       // restart after the last frame
+    ANIM_ONCE,       // hold the last frame
+    ANIM_PING_PONG,  // play forward, then back, and repeat
+} AnimLoopMode;
+
+typedef struct {
+    const uint16_t* images;   // atlas image per frame
+    const float* durations;   // seconds per frame (at least one step each)
+    int frame_count;
+    AnimLoopMode mode;
+} AnimClipDef;
+
+// Bake clip definitions into the tables, replacing any earlier ones. Players
+// must be restarted afterwards. Returns 0 on success.
+int anim_bake(const AnimClipDef* clips, int count);
+
+int anim_clip_count(void);
+
+// Start a player on a clip, time seconds in, at rate times normal speed
+// (negative rates are clamped to 0)
+void anim_play(int player, int clip, float time, float rate);
+
+// Advance players [0, count) by dt seconds and update their frames
+void anim_advance(int count, float dt);
+
+// Atlas image per player, as of the last anim_advance
+const uint16_t* anim_frames(void);
+
+#endif // ANIM_H
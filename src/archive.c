@@ -0,0 +1,267 @@
+#include "archive.h"
+#include "platform.h"
+#include <stdio.h>
+#include <string.h>
+
+#define ARCHIVE_MAGIC "PFPK"
+#define ARCHIVE_VERSION 1
+#define LZ4_MIN_MATCH 4
+
+// Buffered reader over one entry's packed bytes
+typedef struct {
+    FILE* file;
+    uint32_t remaining;  // packed bytes not yet read from the file
+    uint32_t pos;
+    uint32_t len;
+    uint8_t chunk[ARCHIVE_READ_CHUNK];
+} ArchiveStream;
+
+// Mounted archive and load statistics
+static Archive mounted;
+static int assets_loaded = 0;
+static size_t assets_bytes_read = 0;     // bytes fetched from storage
+static size_t assets_bytes_decoded = 0;  // bytes delivered to callers
+static double assets_load_ms = 0.0;
+
+int archive_open(Archive* archive, const char* path, Arena* arena) {
+    memset(archive, 0, sizeof(*archive));
+    
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        printf("Failed to open archive: %s\n", path);
+        return 1;
+    }
+    
+    char magic[4];
+    uint32_t header[3];
+    if (fread(magic, 1, 4, f) != 4 || memcmp(magic, ARCHIVE_MAGIC, 4) != 0 ||
+        fread(header, sizeof(uint32_t), 3, f) != 3 || header[0] != ARCHIVE_VERSION) {
+        printf("Not a supported archive: %s\n", path);
+        fclose(f);
+        return 1;
+    }
+    
+    uint32_t count = header[1];
+    ArchiveEntry* entries = (ArchiveEntry*)arena_alloc(arena, count * sizeof(ArchiveEntry));
+    if (!entries || fread(entries, sizeof(ArchiveEntry), count, f) != count) {
+        printf("Failed to read archive index: %s\n", path);
+        fclose(f);
+        return 1;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        entries[i].name[ARCHIVE_NAME_LENGTH - 1] = '\0';
+    }
+    
+    archive->file = f;
+    archive->entry_count = count;
+    archive->entries = entries;
+    return 0;
+}
+
+void archive_close(Archive* archive) {
+    if (archive->file) fclose(archive->file);
+    memset(archive, 0, sizeof(*archive));
+}
+
+const ArchiveEntry* archive_find(const Archive* archive, const char* name) {
+    for (uint32_t i = 0; i < archive->entry_count; i++) {
+        if (strcmp(archive->entries[i].name, name) == 0) return &archive->entries[i];
+    }
+    return NULL;
+}
+
+static int stream_refill(ArchiveStream* s) {
+    if (s->remaining == 0) return 0;
+    uint32_t n = s->remaining < ARCHIVE_READ_CHUNK ? s->remaining : ARCHIVE_READ_CHUNK;
+    if (fread(s->chunk, 1, n, s->file) != n) return 0;
+    s->remaining -= n;
+    s->pos = 0;
+    s->len = n;
+    return 1;
+}
+
+// Next packed byte, or -1 at the end of the entry
+static int stream_byte(ArchiveStream* s) {
+    if (s->pos == s->len && !stream_refill(s)) return -1;
+    return s->chunk[s->pos++];
+}
+
+// Copy n packed bytes to dst. Whatever is not already buffered is read
+// from the file directly into dst. Returns 0 on success.
+static int stream_copy(ArchiveStream* s, uint8_t* dst, uint32_t n) {
+    uint32_t buffered = s->len - s->pos;
+    uint32_t take = n < buffered ? n : buffered;
+    memcpy(dst, s->chunk + s->pos, take);
+    s->pos += take;
+    n -= take;
+    if (n == 0) return 0;
+    
+    if (n > s->remaining || fread(dst + take, 1, n, s->file) != n) return 1;
+    s->remaining -= n;
+    return 0;
+}
+
+static int stream_at_end(const ArchiveStream* s) {
+    return s->pos == s->len && s->remaining == 0;
+}
+
+// LZ4 length extension: keep adding bytes while they are 255
+static int read_length(ArchiveStream* s, uint32_t* length) {
+    int b;
+    do {
+        b = stream_byte(s);
+        if (b < 0) return 1;
+        *length += (uint32_t)b;
+    } while (b == 255);
+    return 0;
+}
+
+// Decode one LZ4 block into dst. Matches refer back into dst itself, so
+// no window buffer is needed.
+static int lz4_decode(ArchiveStream* s, uint8_t* dst, uint32_t size) {
+    uint32_t out = 0;
+    for (;;) {
+        int token = stream_byte(s);
+        if (token < 0) return 1;
+        
+        uint32_t literals = (uint32_t)token >> 4;
+        if (literals == 15 && read_length(s, &literals)) return 1;
+        if (literals > size - out || stream_copy(s, dst + out, literals)) return 1;
+        out += literals;
+        
+        // The last sequence is literals only
+        if (stream_at_end(s)) break;
+        
+        int lo = stream_byte(s);
+        int hi = stream_byte(s);
+        if (lo < 0 || hi < 0) return 1;
+        uint32_t offset = (uint32_t)lo | ((uint32_t)hi << 8);
+        if (offset == 0 || offset > out) return 1;
+        
+        uint32_t match = (uint32_t)token & 15;
+        if (match == 15 && read_length(s, &match)) return 1;
+        match += LZ4_MIN_MATCH;
+        if (match > size - out) return 1;
+        
+        uint8_t* to = dst + out;
+        const uint8_t* from = to - offset;
+        if (offset >= match) {
+            memcpy(to, from, match);
+        } else {
+            // Overlapping match repeats the last 'offset' bytes
+            for (uint32_t i = 0; i < match; i++) to[i] = from[i];
+        }
+        out += match;
+    }
+    return out == size ? 0 : 1;
+}
+
+int archive_read(Archive* archive, const ArchiveEntry* entry, void* dest) {
+    if (!archive->file || fseek(archive->file, entry->offset, SEEK_SET) != 0) return 1;
+    
+    ArchiveStream s;
+    s.file = archive->file;
+    s.remaining = entry->packed_size;
+    s.pos = 0;
+    s.len = 0;
+    
+    int result = 1;
+    switch (entry->codec) {
+        case ARCHIVE_STORED:
+            result = entry->packed_size == entry->size ? stream_copy(&s, (uint8_t*)dest, entry->size) : 1;
+            break;
+        case ARCHIVE_LZ4:
+            result = lz4_decode(&s, (uint8_t*)dest, entry->size);
+            break;
+    }
+    if (result) printf("Corrupt archive entry: %s\n", entry->name);
+    return result;
+}
+
+int assets_mount(const char* path) {
+    assets_unmount();
+    if (archive_open(&mounted, path, arena_persistent())) return 1;
+    printf("Mounted archive: %s (%u entries)\n", path, mounted.entry_count);
+    return 0;
+}
+
+void assets_unmount(void) {
+    archive_close(&mounted);
+}
+
+size_t assets_size(const char* name) {
+    const ArchiveEntry* entry = archive_find(&mounted, name);
+    if (entry) return entry->size;
+    
+    FILE* f = fopen(name, "rb");
+    if (!f) return 0;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+    return size > 0 ? (size_t)size : 0;
+}
+
+int assets_read(const char* name, void* dest, size_t capacity) {
+    double start = platform_now_ms();
+    size_t read_bytes = 0;
+    size_t size = 0;
+    
+    const ArchiveEntry* entry = archive_find(&mounted, name);
+    if (entry) {
+        if (entry->size > capacity || archive_read(&mounted, entry, dest)) return 1;
+        read_bytes = entry->packed_size;
+        size = entry->size;
+    } else {
+        FILE* f = fopen(name, "rb");
+        if (!f) {
+            printf("Failed to open asset: %s\n", name);
+            return 1;
+        }
+        fseek(f, 0, SEEK_END);
+        long file_size = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        int ok = file_size >= 0 && (size_t)file_size <= capacity &&
+                 fread(dest, 1, (size_t)file_size, f) == (size_t)file_size;
+        fclose(f);
+        if (!ok) {
+            printf("Failed to read asset: %s\n", name);
+            return 1;
+        }
+        read_bytes = size = (size_t)file_size;
+    }
+    
+    assets_loaded++;
+    assets_bytes_read += read_bytes;
+    assets_bytes_decoded += size;
+    assets_load_ms += platform_now_ms() - start;
+    return 0;
+}
+
+char* assets_load(Arena* arena, const char* name, size_t* out_size) {
+    size_t size = assets_size(name);
+    if (size == 0) {
+        printf("Asset not found: %s\n", name);
+        return NULL;
+    }
+    
+    ArenaMark mark = arena_mark(arena);
+    char* buffer = (char*)arena_alloc_aligned(arena, size + 1, 1);
+    if (!buffer) {
+        printf("Failed to allocate memory for asset: %s\n", name);
+        return NULL;
+    }
+    if (assets_read(name, buffer, size)) {
+        arena_rewind(arena, mark);
+        return NULL;
+    }
+    buffer[size] = '\0';
+    
+    if (out_size) *out_size = size;
+    return buffer;
+}
+
+void assets_report(void) {
+    printf("Assets: %d loaded from %s, %.1f KB read -> %.1f KB, %.2f ms\n",
+           assets_loaded, mounted.file ? "archive" : "loose files",
+           assets_bytes_read / 1024.0, assets_bytes_decoded / 1024.0, assets_load_ms);
+}
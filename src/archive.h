@@ -0,0 +1,75 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "arena.h"
+
+// Indexed asset archive (written by tools/build_pak.py)
+//
+// One file holds an index table followed by the entries, each stored raw or
+// as an LZ4 block and aligned to ARCHIVE_ALIGN. Reading an entry seeks to it
+// and decompresses straight into the caller's buffer through a small chunk
+// window, so an asset never exists twice in memory.
+
+#define ARCHIVE_NAME_LENGTH 48
+#define ARCHIVE_ALIGN 16
+#define ARCHIVE_READ_CHUNK 4096  // bytes of compressed input buffered at once
+
+typedef enum {
+    ARCHIVE_STORED = 0,
+    ARCHIVE_LZ4 = 1,
+} ArchiveCodec;
+
+typedef struct {
+    char name[ARCHIVE_NAME_LENGTH];
+    uint32_t codec;        // ArchiveCodec
+    uint32_t offset;       // from the start of the archive
+    uint32_t packed_size;  // bytes on disk
+    uint32_t size;         // bytes once decoded
+} ArchiveEntry;
+
+typedef struct {
+    FILE* file;
+    uint32_t entry_count;
+    ArchiveEntry* entries;
+} Archive;
+
+// Open an archive and read its index into arena. Returns 0 on success.
+int archive_open(Archive* archive, const char* path, Arena* arena);
+
+void archive_close(Archive* archive);
+
+// Look up an entry by name. Returns NULL if absent.
+const ArchiveEntry* archive_find(const Archive* archive, const char* name);
+
+// Decode an entry into dest, which must hold entry->size bytes.
+// Returns 0 on success.
+int archive_read(Archive* archive, const ArchiveEntry* entry, void* dest);
+
+// Game asset access
+//
+// Assets are opened by path. When an archive is mounted they come from it,
+// otherwise (or if the archive lacks the entry) from loose files, which is
+// the plain --preload-file path.
+
+// Mount an archive for all following asset loads. Returns 0 on success.
+int assets_mount(const char* path);
+
+void assets_unmount(void);
+
+// Decoded size of an asset, or 0 if it does not exist
+size_t assets_size(const char* name);
+
+// Read a whole asset into dest (capacity bytes). Returns 0 on success.
+int assets_read(const char* name, void* dest, size_t capacity);
+
+// Read an asset into arena, NUL-terminated. Returns NULL on failure.
+// out_size (optional) receives the size without the terminator.
+char* assets_load(Arena* arena, const char* name, size_t* out_size);
+
+// Print how many assets were loaded, from where, and how long it took
+void assets_report(void);
+
+#endif // ARCHIVE_H
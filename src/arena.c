@@ -0,0 +1,134 @@
+#include "arena.h"
+#include "platform.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/heap.h>
+#endif
+
+static Arena persistent_arena;
+static Arena level_arena;
+static Arena frame_arena;
+
+int arena_init(Arena* arena, const char* name, size_t capacity) {
+    memset(arena, 0, sizeof(*arena));
+    arena->name = name;
+    arena->base = (uint8_t*)malloc(capacity);
+    if (!arena->base) {
+        printf("Failed to reserve %s arena (%zu bytes)\n", name, capacity);
+        return 1;
+    }
+    arena->capacity = capacity;
+    return 0;
+}
+
+void arena_free(Arena* arena) {
+    free(arena->base);
+    arena->base = NULL;
+    arena->capacity = 0;
+    arena->used = 0;
+}
+
+void* arena_alloc_aligned(Arena* arena, size_t size, size_t align) {
+    size_t start = (arena->used + align - 1) & ~(align - 1);
+    if (start + size > arena->capacity) {
+        if (!arena->failed++) {
+            printf("%s arena exhausted: %zu of %zu bytes used, %zu requested\n",
+                   arena->name, arena->used, arena->capacity, size);
+        }
+        return NULL;
+    }
+    
+    arena->used = start + size;
+    if (arena->used > arena->high_water) arena->high_water = arena->used;
+    return arena->base + start;
+}
+
+void* arena_alloc(Arena* arena, size_t size) {
+    return arena_alloc_aligned(arena, size, ARENA_DEFAULT_ALIGN);
+}
+
+void* arena_calloc(Arena* arena, size_t size) {
+    void* p = arena_alloc(arena, size);
+    if (p) memset(p, 0, size);
+    return p;
+}
+
+void arena_reset(Arena* arena) {
+    arena->used = 0;
+}
+
+ArenaMark arena_mark(const Arena* arena) {
+    return arena->used;
+}
+
+void arena_rewind(Arena* arena, ArenaMark mark) {
+    if (mark <= arena->used) arena->used = mark;
+}
+
+char* arena_load_file(Arena* arena, const char* path, size_t* out_size) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        printf("Failed to open file: %s\n", path);
+        return NULL;
+    }
+    
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    
+    char* buffer = (char*)arena_alloc_aligned(arena, size + 1, 1);
+    if (!buffer) {
+        printf("Failed to allocate memory for file: %s\n", path);
+        fclose(f);
+        return NULL;
+    }
+    
+    size_t read = fread(buffer, 1, size, f);
+    buffer[read] = '\0';
+    fclose(f);
+    
+    if (out_size) *out_size = read;
+    printf("Loaded file: %s (%ld bytes)\n", path, size);
+    return buffer;
+}
+
+int memory_init(void) {
+    if (persistent_arena.base) return 0;
+    if (arena_init(&persistent_arena, "persistent", PERSISTENT_ARENA_SIZE)) return 1;
+    if (arena_init(&level_arena, "level", LEVEL_ARENA_SIZE)) return 1;
+    if (arena_init(&frame_arena, "frame", FRAME_ARENA_SIZE)) return 1;
+    return 0;
+}
+
+Arena* arena_persistent(void) {
+    return &persistent_arena;
+}
+
+Arena* arena_level(void) {
+    return &level_arena;
+}
+
+Arena* arena_frame(void) {
+    return &frame_arena;
+}
+
+static void report_arena(const Arena* arena) {
+    printf("  %-10s used %8zu  high-water %8zu  capacity %8zu  (%.0f%%)%s\n",
+           arena->name, arena->used, arena->high_water, arena->capacity,
+           arena->capacity ? 100.0 * arena->high_water / arena->capacity : 0.0,
+           arena->failed ? "  EXHAUSTED" : "");
+}
+
+EMSCRIPTEN_KEEPALIVE
+void memory_report(void) {
+    printf("Memory report:\n");
+    report_arena(&persistent_arena);
+    report_arena(&level_arena);
+    report_arena(&frame_arena);
+#ifdef __EMSCRIPTEN__
+    printf("  wasm heap  %zu bytes\n", emscripten_get_heap_size());
+#endif
+}
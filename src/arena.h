@@ -0,0 +1,72 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Linear (bump) allocators with fixed budgets
+//
+// Three arenas cover every allocation lifetime in the game:
+//   persistent - lives until shutdown (shader sources, font tables)
+//   level      - reset when a level is unloaded
+//   frame      - reset at the top of every render_frame (render thread only)
+// Each is a single block reserved at startup, so steady-state frames never
+// call malloc and the WASM heap can be sized up front (see Makefile
+// INITIAL_MEMORY).
+
+#define PERSISTENT_ARENA_SIZE (4 * 1024 * 1024)
+#define LEVEL_ARENA_SIZE (16 * 1024 * 1024)
+#define FRAME_ARENA_SIZE (2 * 1024 * 1024)
+#define ARENA_DEFAULT_ALIGN 16
+
+typedef struct {
+    const char* name;
+    uint8_t* base;
+    size_t capacity;
+    size_t used;
+    size_t high_water;  // largest 'used' value seen since init
+    int failed;         // allocations refused for lack of space
+} Arena;
+
+// Saved position to rewind to, for scoped temporary allocations
+typedef size_t ArenaMark;
+
+// Reserve the backing block. Returns 0 on success.
+int arena_init(Arena* arena, const char* name, size_t capacity);
+
+// Release the backing block
+void arena_free(Arena* arena);
+
+// Allocate size bytes aligned to align (a power of two). Returns NULL when
+// the arena's budget is exhausted.
+void* arena_alloc_aligned(Arena* arena, size_t size, size_t align);
+
+// Allocate with ARENA_DEFAULT_ALIGN
+void* arena_alloc(Arena* arena, size_t size);
+
+// Allocate and zero
+void* arena_calloc(Arena* arena, size_t size);
+
+// Free everything allocated from the arena
+void arena_reset(Arena* arena);
+
+// Scoped temporaries: take a mark, allocate, then rewind to the mark
+ArenaMark arena_mark(const Arena* arena);
+void arena_rewind(Arena* arena, ArenaMark mark);
+
+// Read a whole file into the arena, NUL-terminated. Returns NULL on failure.
+// out_size (optional) receives the file size without the terminator.
+char* arena_load_file(Arena* arena, const char* path, size_t* out_size);
+
+// Create the global arenas. Returns 0 on success.
+int memory_init(void);
+
+// Global arenas (valid after memory_init)
+Arena* arena_persistent(void);
+Arena* arena_level(void);
+Arena* arena_frame(void);
+
+// Print used / high-water / capacity for every arena plus heap size
+void memory_report(void);
+
+#endif // ARENA_H
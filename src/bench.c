@@ -0,0 +1,136 @@
+#include "bench.h"
+#include "game.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* phase_names[BENCH_PHASE_COUNT] = {
+    "simulate", "snapshot", "hud", "record", "submit",
+};
+
+static BenchConfig config;
+static int active = 0;
+static int frame_index = 0;  // frames closed so far, warm-up included
+static uint32_t rng_state = 0;
+
+// Samples of the measured frames
+static float frame_samples[BENCH_MAX_FRAMES];
+static float cpu_samples[BENCH_MAX_FRAMES];
+static float phase_samples[BENCH_PHASE_COUNT][BENCH_MAX_FRAMES];
+static double current_phase[BENCH_PHASE_COUNT];
+static int phase_used[BENCH_PHASE_COUNT];
+static float sorted[BENCH_MAX_FRAMES];  // scratch for percentiles
+
+static float bench_rand(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (rng_state >> 8) / 16777216.0f;
+}
+
+void bench_start(const BenchConfig* c) {
+    config = *c;
+    if (config.sprites < 0) config.sprites = BENCH_DEFAULT_SPRITES;
+    if (config.labels < 0) config.labels = BENCH_DEFAULT_LABELS;
+    if (config.frames <= 0) config.frames = BENCH_DEFAULT_FRAMES;
+    if (config.frames > BENCH_MAX_FRAMES) config.frames = BENCH_MAX_FRAMES;
+    
+    active = 1;
+    frame_index = 0;
+    memset(current_phase, 0, sizeof(current_phase));
+    memset(phase_used, 0, sizeof(phase_used));
+    printf("Benchmark: %d sprites, %d labels, %d frames, seed %u\n",
+           config.sprites, config.labels, config.frames, config.seed);
+}
+
+int bench_active(void) {
+    return active;
+}
+
+const BenchConfig* bench_config(void) {
+    return &config;
+}
+
+void bench_spawn(int world_width, int world_height) {
+    rng_state = config.seed;
+    for (int i = 0; i < config.sprites; i++) {
+        float x = bench_rand() * world_width;
+        float y = bench_rand() * world_height;
+        float angle = bench_rand() * 6.2831853f;
+        float speed = 50.0f + bench_rand() * 150.0f;
+        if (game_spawn_entity(x, y, angle, speed) < 0) break;
+    }
+}
+
+void bench_phase(BenchPhase phase, double ms) {
+    if (!active) return;
+    current_phase[phase] += ms;
+    phase_used[phase] = 1;
+}
+
+int bench_end_frame(double frame_ms) {
+    if (!active) return 0;
+    
+    int sample = frame_index++ - BENCH_WARMUP_FRAMES;
+    if (sample >= 0) {
+        double cpu = 0.0;
+        for (int p = 0; p < BENCH_PHASE_COUNT; p++) {
+            phase_samples[p][sample] = (float)current_phase[p];
+            cpu += current_phase[p];
+        }
+        frame_samples[sample] = (float)frame_ms;
+        cpu_samples[sample] = (float)cpu;
+    }
+    memset(current_phase, 0, sizeof(current_phase));
+    
+    if (sample + 1 < config.frames) return 0;
+    active = 0;
+    return 1;
+}
+
+static int compare_floats(const void* a, const void* b) {
+    float x = *(const float*)a;
+    float y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of samples already in sorted order
+static float percentile(const float* values, int count, double p) {
+    int rank = (int)(p / 100.0 * count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return values[rank - 1];
+}
+
+// {"mean":..,"p50":..,"p95":..,"p99":..,"max":..}
+static void print_stats(const float* samples, int count) {
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) sum += samples[i];
+    memcpy(sorted, samples, count * sizeof(float));
+    qsort(sorted, count, sizeof(float), compare_floats);
+    printf("{\"mean\":%.4f,\"p50\":%.4f,\"p95\":%.4f,\"p99\":%.4f,\"max\":%.4f}",
+           sum / count, percentile(sorted, count, 50.0), percentile(sorted, count, 95.0),
+           percentile(sorted, count, 99.0), sorted[count - 1]);
+}
+
+void bench_print_json(const char* build) {
+    int count = frame_index - BENCH_WARMUP_FRAMES;
+    if (count > config.frames) count = config.frames;
+    if (count <= 0) {
+        printf("Benchmark: no measured frames\n");
+        return;
+    }
+    
+    printf("{\"build\":\"%s\",\"sprites\":%d,\"labels\":%d,\"frames\":%d,\"seed\":%u,\"frame_ms\":",
+           build, config.sprites, config.labels, count, config.seed);
+    print_stats(frame_samples, count);
+    printf(",\"cpu_ms\":");
+    print_stats(cpu_samples, count);
+    printf(",\"phases\":{");
+    int first = 1;
+    for (int p = 0; p < BENCH_PHASE_COUNT; p++) {
+        if (!phase_used[p]) continue;
+        printf("%s\"%s\":", first ? "" : ",", phase_names[p]);
+        print_stats(phase_samples[p], count);
+        first = 0;
+    }
+    printf("}}\n");
+}
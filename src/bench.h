@@ -0,0 +1,60 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+// Stress-scene benchmark
+//
+// Spawns a seeded field of moving sprites through game_spawn_entity (the
+// web build also labels the first of them), then times a fixed number of
+// frames after a warm-up. The frame loop reports how long each phase took;
+// at the end one JSON line is printed with frame time percentiles and CPU
+// time per phase, so runs compare across builds and machines.
+
+#define BENCH_MAX_FRAMES 10000
+#define BENCH_WARMUP_FRAMES 60
+#define BENCH_DEFAULT_SPRITES 10000
+#define BENCH_DEFAULT_LABELS 100
+#define BENCH_DEFAULT_FRAMES 600
+#define BENCH_DEFAULT_SEED 1
+
+typedef enum {
+    BENCH_PHASE_SIMULATE,  // game_update, or taking the sim thread's snapshot
+    BENCH_PHASE_SNAPSHOT,  // copying state for the renderer (native)
+    BENCH_PHASE_HUD,       // HUD update and layer recording
+    BENCH_PHASE_RECORD,    // encoding the scene and composite passes
+    BENCH_PHASE_SUBMIT,    // finishing and submitting the command buffer
+    BENCH_PHASE_COUNT
+} BenchPhase;
+
+typedef struct {
+    int sprites;
+    int labels;
+    int frames;     // measured frames, after BENCH_WARMUP_FRAMES
+    uint32_t seed;
+} BenchConfig;
+
+// Start a run. Negative counts take the defaults; frames is clamped to
+// BENCH_MAX_FRAMES.
+void bench_start(const BenchConfig* config);
+
+// Nonzero from bench_start until the last measured frame
+int bench_active(void);
+
+const BenchConfig* bench_config(void);
+
+// Spawn the configured sprites over a world of the given size, at seeded
+// positions, headings and speeds
+void bench_spawn(int world_width, int world_height);
+
+// Add ms of CPU time to a phase of the current frame
+void bench_phase(BenchPhase phase, double ms);
+
+// Close the current frame, which took frame_ms from start to start.
+// Returns nonzero when it was the last one; the run is then over.
+int bench_end_frame(double frame_ms);
+
+// Print the results as one line of JSON, tagged with the build name
+void bench_print_json(const char* build);
+
+#endif // BENCH_H
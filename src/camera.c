@@ -0,0 +1,82 @@
+#include "camera.h"
+#include "math.h"
+
+void camera_init(Camera* cam, int viewport_width, int viewport_height, float world_width, float world_height) {
+    cam->x = world_width / 2.0f;
+    cam->y = world_height / 2.0f;
+    cam->zoom = 1.0f;
+    cam->world_width = world_width;
+    cam->world_height = world_height;
+    camera_set_viewport(cam, viewport_width, viewport_height);
+}
+
+void camera_set_viewport(Camera* cam, int viewport_width, int viewport_height) {
+    cam->viewport_width = viewport_width > 0 ? viewport_width : 1;
+    cam->viewport_height = viewport_height > 0 ? viewport_height : 1;
+    camera_update(cam);
+}
+
+void camera_look_at(Camera* cam, float x, float y) {
+    // Stop at the world edge unless the world is smaller than the view
+    float half_w = cam->viewport_width / (2.0f * cam->zoom);
+    float half_h = cam->viewport_height / (2.0f * cam->zoom);
+    
+    if (cam->world_width > 2.0f * half_w) {
+        if (x < half_w) x = half_w;
+        if (x > cam->world_width - half_w) x = cam->world_width - half_w;
+    } else {
+        x = cam->world_width / 2.0f;
+    }
+    if (cam->world_height > 2.0f * half_h) {
+        if (y < half_h) y = half_h;
+        if (y > cam->world_height - half_h) y = cam->world_height - half_h;
+    } else {
+        y = cam->world_height / 2.0f;
+    }
+    
+    cam->x = x;
+    cam->y = y;
+}
+
+void camera_update(Camera* cam) {
+    float w = (float)cam->viewport_width;
+    float h = (float)cam->viewport_height;
+    
+    // view = translate(screen center) * scale(zoom) * translate(-camera)
+    float proj[16], center[16], zoom[16], offset[16], temp[16], view[16];
+    mat4_perspective(proj, w, h, CAMERA_DISTANCE, CAMERA_FAR_PLANE);
+    mat4_translate(center, w / 2.0f, h / 2.0f);
+    mat4_scale(zoom, cam->zoom, cam->zoom);
+    mat4_translate(offset, -cam->x, -cam->y);
+    
+    mat4_multiply(temp, zoom, offset);
+    mat4_multiply(view, center, temp);
+    mat4_multiply(cam->view_proj, proj, view);
+    
+    float half_w = w / (2.0f * cam->zoom);
+    float half_h = h / (2.0f * cam->zoom);
+    cam->min_x = cam->x - half_w;
+    cam->max_x = cam->x + half_w;
+    cam->min_y = cam->y - half_h;
+    cam->max_y = cam->y + half_h;
+}
+
+int camera_box_visible(const Camera* cam, float x, float y, float z, float half_w, float half_h) {
+    // The perspective divide pulls points at depth z toward the screen
+    // center by CAMERA_DISTANCE / (CAMERA_DISTANCE - z), so the visible
+    // rectangle grows by the inverse
+    float grow = z < 0.0f ? (CAMERA_DISTANCE - z) / CAMERA_DISTANCE : 1.0f;
+    float view_half_w = (cam->max_x - cam->min_x) * 0.5f * grow;
+    float view_half_h = (cam->max_y - cam->min_y) * 0.5f * grow;
+    
+    float dx = x - cam->x;
+    float dy = y - cam->y;
+    if (dx < 0.0f) dx = -dx;
+    if (dy < 0.0f) dy = -dy;
+    return dx <= view_half_w + half_w && dy <= view_half_h + half_h;
+}
+
+void camera_world_to_screen(const Camera* cam, float x, float y, float* sx, float* sy) {
+    *sx = (x - cam->x) * cam->zoom + cam->viewport_width / 2.0f;
+    *sy = (y - cam->y) * cam->zoom + cam->viewport_height / 2.0f;
+}
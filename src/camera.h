@@ -0,0 +1,45 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+// 2D scrolling camera over the world
+//
+// World units are pixels at zoom 1 with y up, the same space the simulation
+// runs in. camera_update rebuilds the world->clip matrix and the visible
+// world rectangle once per frame; everything drawn should be tested against
+// that rectangle before its vertex or instance data is built.
+
+#define CAMERA_DISTANCE 500.0f   // eye distance from the z=0 plane
+#define CAMERA_FAR_PLANE 1000.0f
+
+typedef struct {
+    float x, y;                  // world point at the center of the screen
+    float zoom;                  // screen pixels per world unit
+    int viewport_width;
+    int viewport_height;
+    float world_width;           // camera center is kept inside the world
+    float world_height;
+    
+    // Derived by camera_update
+    float view_proj[16];         // world -> clip
+    float min_x, min_y;          // world rectangle visible at z = 0
+    float max_x, max_y;
+} Camera;
+
+void camera_init(Camera* cam, int viewport_width, int viewport_height, float world_width, float world_height);
+
+void camera_set_viewport(Camera* cam, int viewport_width, int viewport_height);
+
+// Center on a world point (clamped to the world)
+void camera_look_at(Camera* cam, float x, float y);
+
+// Recompute view_proj and the visible rectangle
+void camera_update(Camera* cam);
+
+// Whether a box centered at (x, y, z) with the given half extents can be
+// on screen. Objects with z < 0 are farther away, so more of them fits.
+int camera_box_visible(const Camera* cam, float x, float y, float z, float half_w, float half_h);
+
+// World point (z = 0) to screen pixels (origin bottom-left, y up)
+void camera_world_to_screen(const Camera* cam, float x, float y, float* sx, float* sy);
+
+#endif // CAMERA_H
@@ -0,0 +1,192 @@
+#include "collide.h"
+#include <math.h>
+#include <string.h>
+
+// GCC and clang vector extensions: SSE in the native build, WebAssembly
+// SIMD in the web build (-msimd128)
+typedef float f32x4 __attribute__((vector_size(16)));
+typedef int32_t i32x4 __attribute__((vector_size(16)));
+
+#define SIGN_BIT ((int32_t)0x80000000)
+
+_Static_assert(COLLIDE_BATCH * sizeof(float) == sizeof(f32x4), "one batch per vector");
+
+// One batch of boxes, a field per vector
+typedef struct {
+    f32x4 x, y, half_w, half_h, cos_a, sin_a;
+} BoxLanes;
+
+static inline f32x4 v_abs(f32x4 v) {
+    return (f32x4)((i32x4)v & ~SIGN_BIT);
+}
+
+// v with the sign of s
+static inline f32x4 v_copysign(f32x4 v, f32x4 s) {
+    return (f32x4)(((i32x4)v & ~SIGN_BIT) | ((i32x4)s & SIGN_BIT));
+}
+
+// Lanes of a where mask is set, of b elsewhere
+static inline f32x4 v_select(i32x4 mask, f32x4 a, f32x4 b) {
+    return (f32x4)((mask & (i32x4)a) | (~mask & (i32x4)b));
+}
+
+int box_set_init(BoxSet* set, Arena* arena, int capacity) {
+    memset(set, 0, sizeof(*set));
+    float** fields[] = {&set->x, &set->y, &set->half_w, &set->half_h, &set->cos_a, &set->sin_a};
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        *fields[i] = (float*)arena_alloc(arena, (size_t)capacity * sizeof(float));
+        if (!*fields[i]) return 1;
+    }
+    set->capacity = capacity;
+    return 0;
+}
+
+void box_set_from_sprites(BoxSet* set, const Sprite* sprites, int count, float half_w, float half_h) {
+    if (count > set->capacity) count = set->capacity;
+    for (int i = 0; i < count; i++) {
+        set->x[i] = sprites[i].x;
+        set->y[i] = sprites[i].y;
+        set->half_w[i] = half_w;
+        set->half_h[i] = half_h;
+        set->cos_a[i] = cosf(sprites[i].angle);
+        set->sin_a[i] = sinf(sprites[i].angle);
+    }
+    set->count = count;
+}
+
+static inline void gather(const BoxSet* set, const uint32_t index[COLLIDE_BATCH], BoxLanes* out) {
+    for (int k = 0; k < COLLIDE_BATCH; k++) {
+        uint32_t i = index[k];
+        out->x[k] = set->x[i];
+        out->y[k] = set->y[i];
+        out->half_w[k] = set->half_w[i];
+        out->half_h[k] = set->half_h[i];
+        out->cos_a[k] = set->cos_a[i];
+        out->sin_a[k] = set->sin_a[i];
+    }
+}
+
+// Box axes, turned by -angle like the sprite quads: x = (cos, -sin) and
+// y = (sin, cos). Axes are tested in the order A.x, A.y, B.x, B.y and a
+// later axis only wins with strictly less overlap, in both versions.
+int collide_obb_pairs(const BoxSet* set, const CollidePair* pairs, int pair_count, Contact* out) {
+    int written = 0;
+    for (int base = 0; base < pair_count; base += COLLIDE_BATCH) {
+        // A short last batch repeats its final pair in the unused lanes
+        int lanes = pair_count - base < COLLIDE_BATCH ? pair_count - base : COLLIDE_BATCH;
+        uint32_t ia[COLLIDE_BATCH], ib[COLLIDE_BATCH];
+        for (int k = 0; k < COLLIDE_BATCH; k++) {
+            const CollidePair* p = &pairs[base + (k < lanes ? k : lanes - 1)];
+            ia[k] = p->a;
+            ib[k] = p->b;
+        }
+        BoxLanes a, b;
+        gather(set, ia, &a);
+        gather(set, ib, &b);
+        
+        // Center offset along each axis, and how much the boxes' shadows on
+        // it overlap. |cos| and |sin| of the angle between the boxes give
+        // each box's extent along the other's axes.
+        f32x4 dx = b.x - a.x, dy = b.y - a.y;
+        f32x4 c = v_abs(a.cos_a * b.cos_a + a.sin_a * b.sin_a);
+        f32x4 s = v_abs(a.cos_a * b.sin_a - a.sin_a * b.cos_a);
+        f32x4 d1 = dx * a.cos_a - dy * a.sin_a;
+        f32x4 d2 = dx * a.sin_a + dy * a.cos_a;
+        f32x4 d3 = dx * b.cos_a - dy * b.sin_a;
+        f32x4 d4 = dx * b.sin_a + dy * b.cos_a;
+        f32x4 o1 = a.half_w + b.half_w * c + b.half_h * s - v_abs(d1);
+        f32x4 o2 = a.half_h + b.half_w * s + b.half_h * c - v_abs(d2);
+        f32x4 o3 = b.half_w + a.half_w * c + a.half_h * s - v_abs(d3);
+        f32x4 o4 = b.half_h + a.half_w * s + a.half_h * c - v_abs(d4);
+        
+        // Least overlap wins
+        f32x4 depth = o1, nx = a.cos_a, ny = -a.sin_a, d = d1;
+        i32x4 m = o2 < depth;
+        depth = v_select(m, o2, depth);
+        nx = v_select(m, a.sin_a, nx);
+        ny = v_select(m, a.cos_a, ny);
+        d = v_select(m, d2, d);
+        m = o3 < depth;
+        depth = v_select(m, o3, depth);
+        nx = v_select(m, b.cos_a, nx);
+        ny = v_select(m, -b.sin_a, ny);
+        d = v_select(m, d3, d);
+        m = o4 < depth;
+        depth = v_select(m, o4, depth);
+        nx = v_select(m, b.sin_a, nx);
+        ny = v_select(m, b.cos_a, ny);
+        d = v_select(m, d4, d);
+        
+        // Point the normal from a to b, then find b's corner furthest
+        // against it
+        nx = (f32x4)((i32x4)nx ^ ((i32x4)d & SIGN_BIT));
+        ny = (f32x4)((i32x4)ny ^ ((i32x4)d & SIGN_BIT));
+        f32x4 hx = v_copysign(b.half_w, b.cos_a * nx - b.sin_a * ny);
+        f32x4 hy = v_copysign(b.half_h, b.sin_a * nx + b.cos_a * ny);
+        f32x4 px = b.x - hx * b.cos_a - hy * b.sin_a;
+        f32x4 py = b.y + hx * b.sin_a - hy * b.cos_a;
+        
+        i32x4 hit = depth > (f32x4){0.0f, 0.0f, 0.0f, 0.0f};
+        for (int k = 0; k < lanes; k++) {
+            if (!hit[k]) continue;
+            Contact* contact = &out[written++];
+            contact->a = ia[k];
+            contact->b = ib[k];
+            contact->normal[0] = nx[k];
+            contact->normal[1] = ny[k];
+            contact->depth = depth[k];
+            contact->point[0] = px[k];
+            contact->point[1] = py[k];
+        }
+    }
+    return written;
+}
+
+int collide_obb_pairs_scalar(const BoxSet* set, const CollidePair* pairs, int pair_count, Contact* out) {
+    int written = 0;
+    for (int p = 0; p < pair_count; p++) {
+        uint32_t ia = pairs[p].a, ib = pairs[p].b;
+        float ax = set->x[ia], ay = set->y[ia], aw = set->half_w[ia], ah = set->half_h[ia];
+        float ac = set->cos_a[ia], as = set->sin_a[ia];
+        float bx = set->x[ib], by = set->y[ib], bw = set->half_w[ib], bh = set->half_h[ib];
+        float bc = set->cos_a[ib], bs = set->sin_a[ib];
+        
+        float dx = bx - ax, dy = by - ay;
+        float c = fabsf(ac * bc + as * bs);
+        float s = fabsf(ac * bs - as * bc);
+        
+        // Axes in order, stopping at the first that separates the boxes
+        float axes[4][2] = {{ac, -as}, {as, ac}, {bc, -bs}, {bs, bc}};
+        float d[4] = {dx * ac - dy * as, dx * as + dy * ac, dx * bc - dy * bs, dx * bs + dy * bc};
+        float extent[4] = {aw + bw * c + bh * s, ah + bw * s + bh * c, bw + aw * c + ah * s, bh + aw * s + ah * c};
+        int best = -1;
+        float depth = 0.0f;
+        for (int i = 0; i < 4; i++) {
+            float overlap = extent[i] - fabsf(d[i]);
+            if (overlap <= 0.0f) {
+                best = -1;
+                break;
+            }
+            if (best < 0 || overlap < depth) {
+                best = i;
+                depth = overlap;
+            }
+        }
+        if (best < 0) continue;
+        
+        float nx = signbit(d[best]) ? -axes[best][0] : axes[best][0];
+        float ny = signbit(d[best]) ? -axes[best][1] : axes[best][1];
+        float hx = copysignf(bw, bc * nx - bs * ny);
+        float hy = copysignf(bh, bs * nx + bc * ny);
+        
+        Contact* contact = &out[written++];
+        contact->a = ia;
+        contact->b = ib;
+        contact->normal[0] = nx;
+        contact->normal[1] = ny;
+        contact->depth = depth;
+        contact->point[0] = bx - hx * bc - hy * bs;
+        contact->point[1] = by + hx * bs - hy * bc;
+    }
+    return written;
+}
@@ -0,0 +1,58 @@
+#ifndef COLLIDE_H
+#define COLLIDE_H
+
+#include <stdint.h>
+#include "arena.h"
+#include "game.h"
+
+// Rotated-box narrowphase
+//
+// Sprites turn freely, so their boxes are oriented (OBBs). Given a list of
+// candidate pairs from a broadphase, collide_obb_pairs runs a separating
+// axis test on each pair (both boxes' two axes) and writes a contact for
+// every pair that overlaps: the axis of least overlap as the normal, the
+// overlap as the depth, and the deepest corner of the second box as the
+// point. Boxes are stored as parallel arrays, and pairs are tested
+// COLLIDE_BATCH at a time: each batch's boxes are gathered into vectors and
+// every lane takes the same branch-free path. collide_obb_pairs_scalar is
+// the same test one pair at a time, returning at the first separating axis.
+
+#define COLLIDE_BATCH 4  // pairs per SIMD batch (128-bit vectors)
+
+typedef struct {
+    float* x;       // center
+    float* y;
+    float* half_w;
+    float* half_h;
+    float* cos_a;   // of Sprite.angle
+    float* sin_a;
+    int count;
+    int capacity;
+} BoxSet;
+
+typedef struct {
+    uint32_t a;
+    uint32_t b;
+} CollidePair;
+
+typedef struct {
+    uint32_t a;
+    uint32_t b;
+    float normal[2];  // unit, pointing from a towards b
+    float depth;      // distance to move b along normal to separate the boxes
+    float point[2];   // corner of b deepest inside a
+} Contact;
+
+// Allocate room for capacity boxes from arena. Returns 0 on success.
+int box_set_init(BoxSet* set, Arena* arena, int capacity);
+
+// Fill the set with one half_w x half_h box per sprite, turned like it
+void box_set_from_sprites(BoxSet* set, const Sprite* sprites, int count, float half_w, float half_h);
+
+// Test pairs (indices into set) and write a contact per overlapping pair to
+// out, which must hold pair_count contacts. Returns the number written, in
+// pair order.
+int collide_obb_pairs(const BoxSet* set, const CollidePair* pairs, int pair_count, Contact* out);
+int collide_obb_pairs_scalar(const BoxSet* set, const CollidePair* pairs, int pair_count, Contact* out);
+
+#endif // COLLIDE_H
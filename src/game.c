@@ -1,94 +1,705 @@
 #include "game.h"
-#include "text.h"
+#include "input.h"
+#include "jobs.h"
 #include "math.h"
-#include <emscripten.h>
+#include "platform.h"
+#include "replay.h"
+#include "sched.h"
+#ifndef GAME_HEADLESS
+#include "anim.h"
+#include "arena.h"
+#include "lighting.h"
+#include "sprite_batch.h"
+#include "text.h"
+#endif
 #include <math.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdio.h>
 
-// Global game state
-static Sprite sprite;
-static InputState input;
+// All simulation state lives in this one pointer-free block, so saving or
+// restoring a frame is a memcpy of its live prefix (see game_state_size).
+// Entities go last so unused pool slots never need copying.
+typedef struct {
+    Sprite sprite;
+    InputState input;      // held keys, as seen by the simulation
+    int paused;            // toggled by P; nothing moves while set
+    uint64_t tick_count;
+    double sim_time;
+    double play_time;      // sim_time spent unpaused
+    int entity_count;
+    Sprite entities[MAX_ENTITIES];
+} GameState;
+
+static GameState state;
+
+// Input plumbing (not part of the saved state)
+static InputQueue input_queue;       // pending key events from the main thread
+static double input_clock_ms = 0.0;  // wall-clock time the sim has consumed input up to
+
+// Steps that changed something the renderer draws (not part of the saved
+// state; it only tells the renderer when a frame would look the same)
+static uint64_t change_count = 0;
+
+// Entity AI: entities near the player turn away from it. Thinking is
+// time-sliced (see sched.h): a fixed budget of entities think each tick
+// and the rest wait their turn, however many entities there are.
+#define AI_SENSE_RADIUS 400.0f
+#define AI_TURN_SPEED 2.0f         // radians per second
+#define AI_THINK_BUDGET_MS 0.25
+#define AI_THINK_COST_US 0.025     // per entity, measured natively
+static int ai_system = -1;
+static int time_slicing = 1;
+
+// Entity movement is a time-sliced system too, so the whole entity update
+// stays within its budgets however many entities spawn. Up to
+// MOVE_BUDGET_MS / MOVE_COST_US entities every entity moves every round
+// of one tick; past that a round spans several ticks and each entity moves
+// a round's distance when its slice comes up.
+#define MOVE_BUDGET_MS 0.5
+#define MOVE_COST_US 0.025         // per entity with update LOD, measured natively on one worker
+static int move_system = -1;
+
+// Update LOD: entities far from the player (off screen at any zoom the
+// camera allows) move every LOD_MID_INTERVAL or LOD_FAR_INTERVAL rounds, a
+// whole interval's distance at a time. Entities are staggered by index so
+// each round moves an even share. The intervals divide each other, so the
+// rounds an entity skips are made up exactly unless it changes band.
+#define LOD_NEAR_RADIUS 1024.0f
+#define LOD_FAR_RADIUS 2048.0f
+#define LOD_MID_INTERVAL 2
+#define LOD_FAR_INTERVAL 4
+
+static void move_entities(void* user, int begin, int end, float elapsed);
+static void think_entities(void* user, int begin, int end, float elapsed);
 
-void game_init(int canvas_width, int canvas_height) {
-    // Initialize sprite at center of canvas
-    sprite.x = canvas_width / 2.0f;
-    sprite.y = canvas_height / 2.0f;
-    sprite.z = 0.0f;  // At camera plane (z=0), negative moves away from camera
-    sprite.angle = 0.0f;
-    sprite.speed = 0.0f;
+void game_init(int world_width, int world_height) {
+    // Initialize sprite at center of the world
+    state.sprite.x = world_width / 2.0f;
+    state.sprite.y = world_height / 2.0f;
+    state.sprite.z = 0.0f;  // At camera plane (z=0), negative moves away from camera
+    state.sprite.angle = 0.0f;
+    state.sprite.speed = 0.0f;
     
     // Initialize input
-    memset(&input, 0, sizeof(input));
+    memset(&state.input, 0, sizeof(state.input));
+    input_queue_reset(&input_queue);
+    input_clock_ms = platform_now_ms();
+    
+    state.paused = 0;
+    state.entity_count = 0;
+    state.tick_count = 0;
+    state.sim_time = 0.0;
+    state.play_time = 0.0;
+    
+    replay_record_init(world_width, world_height);
+    
+    if (move_system < 0) {
+        SchedSystemDesc move = {
+            .name = "entity movement",
+            .priority = 0,
+            .budget_ms = MOVE_BUDGET_MS,
+            .item_cost_us = MOVE_COST_US,
+            .mode = SCHED_FIXED,
+            .update = move_entities,
+        };
+        move_system = sched_register(&move);
+    }
+    if (ai_system < 0) {
+        SchedSystemDesc ai = {
+            .name = "entity AI",
+            .priority = 0,
+            .budget_ms = AI_THINK_BUDGET_MS,
+            .item_cost_us = AI_THINK_COST_US,
+            .mode = SCHED_FIXED,  // changes simulation state, so must not depend on timing
+            .update = think_entities,
+        };
+        ai_system = sched_register(&ai);
+    }
     
     printf("Game initialized\n");
 }
 
-void game_update(float dt, int canvas_width, int canvas_height) {
+// Parameters shared by all entity update jobs for one tick
+typedef struct {
+    float dt;
+    float max_x;
+    float max_y;
+    float player_x;  // center of the update LOD bands
+    float player_y;
+    uint64_t tick;
+    int first;       // entity of job index 0 (start of the movement slice)
+    float elapsed;   // time since the slice last moved (one round)
+    uint64_t round;  // rounds completed, for the LOD stagger
+} EntityUpdateParams;
+
+static EntityUpdateParams move_params;
+
+// Wrap a position around the playfield edges (with a sprite-sized margin)
+static void wrap_position(Sprite* s, float max_x, float max_y) {
+    if (s->x < -SPRITE_SIZE) s->x = max_x + SPRITE_SIZE;
+    if (s->x > max_x + SPRITE_SIZE) s->x = -SPRITE_SIZE;
+    if (s->y < -SPRITE_SIZE) s->y = max_y + SPRITE_SIZE;
+    if (s->y > max_y + SPRITE_SIZE) s->y = -SPRITE_SIZE;
+}
+
+// Job body: advance the slice's entities [first + begin, first + end) that
+// are due this round
+static void update_entities(void* arg, int begin, int end) {
+    const EntityUpdateParams* p = (const EntityUpdateParams*)arg;
+    for (int i = p->first + begin; i < p->first + end; i++) {
+        Sprite* e = &state.entities[i];
+        float dx = e->x - p->player_x, dy = e->y - p->player_y;
+        float d2 = dx * dx + dy * dy;
+        int interval = !time_slicing || d2 < LOD_NEAR_RADIUS * LOD_NEAR_RADIUS ? 1
+                     : d2 < LOD_FAR_RADIUS * LOD_FAR_RADIUS ? LOD_MID_INTERVAL : LOD_FAR_INTERVAL;
+        if ((p->round + (uint64_t)i) % interval != 0) continue;
+        
+        float move = e->speed * p->elapsed * interval;
+        e->x += sinf(e->angle) * move;
+        e->y += cosf(e->angle) * move;
+        wrap_position(e, p->max_x, p->max_y);
+    }
+}
+
+// Scheduler slice: move entities [begin, end), spread over all workers since
+// entities are independent of each other
+static void move_entities(void* user, int begin, int end, float elapsed) {
+    (void)user;
+    uint64_t round_ticks = (uint64_t)(elapsed / move_params.dt + 0.5f);
+    move_params.first = begin;
+    move_params.elapsed = elapsed;
+    move_params.round = move_params.tick / (round_ticks > 0 ? round_ticks : 1);
+    job_parallel_for(end - begin, ENTITY_UPDATE_GRAIN, update_entities, &move_params);
+}
+
+// Scheduler slice: turn entities near the player away from it, by at most
+// AI_TURN_SPEED for each second since they last thought
+static void think_entities(void* user, int begin, int end, float elapsed) {
+    (void)user;
+    float max_turn = AI_TURN_SPEED * elapsed;
+    for (int i = begin; i < end; i++) {
+        Sprite* e = &state.entities[i];
+        float dx = e->x - state.sprite.x, dy = e->y - state.sprite.y;
+        if (dx * dx + dy * dy >= AI_SENSE_RADIUS * AI_SENSE_RADIUS) continue;
+        
+        // Angle 0 points up (+y), as for the player
+        float turn = remainderf(atan2f(dx, dy) - e->angle, 2.0f * PI);
+        if (turn > max_turn) turn = max_turn;
+        if (turn < -max_turn) turn = -max_turn;
+        e->angle += turn;
+    }
+}
+
+// Apply a key event to the held-key state
+static void apply_input_event(const InputEvent* ev) {
+    switch (ev->key_code) {
+        case 38: state.input.up = ev->pressed; break;    // Up arrow
+        case 40: state.input.down = ev->pressed; break;  // Down arrow
+        case 37: state.input.left = ev->pressed; break;  // Left arrow
+        case 39: state.input.right = ev->pressed; break; // Right arrow
+        case 80: if (ev->pressed) state.paused = !state.paused; break;  // P
+    }
+}
+
+// Integrate player movement for dt seconds with the current held keys
+static void update_player(float dt) {
+    if (dt <= 0.0f || state.paused) return;
+    
     // Rotate left/right
-    if (input.left) {
-        sprite.angle -= ROTATE_SPEED * dt;
+    if (state.input.left) {
+        state.sprite.angle -= ROTATE_SPEED * dt;
     }
-    if (input.right) {
-        sprite.angle += ROTATE_SPEED * dt;
+    if (state.input.right) {
+        state.sprite.angle += ROTATE_SPEED * dt;
     }
     
     // Keep angle in [0, 2*PI]
-    while (sprite.angle < 0) sprite.angle += 2 * PI;
-    while (sprite.angle >= 2 * PI) sprite.angle -= 2 * PI;
+    while (state.sprite.angle < 0) state.sprite.angle += 2 * PI;
+    while (state.sprite.angle >= 2 * PI) state.sprite.angle -= 2 * PI;
     
     // Move forward/backward based on angle
     float move = 0.0f;
-    if (input.up) move += MOVE_SPEED * dt;
-    if (input.down) move -= MOVE_SPEED * dt;
+    if (state.input.up) move += MOVE_SPEED * dt;
+    if (state.input.down) move -= MOVE_SPEED * dt;
     
     if (move != 0.0f) {
         // Move in the direction the sprite is facing (angle 0 = up)
-        sprite.x += sinf(sprite.angle) * move;
-        sprite.y += cosf(sprite.angle) * move;
+        state.sprite.x += sinf(state.sprite.angle) * move;
+        state.sprite.y += cosf(state.sprite.angle) * move;
+    }
+}
+
+void game_set_input_clock(double time_ms) {
+    input_clock_ms = time_ms;
+}
+
+void game_update(float dt, int world_width, int world_height) {
+    replay_record_step(state.tick_count, dt, world_width, world_height);
+    
+    Sprite player_before = state.sprite;
+    int paused_before = state.paused;
+    
+    // Split the step at each queued input event so presses and releases take
+    // effect when they happened, and a tap shorter than a step still moves.
+    // Offsets are quantized to microseconds so a replay, which has a
+    // different wall clock, integrates exactly the same segments.
+    double step_end = input_clock_ms + dt * 1000.0;
+    uint32_t step_us = (uint32_t)(dt * 1000000.0 + 0.5);
+    uint32_t done_us = 0;
+    InputEvent ev;
+    
+    while (input_queue_peek(&input_queue, &ev) && ev.time_ms <= step_end) {
+        double offset_ms = ev.time_ms - input_clock_ms;
+        uint32_t offset_us = offset_ms > 0.0 ? (uint32_t)(offset_ms * 1000.0 + 0.5) : 0;
+        if (offset_us > step_us) offset_us = step_us;
+        if (offset_us < done_us) offset_us = done_us;
+        
+        update_player((offset_us - done_us) / 1000000.0f);
+        done_us = offset_us;
+        
+        replay_record_event(state.tick_count, ev.key_code, ev.pressed, offset_us);
+        apply_input_event(&ev);
+        input_queue_pop(&input_queue);
     }
+    update_player((step_us - done_us) / 1000000.0f);
+    input_clock_ms = step_end;
+    
+    // Keep sprite in the world with wrapping
+    wrap_position(&state.sprite, (float)world_width, (float)world_height);
     
-    // Keep sprite on screen with wrapping
-    if (sprite.x < -SPRITE_SIZE) sprite.x = canvas_width + SPRITE_SIZE;
-    if (sprite.x > canvas_width + SPRITE_SIZE) sprite.x = -SPRITE_SIZE;
-    if (sprite.y < -SPRITE_SIZE) sprite.y = canvas_height + SPRITE_SIZE;
-    if (sprite.y > canvas_height + SPRITE_SIZE) sprite.y = -SPRITE_SIZE;
+    // This tick's share of the entities moves, then this tick's share thinks
+    int entities_moved = !state.paused && state.entity_count > 0;
+    if (entities_moved) {
+        move_params = (EntityUpdateParams){
+            .dt = dt,
+            .max_x = (float)world_width,
+            .max_y = (float)world_height,
+            .player_x = state.sprite.x,
+            .player_y = state.sprite.y,
+            .tick = state.tick_count,
+        };
+        sched_set_items(move_system, time_slicing ? state.entity_count : 0);
+        sched_set_items(ai_system, time_slicing ? state.entity_count : 0);
+        if (!time_slicing) {
+            move_entities(NULL, 0, state.entity_count, dt);
+            think_entities(NULL, 0, state.entity_count, dt);
+        }
+        sched_run(state.tick_count, dt);
+    }
+    
+    if (entities_moved || state.paused != paused_before ||
+        memcmp(&player_before, &state.sprite, sizeof(Sprite)) != 0) {
+        change_count++;
+    }
+    
+    replay_record_step_end(state.tick_count);
+    state.tick_count++;
+    state.sim_time += dt;
+    if (!state.paused) state.play_time += dt;
 }
 
 const Sprite* game_get_sprite(void) {
-    return &sprite;
+    return &state.sprite;
+}
+
+int game_spawn_entity(float x, float y, float angle, float speed) {
+    if (state.entity_count >= MAX_ENTITIES) return -1;
+    
+    replay_record_spawn(state.tick_count, x, y, angle, speed);
+    
+    Sprite* e = &state.entities[state.entity_count];
+    e->x = x;
+    e->y = y;
+    e->z = 0.0f;
+    e->angle = angle;
+    e->speed = speed;
+    return state.entity_count++;
+}
+
+void game_clear_entities(void) {
+    state.entity_count = 0;
+}
+
+void game_set_time_slicing(int enabled) {
+    time_slicing = enabled != 0;
+}
+
+const Sprite* game_get_entities(void) {
+    return state.entities;
+}
+
+int game_entity_count(void) {
+    return state.entity_count;
+}
+
+uint64_t game_tick(void) {
+    return state.tick_count;
+}
+
+double game_play_time(void) {
+    return state.play_time;
+}
+
+uint64_t game_change_count(void) {
+    return change_count;
+}
+
+size_t game_state_size(void) {
+    return offsetof(GameState, entities) + (size_t)state.entity_count * sizeof(Sprite);
+}
+
+size_t game_state_capacity(void) {
+    return sizeof(GameState);
+}
+
+const void* game_state_data(void) {
+    return &state;
+}
+
+void game_state_restore(const void* data, size_t size) {
+    if (size > sizeof(GameState)) size = sizeof(GameState);
+    memcpy(&state, data, size);
+}
+
+// FNV-1a over a block of memory
+static uint64_t hash_bytes(uint64_t h, const void* data, size_t size) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+uint64_t game_state_hash(void) {
+    uint64_t h = 14695981039346656037ull;
+    h = hash_bytes(h, &state.sprite, sizeof(state.sprite));
+    h = hash_bytes(h, &state.input, sizeof(state.input));
+    h = hash_bytes(h, &state.paused, sizeof(state.paused));
+    h = hash_bytes(h, &state.tick_count, sizeof(state.tick_count));
+    h = hash_bytes(h, &state.entity_count, sizeof(state.entity_count));
+    h = hash_bytes(h, state.entities, state.entity_count * sizeof(Sprite));
+    return h;
+}
+
+void game_snapshot(GameSnapshot* out) {
+    out->sprite = state.sprite;
+    out->tick = state.tick_count;
+    out->sim_time = state.sim_time;
+    out->play_time = state.play_time;
+    out->changes = change_count;
+    out->entity_count = state.entity_count < MAX_SNAPSHOT_ENTITIES ? state.entity_count : MAX_SNAPSHOT_ENTITIES;
+    memcpy(out->entities, state.entities, out->entity_count * sizeof(Sprite));
+}
+
+#ifndef GAME_HEADLESS
+// Screen-space HUD, drawn into a retained layer (see main.c)
+
+// Typewriter dialogue box along the bottom of the screen
+#define DIALOGUE_CAPACITY 512
+#define DIALOGUE_CHARS_PER_SEC 30.0
+#define DIALOGUE_HOLD_SECONDS 4.0  // pause on the full text before restarting
+#define DIALOGUE_MARGIN 24.0f
+#define DIALOGUE_SCALE 0.4f
+
+static const char* dialogue_script =
+    "Welcome, traveller! Use the arrow keys to steer. The world is much "
+    "bigger than the screen, so keep exploring.\n"
+    "Text in this box wraps to its width and only the line being typed is "
+    "laid out again.";
+static TextLayout dialogue;
+static int dialogue_ready = 0;
+static int dialogue_shown = 0;      // bytes of the script revealed so far
+static double dialogue_start = 0.0;
+
+// Key help in the top-right corner; it never changes after startup
+#define HELP_CAPACITY 128
+#define HELP_WIDTH 320.0f
+#define HELP_SCALE 0.35f
+
+static const char* help_text =
+    "Up/Down: move\n"
+    "Left/Right: turn\n"
+    "P: pause\n"
+    "F8: save replay (page opened with ?record)";
+static TextLayout help;
+static int help_ready = 0;
+
+// Index labels over the first label_count entities (benchmark scenes)
+#define LABEL_SCALE 0.3f
+#define LABEL_OFFSET 40.0f  // above the entity's center, in world units
+static int label_count = 0;
+
+void game_set_label_count(int count) {
+    label_count = count > 0 ? count : 0;
+}
+
+int game_update_hud(const RenderContext* ctx) {
+    int changed = 0;
+    
+    if (!help_ready) {
+        if (text_layout_init(&help, arena_persistent(), HELP_CAPACITY, HELP_WIDTH,
+                             HELP_SCALE, TEXT_ALIGN_RIGHT)) return 0;
+        text_layout_set(&help, help_text);
+        help_ready = 1;
+        changed = 1;
+    }
+    
+    float box_width = ctx->canvas_width - 2.0f * DIALOGUE_MARGIN;
+    if (!dialogue_ready) {
+        if (text_layout_init(&dialogue, arena_persistent(), DIALOGUE_CAPACITY, box_width,
+                             DIALOGUE_SCALE, TEXT_ALIGN_LEFT)) return changed;
+        dialogue_ready = 1;
+        dialogue_start = ctx->time;
+        changed = 1;
+    }
+    text_layout_set_width(&dialogue, box_width, TEXT_ALIGN_LEFT);
+    
+    // Reveal characters with time, appending only the new ones
+    int length = (int)strlen(dialogue_script);
+    double elapsed = ctx->time - dialogue_start;
+    if (elapsed > length / DIALOGUE_CHARS_PER_SEC + DIALOGUE_HOLD_SECONDS) {
+        text_layout_set(&dialogue, "");
+        dialogue_shown = 0;
+        dialogue_start = ctx->time;
+        elapsed = 0.0;
+        changed = 1;
+    }
+    int target = (int)(elapsed * DIALOGUE_CHARS_PER_SEC);
+    if (target > length) target = length;
+    if (target > dialogue_shown) {
+        text_layout_append(&dialogue, dialogue_script + dialogue_shown, target - dialogue_shown);
+        dialogue_shown = target;
+        changed = 1;
+    }
+    return changed;
+}
+
+void game_release_hud(void) {
+    if (help_ready) text_layout_release(&help);
+    if (dialogue_ready) text_layout_release(&dialogue);
+}
+
+void game_render_hud(const RenderContext* ctx) {
+    if (!text_is_ready()) return;
+    
+    if (help_ready) {
+        float left = ctx->canvas_width - DIALOGUE_MARGIN - HELP_WIDTH;
+        render_text_layout(ctx->pass, &help, left, ctx->canvas_height - DIALOGUE_MARGIN, 0.7f, 0.8f, 0.9f);
+    }
+    if (dialogue_ready) {
+        float top = DIALOGUE_MARGIN + 3.0f * text_line_height(DIALOGUE_SCALE);
+        render_text_layout(ctx->pass, &dialogue, DIALOGUE_MARGIN, top, 1.0f, 0.95f, 0.8f);
+    }
+}
+
+// Point lights: a dim ambient, a warm light carried by the player and a
+// colored one on every LIGHT_ENTITY_STRIDE-th entity
+#define LIGHT_AMBIENT 0.45f
+#define LIGHT_ENTITY_STRIDE 16
+#define LIGHT_RADIUS 180.0f
+#define PLAYER_LIGHT_RADIUS 320.0f
+static const float light_colors[4][3] = {
+    {1.0f, 0.6f, 0.25f},  // torch
+    {0.3f, 0.7f, 1.0f},
+    {0.9f, 0.35f, 0.9f},
+    {0.4f, 1.0f, 0.5f},
+};
+
+// Entity animation. The atlas holds one image per sprite rather than frame
+// strips, so clips step through whole atlas images by name; clips naming an
+// image the atlas lacks are left out.
+#define ENTITY_CLIP_FRAMES 4
+#define ENTITY_CLIP_PHASE 4.0f   // seconds of start offset spread over entities
+#define ENTITY_CLIP_RATE 0.8f    // slowest playback rate
+#define ENTITY_CLIP_SPREAD 0.4f  // rates fall in [RATE, RATE + SPREAD)
+typedef struct {
+    const char* images[ENTITY_CLIP_FRAMES];
+    float durations[ENTITY_CLIP_FRAMES];
+    int frame_count;
+    AnimLoopMode mode;
+} EntityClip;
+
+static const EntityClip entity_clips[] = {
+    {{"gem", "ball"}, {0.3f, 0.3f}, 2, ANIM_LOOP},
+    {{"crate", "spike", "ball"}, {0.25f, 0.1f, 0.25f}, 3, ANIM_PING_PONG},
+    {{"ball", "crate", "gem", "spike"}, {0.15f, 0.15f, 0.15f, 0.4f}, 4, ANIM_LOOP},
+    {{"spike", "gem"}, {0.5f, 0.2f}, 2, ANIM_PING_PONG},
+};
+#define ENTITY_CLIP_COUNT (int)(sizeof(entity_clips) / sizeof(entity_clips[0]))
+
+static int anim_ready = 0;
+static int animated_count = 0;     // entities whose player has been started
+static double anim_time = -1.0;    // ctx->play_time of the last advance
+
+_Static_assert(ANIM_MAX_PLAYERS >= MAX_ENTITIES, "every entity needs an animation player");
+
+// Bake entity_clips against the loaded atlas, falling back to one still
+// clip per atlas image. Returns 1 once clips are baked.
+static int bake_entity_clips(void) {
+    int image_count = sprite_atlas_image_count();
+    if (image_count <= 0) return 0;
+    
+    static const float still_duration = 1.0f;
+    uint16_t images[ANIM_MAX_CLIPS][ENTITY_CLIP_FRAMES];
+    AnimClipDef defs[ANIM_MAX_CLIPS];
+    int count = 0;
+    for (int c = 0; c < ENTITY_CLIP_COUNT; c++) {
+        const EntityClip* clip = &entity_clips[c];
+        int found = 1;
+        for (int f = 0; f < clip->frame_count; f++) {
+            int image = sprite_atlas_find(clip->images[f]);
+            if (image < 0) found = 0;
+            images[count][f] = (uint16_t)(image < 0 ? 0 : image);
+        }
+        if (!found) continue;
+        defs[count] = (AnimClipDef){images[count], clip->durations, clip->frame_count, clip->mode};
+        count++;
+    }
+    if (count == 0) {
+        for (; count < image_count && count < ANIM_MAX_CLIPS; count++) {
+            images[count][0] = (uint16_t)count;
+            defs[count] = (AnimClipDef){images[count], &still_duration, 1, ANIM_LOOP};
+        }
+    }
+    if (anim_bake(defs, count)) return 0;
+    
+    animated_count = 0;
+    return 1;
+}
+
+// Start players for entities added since the last frame and advance all of
+// them to ctx->play_time. Entities get a clip, phase and rate from their
+// index.
+static void animate_entities(const RenderContext* ctx) {
+    if (!anim_ready) anim_ready = bake_entity_clips();
+    if (!anim_ready) return;
+    
+    if (animated_count > ctx->entity_count) animated_count = ctx->entity_count;
+    int clips = anim_clip_count();
+    for (int i = animated_count; i < ctx->entity_count; i++) {
+        uint32_t h = (uint32_t)i * 2654435761u;
+        float phase = (h >> 16) / 65536.0f;
+        float rate = (h & 0xFFFF) / 65536.0f;
+        anim_play(i, i % clips, phase * ENTITY_CLIP_PHASE, ENTITY_CLIP_RATE + rate * ENTITY_CLIP_SPREAD);
+    }
+    animated_count = ctx->entity_count;
+    
+    // Clips follow simulated play, so they hold while paused and a paused
+    // frame renders identically. Play time only goes back when a saved
+    // state is restored, which does not rewind the clips.
+    float dt = anim_time < 0.0 ? 0.0f : (float)(ctx->play_time - anim_time);
+    if (dt < 0.0f) dt = 0.0f;
+    anim_time = ctx->play_time;
+    anim_advance(ctx->entity_count, dt);
+}
+
+void game_record_compute(const RenderContext* ctx, WGPUCommandEncoder encoder) {
+    animate_entities(ctx);
+    
+    // Sprite records go to the GPU as they are laid out in memory
+    _Static_assert(sizeof(Sprite) == SPRITE_CULL_RECORD_BYTES, "cull pass reads Sprite records");
+    sprite_batch_cull(encoder, ctx->entities, anim_frames(), ctx->entity_count, ctx->camera);
+    
+    // Lights whose circle misses the view are not worth binning
+    const Camera* cam = ctx->camera;
+    const Sprite* s = ctx->sprite ? ctx->sprite : &state.sprite;
+    lighting_set_ambient(LIGHT_AMBIENT, LIGHT_AMBIENT, LIGHT_AMBIENT + 0.05f);
+    lighting_add(s->x, s->y, PLAYER_LIGHT_RADIUS, 1.0f, 0.85f, 0.6f);
+    for (int i = 0; i < ctx->entity_count; i += LIGHT_ENTITY_STRIDE) {
+        const Sprite* e = &ctx->entities[i];
+        if (!camera_box_visible(cam, e->x, e->y, 0.0f, LIGHT_RADIUS, LIGHT_RADIUS)) continue;
+        const float* color = light_colors[(i / LIGHT_ENTITY_STRIDE) % 4];
+        lighting_add(e->x, e->y, LIGHT_RADIUS, color[0], color[1], color[2]);
+    }
 }
 
 void game_render(const RenderContext* ctx) {
+    const Sprite* s = ctx->sprite ? ctx->sprite : &state.sprite;
+    const Camera* cam = ctx->camera;
+    
+    // Draw visible entities as one batch, each showing its animation frame.
+    // With GPU culling the instances were built by game_record_compute's
+    // pass; otherwise culling happens here, before an instance is written,
+    // so off-screen entities cost neither upload bandwidth nor vertex work.
+    int image_count = sprite_atlas_image_count();
+    if (sprite_batch_cull_is_ready()) {
+        sprite_batch_draw_culled(ctx->pass, cam->view_proj);
+    } else if (sprite_batch_is_ready() && image_count > 0) {
+        // Rotated sprites stay inside the circle through their corners
+        float radius[MAX_ATLAS_IMAGES];
+        for (int i = 0; i < image_count; i++) {
+            const AtlasImage* img = sprite_atlas_image(i);
+            radius[i] = 0.5f * sqrtf(img->width * img->width + img->height * img->height);
+        }
+        
+        const uint16_t* frames = anim_frames();
+        for (int i = 0; i < ctx->entity_count; i++) {
+            const Sprite* e = &ctx->entities[i];
+            int image = frames[i] < image_count ? frames[i] : 0;
+            if (!camera_box_visible(cam, e->x, e->y, e->z, radius[image], radius[image])) continue;
+            sprite_batch_add_image(image, e->x, e->y, e->z, e->angle, 1.0f, 0xFFFFFFFF);
+        }
+        sprite_batch_flush(ctx->pass, cam->view_proj);
+    }
+    
+    // Entity labels, culled like the label below and drawn as one batch
+    if (text_is_ready() && label_count > 0) {
+        int count = label_count < ctx->entity_count ? label_count : ctx->entity_count;
+        float line_height = text_line_height(LABEL_SCALE);
+        for (int i = 0; i < count; i++) {
+            const Sprite* e = &ctx->entities[i];
+            char label[16];
+            snprintf(label, sizeof(label), "#%d", i);
+            
+            float width = calculate_text_width(label, LABEL_SCALE);
+            float label_y = e->y + LABEL_OFFSET;
+            if (!camera_box_visible(cam, e->x, label_y, e->z, width / 2.0f, line_height)) continue;
+            
+            float x, y;
+            camera_world_to_screen(cam, e->x, label_y, &x, &y);
+            text_label_add(label, x - width * cam->zoom / 2.0f, y, LABEL_SCALE * cam->zoom);
+        }
+        text_label_flush(ctx->pass, 1.0f, 1.0f, 0.6f);
+    }
+    
     // Draw "Hello, World!" text above the sprite
     if (text_is_ready()) {
         const char* hello_text = "Hello, World!";
         float text_scale = 0.5f;  // Scale down the font
         float text_width = calculate_text_width(hello_text, text_scale);
-        float text_x = sprite.x - text_width / 2.0f;  // Center above sprite
-        float text_y = sprite.y + SPRITE_SIZE / 2.0f + 50.0f;  // Position above sprite
+        float label_y = s->y + SPRITE_SIZE / 2.0f + 50.0f;  // Position above sprite
         
-        render_text(ctx->pass, hello_text, text_x, text_y, text_scale, 1.0f, 1.0f, 1.0f);  // White text
+        // Skip the label before any glyph quads are built (a full line
+        // height either side covers glyphs above and below the baseline)
+        float line_height = text_line_height(text_scale);
+        if (camera_box_visible(cam, s->x, label_y, 0.0f, text_width / 2.0f, line_height)) {
+            float text_x, text_y;
+            camera_world_to_screen(cam, s->x, label_y, &text_x, &text_y);
+            text_scale *= cam->zoom;
+            text_x -= text_width * cam->zoom / 2.0f;  // Center above sprite
+            
+            render_text(ctx->pass, hello_text, text_x, text_y, text_scale, 1.0f, 1.0f, 1.0f);  // White text
+        }
     }
 }
+#endif
+
+void game_push_input(int key_code, int pressed, double time_ms) {
+    InputEvent ev = {time_ms, key_code, pressed};
+    input_queue_push(&input_queue, &ev);
+}
 
 // Input handlers (called from JavaScript)
+// event_age_ms is how long ago the browser generated the event, so the
+// timestamp lands on our own clock regardless of the JS time origin
 EMSCRIPTEN_KEEPALIVE
-void on_key_down(int key_code) {
-    switch (key_code) {
-        case 38: input.up = 1; break;    // Up arrow
-        case 40: input.down = 1; break;  // Down arrow
-        case 37: input.left = 1; break;  // Left arrow
-        case 39: input.right = 1; break; // Right arrow
-    }
+void on_key_down(int key_code, double event_age_ms) {
+    game_push_input(key_code, 1, platform_now_ms() - event_age_ms);
 }
 
 EMSCRIPTEN_KEEPALIVE
-void on_key_up(int key_code) {
-    switch (key_code) {
-        case 38: input.up = 0; break;
-        case 40: input.down = 0; break;
-        case 37: input.left = 0; break;
-        case 39: input.right = 0; break;
-    }
+void on_key_up(int key_code, double event_age_ms) {
+    game_push_input(key_code, 0, platform_now_ms() - event_age_ms);
 }
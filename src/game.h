@@ -1,12 +1,23 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef GAME_HEADLESS
 #include <webgpu/webgpu.h>
+#include "camera.h"
+#endif
 
 // Game constants
 #define SPRITE_SIZE 64.0f
 #define MOVE_SPEED 200.0f
 #define ROTATE_SPEED 3.0f
+#define WORLD_WIDTH 4096   // playfield size used by the web build
+#define WORLD_HEIGHT 4096
+#define MAX_ENTITIES 131072
+#define ENTITY_UPDATE_GRAIN 1024  // Smallest entity range worth a job
+#define MAX_SNAPSHOT_ENTITIES 16384  // Entities handed to the renderer per snapshot
 
 // Sprite state
 typedef struct {
@@ -17,7 +28,7 @@ typedef struct {
     float speed;
 } Sprite;
 
-// Input state
+// Held-key state derived from the input event queue (simulation side only)
 typedef struct {
     int up;
     int down;
@@ -25,27 +36,121 @@ typedef struct {
     int right;
 } InputState;
 
+// Immutable copy of simulation state handed from the sim to the renderer
+typedef struct {
+    Sprite sprite;
+    uint64_t tick;    // number of completed simulation steps
+    double sim_time;  // simulated seconds since game_init
+    double play_time; // game_play_time() when the snapshot was taken
+    uint64_t changes; // game_change_count() when the snapshot was taken
+    int entity_count; // entities copied (capped at MAX_SNAPSHOT_ENTITIES)
+    Sprite entities[MAX_SNAPSHOT_ENTITIES];
+} GameSnapshot;
+
+#ifndef GAME_HEADLESS
 // Render context passed to game for rendering operations
 typedef struct {
     WGPURenderPassEncoder pass;
     int canvas_width;
     int canvas_height;
+    const Sprite* sprite;  // sprite state to draw (live state or a snapshot)
+    const Sprite* entities;
+    int entity_count;
+    const Camera* camera;  // world to clip transform and visible rect
+    double time;           // wall-clock seconds, for UI animation
+    double play_time;      // game_play_time() of the drawn state
 } RenderContext;
+#endif
+
+// Initialize game state (sprite position, input) for a world of the
+// given size; the sprite starts at its center
+void game_init(int world_width, int world_height);
+
+// Update game state (call each frame with delta time).
+// Consumes queued input events up to the input clock plus dt. Everything
+// wraps around the world edges.
+void game_update(float dt, int world_width, int world_height);
 
-// Initialize game state (sprite position, input)
-void game_init(int canvas_width, int canvas_height);
+// Set the wall-clock time (platform_now_ms) at which the next game_update
+// step begins. Fixed-step callers set it once; variable-step callers set it
+// each frame.
+void game_set_input_clock(double time_ms);
 
-// Update game state (call each frame with delta time)
-void game_update(float dt, int canvas_width, int canvas_height);
+// Queue a key event stamped with platform_now_ms() time (any single thread)
+void game_push_input(int key_code, int pressed, double time_ms);
+
+#ifndef GAME_HEADLESS
+// Record the compute work game_render depends on (entity culling) into
+// encoder and queue this frame's lights; call each frame before any render
+// pass begins and before lighting_cull
+void game_record_compute(const RenderContext* ctx, WGPUCommandEncoder encoder);
 
 // Render game objects (call during render pass)
 void game_render(const RenderContext* ctx);
 
+// Advance the screen-space HUD to ctx->time. Returns nonzero if its content
+// changed, i.e. the retained layer it is drawn into must be recorded again.
+int game_update_hud(const RenderContext* ctx);
+
+// Draw the HUD into ctx->pass (the HUD layer's pass, not the surface)
+void game_render_hud(const RenderContext* ctx);
+
+// Release the HUD's GPU objects (they are recreated if drawn again)
+void game_release_hud(void);
+
+// Draw an index label over each of the first count entities
+void game_set_label_count(int count);
+#endif
+
 // Get current sprite state (for rendering)
 const Sprite* game_get_sprite(void);
 
-// Input handlers (called from JavaScript)
-void on_key_down(int key_code);
-void on_key_up(int key_code);
+// Spawn an autonomous sprite that drifts in the direction it faces.
+// Returns the entity index, or -1 if the entity pool is full.
+int game_spawn_entity(float x, float y, float angle, float speed);
+
+// Remove all spawned entities
+void game_clear_entities(void);
+
+// Entities near the player steer away from it. Their thinking and movement
+// are time-sliced and entities far from the player move at a reduced rate;
+// disabling time slicing runs both for every entity every tick (for
+// comparison; on by default, and not part of the saved state)
+void game_set_time_slicing(int enabled);
+
+// Spawned entity array and its length
+const Sprite* game_get_entities(void);
+int game_entity_count(void);
+
+// Number of completed simulation steps
+uint64_t game_tick(void);
+
+// Simulated seconds spent unpaused; entity animation follows it, so it
+// stops while the game is paused
+double game_play_time(void);
+
+// Number of steps that changed anything drawn (player, entities, pause).
+// If it has not moved since the last rendered frame, the simulation would
+// render identically.
+uint64_t game_change_count(void);
+
+// Raw simulation state. It is one contiguous, pointer-free block whose live
+// prefix (game_state_size bytes, growing with entity count) fully describes
+// a frame, so it can be saved and restored with memcpy. Restore only while
+// no other thread is running game_update.
+size_t game_state_size(void);
+size_t game_state_capacity(void);
+const void* game_state_data(void);
+void game_state_restore(const void* data, size_t size);
+
+// Hash of all simulation state, for replay determinism checks
+uint64_t game_state_hash(void);
+
+// Copy the current simulation state into a snapshot
+void game_snapshot(GameSnapshot* out);
+
+// Input handlers (called from JavaScript with the event's age in ms)
+void on_key_down(int key_code, double event_age_ms);
+void on_key_up(int key_code, double event_age_ms);
 
 #endif // GAME_H
@@ -0,0 +1,209 @@
+#include "gpu_headless.h"
+#include <stdint.h>
+
+// Every object created is a distinct dummy handle and every command does
+// nothing. Handles are only compared, never dereferenced.
+static uintptr_t handle_count = 0;
+
+static void* new_handle(void) {
+    return (void*)++handle_count;
+}
+
+WGPUDevice gpu_headless_device(void) {
+    static WGPUDevice device = NULL;
+    if (!device) device = (WGPUDevice)new_handle();
+    return device;
+}
+
+WGPUQueue gpu_headless_queue(void) {
+    static WGPUQueue queue = NULL;
+    if (!queue) queue = (WGPUQueue)new_handle();
+    return queue;
+}
+
+WGPUCommandEncoder gpu_headless_encoder(void) {
+    static WGPUCommandEncoder encoder = NULL;
+    if (!encoder) encoder = (WGPUCommandEncoder)new_handle();
+    return encoder;
+}
+
+WGPUBindGroup wgpuDeviceCreateBindGroup(WGPUDevice device, const WGPUBindGroupDescriptor* descriptor) {
+    (void)device;
+    (void)descriptor;
+    return (WGPUBindGroup)new_handle();
+}
+
+WGPUBindGroupLayout wgpuDeviceCreateBindGroupLayout(WGPUDevice device, const WGPUBindGroupLayoutDescriptor* descriptor) {
+    (void)device;
+    (void)descriptor;
+    return (WGPUBindGroupLayout)new_handle();
+}
+
+WGPUBuffer wgpuDeviceCreateBuffer(WGPUDevice device, const WGPUBufferDescriptor* descriptor) {
+    (void)device;
+    (void)descriptor;
+    return (WGPUBuffer)new_handle();
+}
+
+WGPUComputePipeline wgpuDeviceCreateComputePipeline(WGPUDevice device, const WGPUComputePipelineDescriptor* descriptor) {
+    (void)device;
+    (void)descriptor;
+    return (WGPUComputePipeline)new_handle();
+}
+
+WGPUPipelineLayout wgpuDeviceCreatePipelineLayout(WGPUDevice device, const WGPUPipelineLayoutDescriptor* descriptor) {
+    (void)device;
+    (void)descriptor;
+    return (WGPUPipelineLayout)new_handle();
+}
+
+WGPURenderPipeline wgpuDeviceCreateRenderPipeline(WGPUDevice device, const WGPURenderPipelineDescriptor* descriptor) {
+    (void)device;
+    (void)descriptor;
+    return (WGPURenderPipeline)new_handle();
+}
+
+WGPUSampler wgpuDeviceCreateSampler(WGPUDevice device, const WGPUSamplerDescriptor* descriptor) {
+    (void)device;
+    (void)descriptor;
+    return (WGPUSampler)new_handle();
+}
+
+WGPUShaderModule wgpuDeviceCreateShaderModule(WGPUDevice device, const WGPUShaderModuleDescriptor* descriptor) {
+    (void)device;
+    (void)descriptor;
+    return (WGPUShaderModule)new_handle();
+}
+
+WGPUTexture wgpuDeviceCreateTexture(WGPUDevice device, const WGPUTextureDescriptor* descriptor) {
+    (void)device;
+    (void)descriptor;
+    return (WGPUTexture)new_handle();
+}
+
+WGPUTextureView wgpuTextureCreateView(WGPUTexture texture, const WGPUTextureViewDescriptor* descriptor) {
+    (void)texture;
+    (void)descriptor;
+    return (WGPUTextureView)new_handle();
+}
+
+void wgpuBindGroupRelease(WGPUBindGroup bindGroup) {
+    (void)bindGroup;
+}
+
+void wgpuBindGroupLayoutRelease(WGPUBindGroupLayout bindGroupLayout) {
+    (void)bindGroupLayout;
+}
+
+void wgpuBufferRelease(WGPUBuffer buffer) {
+    (void)buffer;
+}
+
+void wgpuComputePipelineRelease(WGPUComputePipeline computePipeline) {
+    (void)computePipeline;
+}
+
+void wgpuPipelineLayoutRelease(WGPUPipelineLayout pipelineLayout) {
+    (void)pipelineLayout;
+}
+
+void wgpuRenderPipelineRelease(WGPURenderPipeline renderPipeline) {
+    (void)renderPipeline;
+}
+
+void wgpuSamplerRelease(WGPUSampler sampler) {
+    (void)sampler;
+}
+
+void wgpuShaderModuleRelease(WGPUShaderModule shaderModule) {
+    (void)shaderModule;
+}
+
+void wgpuTextureRelease(WGPUTexture texture) {
+    (void)texture;
+}
+
+void wgpuTextureViewRelease(WGPUTextureView textureView) {
+    (void)textureView;
+}
+
+void wgpuQueueWriteBuffer(WGPUQueue queue, WGPUBuffer buffer, uint64_t bufferOffset, const void* data, size_t size) {
+    (void)queue;
+    (void)buffer;
+    (void)bufferOffset;
+    (void)data;
+    (void)size;
+}
+
+void wgpuQueueWriteTexture(WGPUQueue queue, const WGPUTexelCopyTextureInfo* destination, const void* data,
+                           size_t dataSize, const WGPUTexelCopyBufferLayout* dataLayout,
+                           const WGPUExtent3D* writeSize) {
+    (void)queue;
+    (void)destination;
+    (void)data;
+    (void)dataSize;
+    (void)dataLayout;
+    (void)writeSize;
+}
+
+WGPURenderPassEncoder wgpuCommandEncoderBeginRenderPass(WGPUCommandEncoder commandEncoder,
+                                                        const WGPURenderPassDescriptor* descriptor) {
+    (void)commandEncoder;
+    (void)descriptor;
+    return (WGPURenderPassEncoder)new_handle();
+}
+
+void wgpuRenderPassEncoderSetPipeline(WGPURenderPassEncoder renderPassEncoder, WGPURenderPipeline pipeline) {
+    (void)renderPassEncoder;
+    (void)pipeline;
+}
+
+void wgpuRenderPassEncoderSetBindGroup(WGPURenderPassEncoder renderPassEncoder, uint32_t groupIndex,
+                                       WGPUBindGroup group, size_t dynamicOffsetCount, const uint32_t* dynamicOffsets) {
+    (void)renderPassEncoder;
+    (void)groupIndex;
+    (void)group;
+    (void)dynamicOffsetCount;
+    (void)dynamicOffsets;
+}
+
+void wgpuRenderPassEncoderSetVertexBuffer(WGPURenderPassEncoder renderPassEncoder, uint32_t slot,
+                                          WGPUBuffer buffer, uint64_t offset, uint64_t size) {
+    (void)renderPassEncoder;
+    (void)slot;
+    (void)buffer;
+    (void)offset;
+    (void)size;
+}
+
+void wgpuRenderPassEncoderDraw(WGPURenderPassEncoder renderPassEncoder, uint32_t vertexCount,
+                               uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) {
+    (void)renderPassEncoder;
+    (void)vertexCount;
+    (void)instanceCount;
+    (void)firstVertex;
+    (void)firstInstance;
+}
+
+void wgpuRenderPassEncoderDrawIndirect(WGPURenderPassEncoder renderPassEncoder, WGPUBuffer indirectBuffer,
+                                       uint64_t indirectOffset) {
+    (void)renderPassEncoder;
+    (void)indirectBuffer;
+    (void)indirectOffset;
+}
+
+void wgpuRenderPassEncoderEnd(WGPURenderPassEncoder renderPassEncoder) {
+    (void)renderPassEncoder;
+}
+
+void wgpuRenderPassEncoderRelease(WGPURenderPassEncoder renderPassEncoder) {
+    (void)renderPassEncoder;
+}
+
+void wgpuComputePassEncoderDispatchWorkgroups(WGPUComputePassEncoder computePassEncoder, uint32_t workgroupCountX,
+                                              uint32_t workgroupCountY, uint32_t workgroupCountZ) {
+    (void)computePassEncoder;
+    (void)workgroupCountX;
+    (void)workgroupCountY;
+    (void)workgroupCountZ;
+}
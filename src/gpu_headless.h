@@ -0,0 +1,17 @@
+#ifndef GPU_HEADLESS_H
+#define GPU_HEADLESS_H
+
+#include <webgpu/webgpu.h>
+
+// No-GPU WebGPU backend (headless native build only)
+//
+// Implements the wgpu* calls declared in src/headless/webgpu/webgpu.h.
+// Objects are dummy handles and commands do nothing, so renderer code runs
+// natively and gpu_trace.c still counts every command it issues.
+
+// Handles standing in for the device, its queue and a command encoder
+WGPUDevice gpu_headless_device(void);
+WGPUQueue gpu_headless_queue(void);
+WGPUCommandEncoder gpu_headless_encoder(void);
+
+#endif // GPU_HEADLESS_H
@@ -0,0 +1,284 @@
+#include "gpu_resources.h"
+#include "gpu_trace.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define GPU_MAX_OWNERS 32  // distinct owners listed by gpu_report
+
+// One live object
+typedef struct {
+    void* object;
+    GpuKind kind;
+    const char* owner;
+    size_t bytes;
+} GpuResource;
+
+static const char* kind_names[GPU_KIND_COUNT] = {
+    "buffer", "texture", "texture view", "sampler", "shader module",
+    "bind group layout", "bind group", "pipeline layout", "render pipeline", "compute pipeline",
+};
+
+// Live objects are kept packed at the front of the table: a release moves
+// the last entry into the freed slot
+static GpuResource resources[GPU_MAX_RESOURCES];
+static int resource_count = 0;
+static int kind_counts[GPU_KIND_COUNT];
+static size_t kind_bytes[GPU_KIND_COUNT];
+static size_t live_bytes = 0;
+static size_t peak_bytes = 0;
+static int untracked = 0;  // objects created while the table was full
+static int budget_warned = 0;
+
+static void track(void* object, GpuKind kind, const char* owner, size_t bytes) {
+    if (!object) return;
+    gpu_trace_resource_created();
+    if (resource_count == GPU_MAX_RESOURCES) {
+        if (untracked++ == 0) printf("GPU resource table full, objects are no longer tracked\n");
+        return;
+    }
+    
+    GpuResource* r = &resources[resource_count++];
+    r->object = object;
+    r->kind = kind;
+    r->owner = owner ? owner : "?";
+    r->bytes = bytes;
+    kind_counts[kind]++;
+    kind_bytes[kind] += bytes;
+    live_bytes += bytes;
+    if (live_bytes > peak_bytes) peak_bytes = live_bytes;
+    
+    if (live_bytes > GPU_MEMORY_BUDGET && !budget_warned) {
+        budget_warned = 1;
+        printf("GPU memory over budget: %.1f of %.1f MB after %s %s\n",
+               live_bytes / (1024.0 * 1024.0), GPU_MEMORY_BUDGET / (1024.0 * 1024.0), r->owner, kind_names[kind]);
+    }
+}
+
+// Forget an object. Returns 0 if it was not tracked (released twice, or
+// created with a plain wgpu* call).
+static int untrack(void* object, GpuKind kind) {
+    for (int i = 0; i < resource_count; i++) {
+        GpuResource* r = &resources[i];
+        if (r->object != object) continue;
+        if (r->kind != kind) {
+            printf("GPU %s released as a %s (owner %s)\n", kind_names[r->kind], kind_names[kind], r->owner);
+        }
+        kind_counts[r->kind]--;
+        kind_bytes[r->kind] -= r->bytes;
+        live_bytes -= r->bytes;
+        *r = resources[--resource_count];
+        return 1;
+    }
+    return 0;
+}
+
+static void untrack_or_warn(void* object, GpuKind kind) {
+    if (!untrack(object, kind) && !untracked) {
+        printf("Releasing an untracked GPU %s\n", kind_names[kind]);
+    }
+}
+
+static uint32_t texel_bytes(WGPUTextureFormat format) {
+    switch (format) {
+        case WGPUTextureFormat_R8Unorm: return 1;
+        case WGPUTextureFormat_RG8Unorm: return 2;
+        case WGPUTextureFormat_RGBA16Float: return 8;
+        case WGPUTextureFormat_RGBA32Float: return 16;
+        default: return 4;  // RGBA8/BGRA8 and 32-bit depth formats
+    }
+}
+
+static size_t texture_bytes(const WGPUTextureDescriptor* desc) {
+    size_t total = 0;
+    uint32_t w = desc->size.width;
+    uint32_t h = desc->size.height;
+    uint32_t mips = desc->mipLevelCount ? desc->mipLevelCount : 1;
+    uint32_t samples = desc->sampleCount ? desc->sampleCount : 1;
+    for (uint32_t m = 0; m < mips; m++) {
+        total += (size_t)w * h;
+        w = w > 1 ? w / 2 : 1;
+        h = h > 1 ? h / 2 : 1;
+    }
+    return total * desc->size.depthOrArrayLayers * samples * texel_bytes(desc->format);
+}
+
+WGPUBuffer gpu_create_buffer(WGPUDevice device, const WGPUBufferDescriptor* desc, const char* owner) {
+    WGPUBuffer buffer = wgpuDeviceCreateBuffer(device, desc);
+    track(buffer, GPU_BUFFER, owner, (size_t)desc->size);
+    return buffer;
+}
+
+WGPUTexture gpu_create_texture(WGPUDevice device, const WGPUTextureDescriptor* desc, const char* owner) {
+    WGPUTexture texture = wgpuDeviceCreateTexture(device, desc);
+    track(texture, GPU_TEXTURE, owner, texture_bytes(desc));
+    return texture;
+}
+
+WGPUTextureView gpu_create_view(WGPUTexture texture, const WGPUTextureViewDescriptor* desc, const char* owner) {
+    WGPUTextureView view = wgpuTextureCreateView(texture, desc);
+    track(view, GPU_TEXTURE_VIEW, owner, 0);
+    return view;
+}
+
+WGPUSampler gpu_create_sampler(WGPUDevice device, const WGPUSamplerDescriptor* desc, const char* owner) {
+    WGPUSampler sampler = wgpuDeviceCreateSampler(device, desc);
+    track(sampler, GPU_SAMPLER, owner, 0);
+    return sampler;
+}
+
+WGPUShaderModule gpu_create_shader_module(WGPUDevice device, const WGPUShaderModuleDescriptor* desc, const char* owner) {
+    WGPUShaderModule module = wgpuDeviceCreateShaderModule(device, desc);
+    track(module, GPU_SHADER_MODULE, owner, 0);
+    return module;
+}
+
+WGPUBindGroupLayout gpu_create_bind_group_layout(WGPUDevice device, const WGPUBindGroupLayoutDescriptor* desc, const char* owner) {
+    WGPUBindGroupLayout layout = wgpuDeviceCreateBindGroupLayout(device, desc);
+    track(layout, GPU_BIND_GROUP_LAYOUT, owner, 0);
+    return layout;
+}
+
+WGPUBindGroup gpu_create_bind_group(WGPUDevice device, const WGPUBindGroupDescriptor* desc, const char* owner) {
+    WGPUBindGroup group = wgpuDeviceCreateBindGroup(device, desc);
+    track(group, GPU_BIND_GROUP, owner, 0);
+    return group;
+}
+
+WGPUPipelineLayout gpu_create_pipeline_layout(WGPUDevice device, const WGPUPipelineLayoutDescriptor* desc, const char* owner) {
+    WGPUPipelineLayout layout = wgpuDeviceCreatePipelineLayout(device, desc);
+    track(layout, GPU_PIPELINE_LAYOUT, owner, 0);
+    return layout;
+}
+
+WGPURenderPipeline gpu_create_render_pipeline(WGPUDevice device, const WGPURenderPipelineDescriptor* desc, const char* owner) {
+    WGPURenderPipeline pipeline = wgpuDeviceCreateRenderPipeline(device, desc);
+    track(pipeline, GPU_RENDER_PIPELINE, owner, 0);
+    return pipeline;
+}
+
+WGPUComputePipeline gpu_create_compute_pipeline(WGPUDevice device, const WGPUComputePipelineDescriptor* desc, const char* owner) {
+    WGPUComputePipeline pipeline = wgpuDeviceCreateComputePipeline(device, desc);
+    track(pipeline, GPU_COMPUTE_PIPELINE, owner, 0);
+    return pipeline;
+}
+
+void gpu_release_buffer(WGPUBuffer buffer) {
+    if (!buffer) return;
+    untrack_or_warn(buffer, GPU_BUFFER);
+    wgpuBufferRelease(buffer);
+}
+
+void gpu_release_texture(WGPUTexture texture) {
+    if (!texture) return;
+    untrack_or_warn(texture, GPU_TEXTURE);
+    wgpuTextureRelease(texture);
+}
+
+void gpu_release_view(WGPUTextureView view) {
+    if (!view) return;
+    untrack_or_warn(view, GPU_TEXTURE_VIEW);
+    wgpuTextureViewRelease(view);
+}
+
+void gpu_release_sampler(WGPUSampler sampler) {
+    if (!sampler) return;
+    untrack_or_warn(sampler, GPU_SAMPLER);
+    wgpuSamplerRelease(sampler);
+}
+
+void gpu_release_shader_module(WGPUShaderModule module) {
+    if (!module) return;
+    untrack_or_warn(module, GPU_SHADER_MODULE);
+    wgpuShaderModuleRelease(module);
+}
+
+void gpu_release_bind_group_layout(WGPUBindGroupLayout layout) {
+    if (!layout) return;
+    untrack_or_warn(layout, GPU_BIND_GROUP_LAYOUT);
+    wgpuBindGroupLayoutRelease(layout);
+}
+
+void gpu_release_bind_group(WGPUBindGroup group) {
+    if (!group) return;
+    untrack_or_warn(group, GPU_BIND_GROUP);
+    wgpuBindGroupRelease(group);
+}
+
+void gpu_release_pipeline_layout(WGPUPipelineLayout layout) {
+    if (!layout) return;
+    untrack_or_warn(layout, GPU_PIPELINE_LAYOUT);
+    wgpuPipelineLayoutRelease(layout);
+}
+
+void gpu_release_render_pipeline(WGPURenderPipeline pipeline) {
+    if (!pipeline) return;
+    untrack_or_warn(pipeline, GPU_RENDER_PIPELINE);
+    wgpuRenderPipelineRelease(pipeline);
+}
+
+void gpu_release_compute_pipeline(WGPUComputePipeline pipeline) {
+    if (!pipeline) return;
+    untrack_or_warn(pipeline, GPU_COMPUTE_PIPELINE);
+    wgpuComputePipelineRelease(pipeline);
+}
+
+int gpu_live_count(void) {
+    return resource_count;
+}
+
+size_t gpu_live_bytes(void) {
+    return live_bytes;
+}
+
+const char* gpu_resource_owner(const void* object) {
+    for (int i = 0; i < resource_count; i++) {
+        if (resources[i].object == object) return resources[i].owner;
+    }
+    return "?";
+}
+
+void gpu_report(void) {
+    printf("GPU memory: %.1f KB live, %.1f KB peak, budget %.1f MB (%d objects)\n",
+           live_bytes / 1024.0, peak_bytes / 1024.0, GPU_MEMORY_BUDGET / (1024.0 * 1024.0), resource_count);
+    for (int k = 0; k < GPU_KIND_COUNT; k++) {
+        if (kind_counts[k] == 0) continue;
+        printf("  %-18s %4d  %10.1f KB\n", kind_names[k], kind_counts[k], kind_bytes[k] / 1024.0);
+    }
+    
+    // Totals per owner
+    const char* owners[GPU_MAX_OWNERS];
+    int owner_counts[GPU_MAX_OWNERS];
+    size_t owner_bytes[GPU_MAX_OWNERS];
+    int owner_count = 0;
+    for (int i = 0; i < resource_count; i++) {
+        int o = 0;
+        while (o < owner_count && strcmp(owners[o], resources[i].owner) != 0) o++;
+        if (o == owner_count) {
+            if (owner_count == GPU_MAX_OWNERS) continue;
+            owners[o] = resources[i].owner;
+            owner_counts[o] = 0;
+            owner_bytes[o] = 0;
+            owner_count++;
+        }
+        owner_counts[o]++;
+        owner_bytes[o] += resources[i].bytes;
+    }
+    for (int o = 0; o < owner_count; o++) {
+        printf("  owner %-12s %4d  %10.1f KB\n", owners[o], owner_counts[o], owner_bytes[o] / 1024.0);
+    }
+    if (untracked) printf("  %d objects created after the table filled up\n", untracked);
+}
+
+int gpu_report_leaks(void) {
+    if (resource_count == 0) {
+        printf("GPU resources: no leaks\n");
+        return 0;
+    }
+    printf("GPU resources: %d leaked (%.1f KB)\n", resource_count, live_bytes / 1024.0);
+    for (int i = 0; i < resource_count; i++) {
+        const GpuResource* r = &resources[i];
+        printf("  %s %s, %zu bytes\n", r->owner, kind_names[r->kind], r->bytes);
+    }
+    return resource_count;
+}
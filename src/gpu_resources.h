@@ -0,0 +1,72 @@
+#ifndef GPU_RESOURCES_H
+#define GPU_RESOURCES_H
+
+#include <stddef.h>
+#include <webgpu/webgpu.h>
+
+// GPU resource registry
+//
+// Every long-lived WebGPU object is created and released through these
+// wrappers instead of the wgpu* calls, tagged with the module that owns it.
+// The registry keeps a handle table of live objects with their estimated
+// memory (buffer size, or texture size over all mips and layers), so it can
+// report usage per kind and per owner against GPU_MEMORY_BUDGET, and list
+// whatever is still alive when everything should have been released.
+// Transient command encoders, command buffers and passes are not tracked.
+
+#define GPU_MAX_RESOURCES 1024
+#define GPU_MEMORY_BUDGET (64u * 1024 * 1024)  // warn once when exceeded
+
+typedef enum {
+    GPU_BUFFER,
+    GPU_TEXTURE,
+    GPU_TEXTURE_VIEW,
+    GPU_SAMPLER,
+    GPU_SHADER_MODULE,
+    GPU_BIND_GROUP_LAYOUT,
+    GPU_BIND_GROUP,
+    GPU_PIPELINE_LAYOUT,
+    GPU_RENDER_PIPELINE,
+    GPU_COMPUTE_PIPELINE,
+    GPU_KIND_COUNT
+} GpuKind;
+
+// Creation (owner must be a string that outlives the object, e.g. a literal)
+WGPUBuffer gpu_create_buffer(WGPUDevice device, const WGPUBufferDescriptor* desc, const char* owner);
+WGPUTexture gpu_create_texture(WGPUDevice device, const WGPUTextureDescriptor* desc, const char* owner);
+WGPUTextureView gpu_create_view(WGPUTexture texture, const WGPUTextureViewDescriptor* desc, const char* owner);
+WGPUSampler gpu_create_sampler(WGPUDevice device, const WGPUSamplerDescriptor* desc, const char* owner);
+WGPUShaderModule gpu_create_shader_module(WGPUDevice device, const WGPUShaderModuleDescriptor* desc, const char* owner);
+WGPUBindGroupLayout gpu_create_bind_group_layout(WGPUDevice device, const WGPUBindGroupLayoutDescriptor* desc, const char* owner);
+WGPUBindGroup gpu_create_bind_group(WGPUDevice device, const WGPUBindGroupDescriptor* desc, const char* owner);
+WGPUPipelineLayout gpu_create_pipeline_layout(WGPUDevice device, const WGPUPipelineLayoutDescriptor* desc, const char* owner);
+WGPURenderPipeline gpu_create_render_pipeline(WGPUDevice device, const WGPURenderPipelineDescriptor* desc, const char* owner);
+WGPUComputePipeline gpu_create_compute_pipeline(WGPUDevice device, const WGPUComputePipelineDescriptor* desc, const char* owner);
+
+// Release (NULL is ignored)
+void gpu_release_buffer(WGPUBuffer buffer);
+void gpu_release_texture(WGPUTexture texture);
+void gpu_release_view(WGPUTextureView view);
+void gpu_release_sampler(WGPUSampler sampler);
+void gpu_release_shader_module(WGPUShaderModule module);
+void gpu_release_bind_group_layout(WGPUBindGroupLayout layout);
+void gpu_release_bind_group(WGPUBindGroup group);
+void gpu_release_pipeline_layout(WGPUPipelineLayout layout);
+void gpu_release_render_pipeline(WGPURenderPipeline pipeline);
+void gpu_release_compute_pipeline(WGPUComputePipeline pipeline);
+
+// Live objects and their estimated bytes
+int gpu_live_count(void);
+size_t gpu_live_bytes(void);
+
+// Owner a live object was created with, or "?" if it is not tracked
+const char* gpu_resource_owner(const void* object);
+
+// Print live usage by kind and by owner, with the peak and the budget
+void gpu_report(void);
+
+// Print every live object; call once everything should be released.
+// Returns the number of leaked objects.
+int gpu_report_leaks(void);
+
+#endif // GPU_RESOURCES_H
@@ -0,0 +1,173 @@
+#include "gpu_trace.h"
+#include "gpu_resources.h"
+#include "platform.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define GPU_TRACE_BIND_GROUPS 4  // bind group slots checked for redundant binds
+
+static GpuFrameStats current;
+static GpuFrameStats last;
+
+// State bound in the current pass
+static WGPURenderPipeline bound_pipeline = NULL;
+static WGPUBindGroup bound_groups[GPU_TRACE_BIND_GROUPS];
+
+// Command text recording
+static char trace_text[GPU_TRACE_CAPACITY];
+static size_t trace_size = 0;
+static int record_frames = 0;
+
+static void record(const char* format, ...) {
+    if (record_frames <= 0 || trace_size >= GPU_TRACE_CAPACITY - 1) return;
+    
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(trace_text + trace_size, GPU_TRACE_CAPACITY - trace_size, format, args);
+    va_end(args);
+    if (n > 0) {
+        trace_size += (size_t)n;
+        if (trace_size > GPU_TRACE_CAPACITY - 1) trace_size = GPU_TRACE_CAPACITY - 1;
+    }
+}
+
+WGPURenderPassEncoder gpu_begin_pass(WGPUCommandEncoder encoder, const WGPURenderPassDescriptor* desc) {
+    current.passes++;
+    bound_pipeline = NULL;
+    memset(bound_groups, 0, sizeof(bound_groups));
+    record("begin_pass %s\n", desc->colorAttachmentCount > 0 ?
+           gpu_resource_owner(desc->colorAttachments[0].view) : "-");
+    return wgpuCommandEncoderBeginRenderPass(encoder, desc);
+}
+
+void gpu_set_pipeline(WGPURenderPassEncoder pass, WGPURenderPipeline pipeline) {
+    current.pipeline_binds++;
+    if (pipeline == bound_pipeline) current.redundant_binds++;
+    bound_pipeline = pipeline;
+    record("set_pipeline %s\n", gpu_resource_owner(pipeline));
+    wgpuRenderPassEncoderSetPipeline(pass, pipeline);
+}
+
+void gpu_set_bind_group(WGPURenderPassEncoder pass, uint32_t index, WGPUBindGroup group) {
+    current.bind_group_binds++;
+    if (index < GPU_TRACE_BIND_GROUPS) {
+        if (bound_groups[index] == group) current.redundant_binds++;
+        bound_groups[index] = group;
+    }
+    record("set_bind_group %u %s\n", index, gpu_resource_owner(group));
+    wgpuRenderPassEncoderSetBindGroup(pass, index, group, 0, NULL);
+}
+
+void gpu_set_vertex_buffer(WGPURenderPassEncoder pass, uint32_t slot, WGPUBuffer buffer, uint64_t offset, uint64_t size) {
+    current.vertex_buffer_binds++;
+    record("set_vertex_buffer %u %s %llu %llu\n", slot, gpu_resource_owner(buffer),
+           (unsigned long long)offset, (unsigned long long)size);
+    wgpuRenderPassEncoderSetVertexBuffer(pass, slot, buffer, offset, size);
+}
+
+void gpu_draw(WGPURenderPassEncoder pass, uint32_t vertex_count, uint32_t instance_count) {
+    current.draws++;
+    current.vertices += vertex_count * instance_count;
+    current.instances += instance_count;
+    record("draw %u %u\n", vertex_count, instance_count);
+    wgpuRenderPassEncoderDraw(pass, vertex_count, instance_count, 0, 0);
+}
+
+// Vertex and instance counts live on the GPU, so only the draw is counted
+void gpu_draw_indirect(WGPURenderPassEncoder pass, WGPUBuffer args, uint64_t offset) {
+    current.draws++;
+    record("draw_indirect %s %llu\n", gpu_resource_owner(args), (unsigned long long)offset);
+    wgpuRenderPassEncoderDrawIndirect(pass, args, offset);
+}
+
+void gpu_dispatch(WGPUComputePassEncoder pass, uint32_t x, uint32_t y, uint32_t z) {
+    current.dispatches++;
+    record("dispatch %u %u %u\n", x, y, z);
+    wgpuComputePassEncoderDispatchWorkgroups(pass, x, y, z);
+}
+
+void gpu_write_buffer(WGPUQueue queue, WGPUBuffer buffer, uint64_t offset, const void* data, size_t size) {
+    current.buffer_writes++;
+    current.buffer_bytes += (uint32_t)size;
+    record("write_buffer %s %llu %zu\n", gpu_resource_owner(buffer), (unsigned long long)offset, size);
+    wgpuQueueWriteBuffer(queue, buffer, offset, data, size);
+}
+
+void gpu_write_texture(WGPUQueue queue, const WGPUTexelCopyTextureInfo* dest, const void* data, size_t size,
+                       const WGPUTexelCopyBufferLayout* layout, const WGPUExtent3D* write_size) {
+    current.texture_writes++;
+    current.texture_bytes += (uint32_t)size;
+    record("write_texture %s %ux%u %zu\n", gpu_resource_owner(dest->texture),
+           write_size->width, write_size->height, size);
+    wgpuQueueWriteTexture(queue, dest, data, size, layout, write_size);
+}
+
+void gpu_trace_resource_created(void) {
+    current.resources_created++;
+}
+
+void gpu_trace_end_frame(void) {
+    current.frame = last.frame + 1;
+    last = current;
+    memset(&current, 0, sizeof(current));
+    
+    if (record_frames > 0) {
+        record("end_frame %u\n", last.frame);
+        record_frames--;
+    }
+}
+
+const GpuFrameStats* gpu_trace_last_frame(void) {
+    return &last;
+}
+
+int gpu_trace_check_budget(const GpuFrameStats* budget) {
+    // Every field after the frame number is a counter
+    static const char* names[] = {
+        "passes", "draws", "vertices", "instances", "pipeline binds", "bind group binds",
+        "vertex buffer binds", "redundant binds", "buffer writes", "buffer bytes",
+        "texture writes", "texture bytes", "resources created", "dispatches",
+    };
+    const uint32_t* limits = &budget->passes;
+    const uint32_t* values = &last.passes;
+    int over = 0;
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (limits[i] && values[i] > limits[i]) {
+            printf("Frame %u over budget: %u %s (limit %u)\n", last.frame, values[i], names[i], limits[i]);
+            over++;
+        }
+    }
+    return over;
+}
+
+void gpu_trace_report(void) {
+    printf("GPU frame %u: %u passes, %u draws (%u vertices, %u instances), "
+           "binds %u pipeline / %u bind group / %u vertex buffer (%u redundant), "
+           "uploads %u buffer (%.1f KB) / %u texture (%.1f KB), %u resources created, %u dispatches\n",
+           last.frame, last.passes, last.draws, last.vertices, last.instances,
+           last.pipeline_binds, last.bind_group_binds, last.vertex_buffer_binds, last.redundant_binds,
+           last.buffer_writes, last.buffer_bytes / 1024.0, last.texture_writes, last.texture_bytes / 1024.0,
+           last.resources_created, last.dispatches);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void gpu_trace_record(int frame_count) {
+    trace_size = 0;
+    trace_text[0] = '\0';
+    record_frames = frame_count;
+}
+
+EMSCRIPTEN_KEEPALIVE
+size_t gpu_trace_copy(char* dest, size_t capacity) {
+    if (dest && capacity > 0) {
+        memcpy(dest, trace_text, trace_size < capacity ? trace_size : capacity);
+    }
+    return trace_size;
+}
+
+// Last frame's counters for JavaScript (GpuFrameStats, all u32)
+EMSCRIPTEN_KEEPALIVE
+const GpuFrameStats* gpu_frame_stats(void) {
+    return &last;
+}
@@ -0,0 +1,75 @@
+#ifndef GPU_TRACE_H
+#define GPU_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <webgpu/webgpu.h>
+
+// Per-frame WebGPU command statistics
+//
+// Render code issues passes, state changes, draws and queue uploads through
+// these wrappers, which forward to WebGPU and count what each frame did.
+// Counters of the last finished frame are exported to JavaScript (all
+// fields are u32, in declaration order) and can be checked against a
+// budget. The command stream of the next few frames can also be recorded
+// as text, one command per line, with objects named by their owner in the
+// GPU resource registry.
+
+#define GPU_TRACE_CAPACITY (64 * 1024)  // bytes of recorded command text
+
+typedef struct {
+    uint32_t frame;             // frames finished so far
+    uint32_t passes;
+    uint32_t draws;
+    uint32_t vertices;          // vertex count times instance count
+    uint32_t instances;
+    uint32_t pipeline_binds;
+    uint32_t bind_group_binds;
+    uint32_t vertex_buffer_binds;
+    uint32_t redundant_binds;   // pipeline or bind group that was already bound
+    uint32_t buffer_writes;
+    uint32_t buffer_bytes;
+    uint32_t texture_writes;
+    uint32_t texture_bytes;
+    uint32_t resources_created;
+    uint32_t dispatches;        // compute workgroup dispatches
+} GpuFrameStats;
+
+// Commands
+WGPURenderPassEncoder gpu_begin_pass(WGPUCommandEncoder encoder, const WGPURenderPassDescriptor* desc);
+void gpu_set_pipeline(WGPURenderPassEncoder pass, WGPURenderPipeline pipeline);
+void gpu_set_bind_group(WGPURenderPassEncoder pass, uint32_t index, WGPUBindGroup group);
+void gpu_set_vertex_buffer(WGPURenderPassEncoder pass, uint32_t slot, WGPUBuffer buffer, uint64_t offset, uint64_t size);
+void gpu_draw(WGPURenderPassEncoder pass, uint32_t vertex_count, uint32_t instance_count);
+void gpu_draw_indirect(WGPURenderPassEncoder pass, WGPUBuffer args, uint64_t offset);
+void gpu_dispatch(WGPUComputePassEncoder pass, uint32_t x, uint32_t y, uint32_t z);
+
+// Uploads
+void gpu_write_buffer(WGPUQueue queue, WGPUBuffer buffer, uint64_t offset, const void* data, size_t size);
+void gpu_write_texture(WGPUQueue queue, const WGPUTexelCopyTextureInfo* dest, const void* data, size_t size,
+                       const WGPUTexelCopyBufferLayout* layout, const WGPUExtent3D* write_size);
+
+// Called by the resource registry for every object it creates
+void gpu_trace_resource_created(void);
+
+// Close the current frame's counters (after its submit)
+void gpu_trace_end_frame(void);
+
+// Counters of the last finished frame
+const GpuFrameStats* gpu_trace_last_frame(void);
+
+// Print every counter of last_frame that exceeds the same counter in
+// budget (0 means unlimited). Returns the number over budget.
+int gpu_trace_check_budget(const GpuFrameStats* budget);
+
+// Print the last frame's counters
+void gpu_trace_report(void);
+
+// Record the commands of the next frame_count frames as text
+void gpu_trace_record(int frame_count);
+
+// Copy the recorded text to dest (up to capacity bytes); returns its full
+// size, so call with capacity 0 first to size the buffer
+size_t gpu_trace_copy(char* dest, size_t capacity);
+
+#endif // GPU_TRACE_H
@@ -0,0 +1,495 @@
+#ifndef HEADLESS_WEBGPU_H
+#define HEADLESS_WEBGPU_H
+
+// WebGPU for the headless native build
+//
+// The subset of the WebGPU C API (as in emdawnwebgpu's webgpu.h) that the
+// text renderer, the resource registry and the command wrappers use, so
+// they build natively on the no-GPU backend in src/gpu_headless.c. Only
+// names match the real header; nothing here talks to a device. Add
+// declarations here when more rendering code is built natively.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t WGPUBool;
+typedef uint64_t WGPUFlags;
+
+// Objects (opaque handles)
+typedef struct WGPUBindGroupImpl* WGPUBindGroup;
+typedef struct WGPUBindGroupLayoutImpl* WGPUBindGroupLayout;
+typedef struct WGPUBufferImpl* WGPUBuffer;
+typedef struct WGPUCommandEncoderImpl* WGPUCommandEncoder;
+typedef struct WGPUComputePassEncoderImpl* WGPUComputePassEncoder;
+typedef struct WGPUComputePipelineImpl* WGPUComputePipeline;
+typedef struct WGPUDeviceImpl* WGPUDevice;
+typedef struct WGPUPipelineLayoutImpl* WGPUPipelineLayout;
+typedef struct WGPUQuerySetImpl* WGPUQuerySet;
+typedef struct WGPUQueueImpl* WGPUQueue;
+typedef struct WGPURenderPassEncoderImpl* WGPURenderPassEncoder;
+typedef struct WGPURenderPipelineImpl* WGPURenderPipeline;
+typedef struct WGPUSamplerImpl* WGPUSampler;
+typedef struct WGPUShaderModuleImpl* WGPUShaderModule;
+typedef struct WGPUTextureImpl* WGPUTexture;
+typedef struct WGPUTextureViewImpl* WGPUTextureView;
+
+// Enums and flags
+typedef enum {
+    WGPUSType_ShaderSourceWGSL = 0x00000002,
+} WGPUSType;
+
+typedef enum {
+    WGPUTextureFormat_Undefined = 0x00000000,
+    WGPUTextureFormat_R8Unorm = 0x00000001,
+    WGPUTextureFormat_RG8Unorm = 0x0000000A,
+    WGPUTextureFormat_RGBA8Unorm = 0x00000016,
+    WGPUTextureFormat_BGRA8Unorm = 0x0000001B,
+    WGPUTextureFormat_RGBA16Float = 0x00000028,
+    WGPUTextureFormat_RGBA32Float = 0x0000002B,
+} WGPUTextureFormat;
+
+typedef enum {
+    WGPUTextureDimension_Undefined = 0x00000000,
+    WGPUTextureDimension_1D = 0x00000001,
+    WGPUTextureDimension_2D = 0x00000002,
+    WGPUTextureDimension_3D = 0x00000003,
+} WGPUTextureDimension;
+
+typedef enum {
+    WGPUTextureViewDimension_Undefined = 0x00000000,
+    WGPUTextureViewDimension_2D = 0x00000002,
+    WGPUTextureViewDimension_2DArray = 0x00000003,
+} WGPUTextureViewDimension;
+
+typedef enum {
+    WGPUTextureAspect_Undefined = 0x00000000,
+    WGPUTextureAspect_All = 0x00000001,
+} WGPUTextureAspect;
+
+typedef enum {
+    WGPUTextureSampleType_BindingNotUsed = 0x00000000,
+    WGPUTextureSampleType_Undefined = 0x00000001,
+    WGPUTextureSampleType_Float = 0x00000002,
+} WGPUTextureSampleType;
+
+typedef enum {
+    WGPUSamplerBindingType_BindingNotUsed = 0x00000000,
+    WGPUSamplerBindingType_Undefined = 0x00000001,
+    WGPUSamplerBindingType_Filtering = 0x00000002,
+} WGPUSamplerBindingType;
+
+typedef enum {
+    WGPUBufferBindingType_BindingNotUsed = 0x00000000,
+    WGPUBufferBindingType_Undefined = 0x00000001,
+    WGPUBufferBindingType_Uniform = 0x00000002,
+} WGPUBufferBindingType;
+
+typedef enum {
+    WGPUAddressMode_Undefined = 0x00000000,
+    WGPUAddressMode_ClampToEdge = 0x00000001,
+} WGPUAddressMode;
+
+typedef enum {
+    WGPUFilterMode_Undefined = 0x00000000,
+    WGPUFilterMode_Nearest = 0x00000001,
+    WGPUFilterMode_Linear = 0x00000002,
+} WGPUFilterMode;
+
+typedef enum {
+    WGPUMipmapFilterMode_Undefined = 0x00000000,
+    WGPUMipmapFilterMode_Nearest = 0x00000001,
+    WGPUMipmapFilterMode_Linear = 0x00000002,
+} WGPUMipmapFilterMode;
+
+typedef enum {
+    WGPUVertexFormat_Float32x2 = 0x0000001D,
+} WGPUVertexFormat;
+
+typedef enum {
+    WGPUVertexStepMode_Undefined = 0x00000000,
+    WGPUVertexStepMode_Vertex = 0x00000001,
+    WGPUVertexStepMode_Instance = 0x00000002,
+} WGPUVertexStepMode;
+
+typedef enum {
+    WGPUBlendFactor_Undefined = 0x00000000,
+    WGPUBlendFactor_Zero = 0x00000001,
+    WGPUBlendFactor_One = 0x00000002,
+    WGPUBlendFactor_SrcAlpha = 0x00000005,
+    WGPUBlendFactor_OneMinusSrcAlpha = 0x00000006,
+} WGPUBlendFactor;
+
+typedef enum {
+    WGPUBlendOperation_Undefined = 0x00000000,
+    WGPUBlendOperation_Add = 0x00000001,
+} WGPUBlendOperation;
+
+typedef enum {
+    WGPUPrimitiveTopology_Undefined = 0x00000000,
+    WGPUPrimitiveTopology_TriangleList = 0x00000004,
+} WGPUPrimitiveTopology;
+
+typedef enum {
+    WGPUIndexFormat_Undefined = 0x00000000,
+} WGPUIndexFormat;
+
+typedef enum {
+    WGPUFrontFace_Undefined = 0x00000000,
+    WGPUFrontFace_CCW = 0x00000001,
+} WGPUFrontFace;
+
+typedef enum {
+    WGPUCullMode_Undefined = 0x00000000,
+    WGPUCullMode_None = 0x00000001,
+} WGPUCullMode;
+
+typedef enum {
+    WGPULoadOp_Undefined = 0x00000000,
+    WGPULoadOp_Load = 0x00000001,
+    WGPULoadOp_Clear = 0x00000002,
+} WGPULoadOp;
+
+typedef enum {
+    WGPUStoreOp_Undefined = 0x00000000,
+    WGPUStoreOp_Store = 0x00000001,
+    WGPUStoreOp_Discard = 0x00000002,
+} WGPUStoreOp;
+
+typedef WGPUFlags WGPUBufferUsage;
+static const WGPUBufferUsage WGPUBufferUsage_CopyDst = 0x0000000000000008;
+static const WGPUBufferUsage WGPUBufferUsage_Vertex = 0x0000000000000020;
+static const WGPUBufferUsage WGPUBufferUsage_Uniform = 0x0000000000000040;
+
+typedef WGPUFlags WGPUTextureUsage;
+static const WGPUTextureUsage WGPUTextureUsage_CopyDst = 0x0000000000000002;
+static const WGPUTextureUsage WGPUTextureUsage_TextureBinding = 0x0000000000000004;
+static const WGPUTextureUsage WGPUTextureUsage_RenderAttachment = 0x0000000000000010;
+
+typedef WGPUFlags WGPUShaderStage;
+static const WGPUShaderStage WGPUShaderStage_Vertex = 0x0000000000000001;
+static const WGPUShaderStage WGPUShaderStage_Fragment = 0x0000000000000002;
+
+typedef WGPUFlags WGPUColorWriteMask;
+static const WGPUColorWriteMask WGPUColorWriteMask_All = 0x000000000000000F;
+
+#define WGPU_DEPTH_SLICE_UNDEFINED UINT32_MAX
+#define WGPU_WHOLE_SIZE UINT64_MAX
+
+// Structures
+typedef struct WGPUChainedStruct {
+    struct WGPUChainedStruct* next;
+    WGPUSType sType;
+} WGPUChainedStruct;
+
+typedef struct {
+    const char* data;
+    size_t length;
+} WGPUStringView;
+
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+    uint32_t depthOrArrayLayers;
+} WGPUExtent3D;
+
+typedef struct {
+    uint32_t x;
+    uint32_t y;
+    uint32_t z;
+} WGPUOrigin3D;
+
+typedef struct {
+    double r, g, b, a;
+} WGPUColor;
+
+typedef struct {
+    WGPUChainedStruct chain;
+    WGPUStringView code;
+} WGPUShaderSourceWGSL;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUStringView label;
+} WGPUShaderModuleDescriptor;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUStringView label;
+    WGPUBufferUsage usage;
+    uint64_t size;
+    WGPUBool mappedAtCreation;
+} WGPUBufferDescriptor;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUStringView label;
+    WGPUTextureUsage usage;
+    WGPUTextureDimension dimension;
+    WGPUExtent3D size;
+    WGPUTextureFormat format;
+    uint32_t mipLevelCount;
+    uint32_t sampleCount;
+    size_t viewFormatCount;
+    const WGPUTextureFormat* viewFormats;
+} WGPUTextureDescriptor;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUStringView label;
+    WGPUTextureFormat format;
+    WGPUTextureViewDimension dimension;
+    uint32_t baseMipLevel;
+    uint32_t mipLevelCount;
+    uint32_t baseArrayLayer;
+    uint32_t arrayLayerCount;
+    WGPUTextureAspect aspect;
+    WGPUTextureUsage usage;
+} WGPUTextureViewDescriptor;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUStringView label;
+    WGPUAddressMode addressModeU;
+    WGPUAddressMode addressModeV;
+    WGPUAddressMode addressModeW;
+    WGPUFilterMode magFilter;
+    WGPUFilterMode minFilter;
+    WGPUMipmapFilterMode mipmapFilter;
+    float lodMinClamp;
+    float lodMaxClamp;
+    uint32_t compare;
+    uint16_t maxAnisotropy;
+} WGPUSamplerDescriptor;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUBufferBindingType type;
+    WGPUBool hasDynamicOffset;
+    uint64_t minBindingSize;
+} WGPUBufferBindingLayout;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUSamplerBindingType type;
+} WGPUSamplerBindingLayout;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUTextureSampleType sampleType;
+    WGPUTextureViewDimension viewDimension;
+    WGPUBool multisampled;
+} WGPUTextureBindingLayout;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    uint32_t binding;
+    WGPUShaderStage visibility;
+    WGPUBufferBindingLayout buffer;
+    WGPUSamplerBindingLayout sampler;
+    WGPUTextureBindingLayout texture;
+} WGPUBindGroupLayoutEntry;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUStringView label;
+    size_t entryCount;
+    const WGPUBindGroupLayoutEntry* entries;
+} WGPUBindGroupLayoutDescriptor;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    uint32_t binding;
+    WGPUBuffer buffer;
+    uint64_t offset;
+    uint64_t size;
+    WGPUSampler sampler;
+    WGPUTextureView textureView;
+} WGPUBindGroupEntry;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUStringView label;
+    WGPUBindGroupLayout layout;
+    size_t entryCount;
+    const WGPUBindGroupEntry* entries;
+} WGPUBindGroupDescriptor;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUStringView label;
+    size_t bindGroupLayoutCount;
+    const WGPUBindGroupLayout* bindGroupLayouts;
+} WGPUPipelineLayoutDescriptor;
+
+typedef struct {
+    WGPUVertexFormat format;
+    uint64_t offset;
+    uint32_t shaderLocation;
+} WGPUVertexAttribute;
+
+typedef struct {
+    WGPUVertexStepMode stepMode;
+    uint64_t arrayStride;
+    size_t attributeCount;
+    const WGPUVertexAttribute* attributes;
+} WGPUVertexBufferLayout;
+
+typedef struct {
+    WGPUBlendOperation operation;
+    WGPUBlendFactor srcFactor;
+    WGPUBlendFactor dstFactor;
+} WGPUBlendComponent;
+
+typedef struct {
+    WGPUBlendComponent color;
+    WGPUBlendComponent alpha;
+} WGPUBlendState;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUTextureFormat format;
+    const WGPUBlendState* blend;
+    WGPUColorWriteMask writeMask;
+} WGPUColorTargetState;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUShaderModule module;
+    WGPUStringView entryPoint;
+    size_t constantCount;
+    const void* constants;
+    size_t targetCount;
+    const WGPUColorTargetState* targets;
+} WGPUFragmentState;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUShaderModule module;
+    WGPUStringView entryPoint;
+    size_t constantCount;
+    const void* constants;
+    size_t bufferCount;
+    const WGPUVertexBufferLayout* buffers;
+} WGPUVertexState;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUPrimitiveTopology topology;
+    WGPUIndexFormat stripIndexFormat;
+    WGPUFrontFace frontFace;
+    WGPUCullMode cullMode;
+    WGPUBool unclippedDepth;
+} WGPUPrimitiveState;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    uint32_t count;
+    uint32_t mask;
+    WGPUBool alphaToCoverageEnabled;
+} WGPUMultisampleState;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUStringView label;
+    WGPUPipelineLayout layout;
+    WGPUVertexState vertex;
+    WGPUPrimitiveState primitive;
+    const void* depthStencil;
+    WGPUMultisampleState multisample;
+    const WGPUFragmentState* fragment;
+} WGPURenderPipelineDescriptor;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUShaderModule module;
+    WGPUStringView entryPoint;
+    size_t constantCount;
+    const void* constants;
+} WGPUComputeState;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUStringView label;
+    WGPUPipelineLayout layout;
+    WGPUComputeState compute;
+} WGPUComputePipelineDescriptor;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUTextureView view;
+    uint32_t depthSlice;
+    WGPUTextureView resolveTarget;
+    WGPULoadOp loadOp;
+    WGPUStoreOp storeOp;
+    WGPUColor clearValue;
+} WGPURenderPassColorAttachment;
+
+typedef struct {
+    WGPUChainedStruct* nextInChain;
+    WGPUStringView label;
+    size_t colorAttachmentCount;
+    const WGPURenderPassColorAttachment* colorAttachments;
+    const void* depthStencilAttachment;
+    WGPUQuerySet occlusionQuerySet;
+    const void* timestampWrites;
+} WGPURenderPassDescriptor;
+
+typedef struct {
+    uint64_t offset;
+    uint32_t bytesPerRow;
+    uint32_t rowsPerImage;
+} WGPUTexelCopyBufferLayout;
+
+typedef struct {
+    WGPUTexture texture;
+    uint32_t mipLevel;
+    WGPUOrigin3D origin;
+    WGPUTextureAspect aspect;
+} WGPUTexelCopyTextureInfo;
+
+// Functions
+WGPUBindGroup wgpuDeviceCreateBindGroup(WGPUDevice device, const WGPUBindGroupDescriptor* descriptor);
+WGPUBindGroupLayout wgpuDeviceCreateBindGroupLayout(WGPUDevice device, const WGPUBindGroupLayoutDescriptor* descriptor);
+WGPUBuffer wgpuDeviceCreateBuffer(WGPUDevice device, const WGPUBufferDescriptor* descriptor);
+WGPUComputePipeline wgpuDeviceCreateComputePipeline(WGPUDevice device, const WGPUComputePipelineDescriptor* descriptor);
+WGPUPipelineLayout wgpuDeviceCreatePipelineLayout(WGPUDevice device, const WGPUPipelineLayoutDescriptor* descriptor);
+WGPURenderPipeline wgpuDeviceCreateRenderPipeline(WGPUDevice device, const WGPURenderPipelineDescriptor* descriptor);
+WGPUSampler wgpuDeviceCreateSampler(WGPUDevice device, const WGPUSamplerDescriptor* descriptor);
+WGPUShaderModule wgpuDeviceCreateShaderModule(WGPUDevice device, const WGPUShaderModuleDescriptor* descriptor);
+WGPUTexture wgpuDeviceCreateTexture(WGPUDevice device, const WGPUTextureDescriptor* descriptor);
+WGPUTextureView wgpuTextureCreateView(WGPUTexture texture, const WGPUTextureViewDescriptor* descriptor);
+
+void wgpuBindGroupRelease(WGPUBindGroup bindGroup);
+void wgpuBindGroupLayoutRelease(WGPUBindGroupLayout bindGroupLayout);
+void wgpuBufferRelease(WGPUBuffer buffer);
+void wgpuComputePipelineRelease(WGPUComputePipeline computePipeline);
+void wgpuPipelineLayoutRelease(WGPUPipelineLayout pipelineLayout);
+void wgpuRenderPipelineRelease(WGPURenderPipeline renderPipeline);
+void wgpuSamplerRelease(WGPUSampler sampler);
+void wgpuShaderModuleRelease(WGPUShaderModule shaderModule);
+void wgpuTextureRelease(WGPUTexture texture);
+void wgpuTextureViewRelease(WGPUTextureView textureView);
+
+void wgpuQueueWriteBuffer(WGPUQueue queue, WGPUBuffer buffer, uint64_t bufferOffset, const void* data, size_t size);
+void wgpuQueueWriteTexture(WGPUQueue queue, const WGPUTexelCopyTextureInfo* destination, const void* data,
+                           size_t dataSize, const WGPUTexelCopyBufferLayout* dataLayout,
+                           const WGPUExtent3D* writeSize);
+
+WGPURenderPassEncoder wgpuCommandEncoderBeginRenderPass(WGPUCommandEncoder commandEncoder,
+                                                        const WGPURenderPassDescriptor* descriptor);
+void wgpuRenderPassEncoderSetPipeline(WGPURenderPassEncoder renderPassEncoder, WGPURenderPipeline pipeline);
+void wgpuRenderPassEncoderSetBindGroup(WGPURenderPassEncoder renderPassEncoder, uint32_t groupIndex,
+                                       WGPUBindGroup group, size_t dynamicOffsetCount, const uint32_t* dynamicOffsets);
+void wgpuRenderPassEncoderSetVertexBuffer(WGPURenderPassEncoder renderPassEncoder, uint32_t slot,
+                                          WGPUBuffer buffer, uint64_t offset, uint64_t size);
+void wgpuRenderPassEncoderDraw(WGPURenderPassEncoder renderPassEncoder, uint32_t vertexCount,
+                               uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance);
+void wgpuRenderPassEncoderDrawIndirect(WGPURenderPassEncoder renderPassEncoder, WGPUBuffer indirectBuffer,
+                                       uint64_t indirectOffset);
+void wgpuRenderPassEncoderEnd(WGPURenderPassEncoder renderPassEncoder);
+void wgpuRenderPassEncoderRelease(WGPURenderPassEncoder renderPassEncoder);
+void wgpuComputePassEncoderDispatchWorkgroups(WGPUComputePassEncoder computePassEncoder, uint32_t workgroupCountX,
+                                              uint32_t workgroupCountY, uint32_t workgroupCountZ);
+
+#endif // HEADLESS_WEBGPU_H
@@ -0,0 +1,65 @@
+#include "image_upload.h"
+#include "gpu_resources.h"
+#include <emscripten.h>
+#include <stdio.h>
+
+EM_JS(int, js_image_width, (int image), {
+    const bitmap = Module.images && Module.images[image];
+    return bitmap ? bitmap.width : 0;
+});
+
+EM_JS(int, js_image_height, (int image), {
+    const bitmap = Module.images && Module.images[image];
+    return bitmap ? bitmap.height : 0;
+});
+
+// The copy is queued like a queue write: it lands before the next submit
+EM_JS(void, js_copy_image, (int image, WGPUQueue queue, WGPUTexture texture), {
+    const bitmap = Module.images[image];
+    WebGPU.getJsObject(queue).copyExternalImageToTexture(
+        {source: bitmap},
+        {texture: WebGPU.getJsObject(texture), premultipliedAlpha: false},
+        [bitmap.width, bitmap.height]);
+});
+
+EM_JS(void, js_image_release, (int image), {
+    const bitmap = Module.images && Module.images[image];
+    if (bitmap) {
+        bitmap.close();
+        Module.images[image] = null;
+    }
+});
+
+int image_width(int image) {
+    return js_image_width(image);
+}
+
+int image_height(int image) {
+    return js_image_height(image);
+}
+
+WGPUTexture image_upload_texture(WGPUDevice device, WGPUQueue queue, int image, const char* owner) {
+    int width = js_image_width(image);
+    int height = js_image_height(image);
+    if (width == 0 || height == 0) {
+        printf("Image %d is not loaded\n", image);
+        return NULL;
+    }
+    
+    // copyExternalImageToTexture renders into the destination
+    WGPUTextureDescriptor tex_desc = {
+        .usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst | WGPUTextureUsage_RenderAttachment,
+        .dimension = WGPUTextureDimension_2D,
+        .size = {width, height, 1},
+        .format = WGPUTextureFormat_RGBA8Unorm,
+        .mipLevelCount = 1,
+        .sampleCount = 1,
+    };
+    WGPUTexture texture = gpu_create_texture(device, &tex_desc, owner);
+    if (texture) js_copy_image(image, queue, texture);
+    return texture;
+}
+
+void image_release(int image) {
+    js_image_release(image);
+}
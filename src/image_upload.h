@@ -0,0 +1,26 @@
+#ifndef IMAGE_UPLOAD_H
+#define IMAGE_UPLOAD_H
+
+#include <webgpu/webgpu.h>
+
+// Browser-decoded image upload
+//
+// The page decodes images with createImageBitmap and keeps them in the
+// Module.images array; C refers to an image by its index there (its
+// handle). image_upload_texture copies a bitmap straight into a new GPU
+// texture with copyExternalImageToTexture, so the pixels never pass through
+// the WASM heap. Where that is not available, pixels are still uploaded
+// from memory with wgpuQueueWriteTexture (upload_font_texture).
+
+// Size of a live image in pixels (0 if the handle is not live)
+int image_width(int image);
+int image_height(int image);
+
+// Create an RGBA8 texture the size of the image and copy the image into
+// it, without premultiplying alpha. Returns NULL if the handle is not live.
+WGPUTexture image_upload_texture(WGPUDevice device, WGPUQueue queue, int image, const char* owner);
+
+// Close the bitmap and free its handle
+void image_release(int image);
+
+#endif // IMAGE_UPLOAD_H
@@ -0,0 +1,38 @@
+#include "input.h"
+
+#define INPUT_QUEUE_MASK (INPUT_QUEUE_SIZE - 1)
+
+void input_queue_reset(InputQueue* q) {
+    atomic_store(&q->head, 0);
+    atomic_store(&q->tail, 0);
+    atomic_store(&q->dropped, 0);
+}
+
+int input_queue_push(InputQueue* q, const InputEvent* ev) {
+    unsigned head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    
+    if (head - tail >= INPUT_QUEUE_SIZE) {
+        atomic_fetch_add_explicit(&q->dropped, 1, memory_order_relaxed);
+        return 0;
+    }
+    
+    q->events[head & INPUT_QUEUE_MASK] = *ev;
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return 1;
+}
+
+int input_queue_peek(InputQueue* q, InputEvent* out) {
+    unsigned tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&q->head, memory_order_acquire);
+    
+    if (tail == head) return 0;
+    
+    *out = q->events[tail & INPUT_QUEUE_MASK];
+    return 1;
+}
+
+void input_queue_pop(InputQueue* q) {
+    unsigned tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+}
@@ -0,0 +1,39 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Lock-free single-producer/single-consumer queue of timestamped key events.
+// The browser main thread (JS key handlers) produces, the simulation
+// consumes, and each event is applied at the moment it happened within the
+// fixed simulation step instead of being folded into per-frame booleans.
+
+#define INPUT_QUEUE_SIZE 256  // must be a power of two
+
+typedef struct {
+    double time_ms;   // platform_now_ms() clock
+    int key_code;     // DOM keyCode
+    int pressed;      // 1 = key down, 0 = key up
+} InputEvent;
+
+typedef struct {
+    InputEvent events[INPUT_QUEUE_SIZE];
+    atomic_uint head;     // next slot to write (producer)
+    atomic_uint tail;     // next slot to read (consumer)
+    atomic_uint dropped;  // events lost because the queue was full
+} InputQueue;
+
+// Empty the queue
+void input_queue_reset(InputQueue* q);
+
+// Producer: append an event; returns 0 if the queue is full
+int input_queue_push(InputQueue* q, const InputEvent* ev);
+
+// Consumer: copy the oldest event without removing it; returns 0 if empty
+int input_queue_peek(InputQueue* q, InputEvent* out);
+
+// Consumer: remove the oldest event
+void input_queue_pop(InputQueue* q);
+
+#endif // INPUT_H
@@ -0,0 +1,217 @@
+#include "jobs.h"
+#include "platform.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+
+#define JOB_DEQUE_MASK (JOB_DEQUE_SIZE - 1)
+#define JOB_IDLE_SPINS 64  // Failed steal attempts before a worker naps
+
+typedef struct {
+    JobFn fn;
+    void* arg;
+    int begin;
+    int end;
+    int grain;
+    JobCounter* counter;
+} Job;
+
+// Chase-Lev deque (fixed capacity) storing jobs by value. Thieves copy a
+// job out before claiming it, and the owner never lets the deque fill up, so
+// a slot is never overwritten while another thread may still be reading it.
+typedef struct {
+    atomic_long top;
+    char pad0[64 - sizeof(atomic_long)];
+    atomic_long bottom;
+    char pad1[64 - sizeof(atomic_long)];
+    Job buffer[JOB_DEQUE_SIZE];
+} WorkerQueue;
+
+static WorkerQueue queues[JOB_MAX_WORKERS];
+static pthread_t threads[JOB_MAX_WORKERS];
+static int worker_total = 1;
+static atomic_int workers_running = 0;
+
+// Queue owned by the current thread. Threads that are not job workers (the
+// browser main thread or the sim thread) share queue 0, so only one of them
+// may submit jobs at a time.
+static _Thread_local int worker_index = 0;
+
+// Owner only. Returns 0 if the deque is full.
+static int deque_push(WorkerQueue* q, const Job* job) {
+    long b = atomic_load_explicit(&q->bottom, memory_order_relaxed);
+    long t = atomic_load_explicit(&q->top, memory_order_acquire);
+    if (b - t >= JOB_DEQUE_SIZE - 1) return 0;
+    
+    q->buffer[b & JOB_DEQUE_MASK] = *job;
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+    return 1;
+}
+
+// Owner only. Returns 0 if the deque is empty.
+static int deque_pop(WorkerQueue* q, Job* out) {
+    long b = atomic_load_explicit(&q->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&q->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long t = atomic_load_explicit(&q->top, memory_order_relaxed);
+    
+    if (t > b) {
+        // Empty
+        atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+        return 0;
+    }
+    
+    *out = q->buffer[b & JOB_DEQUE_MASK];
+    if (t == b) {
+        // Last job: race against thieves for it
+        int won = atomic_compare_exchange_strong_explicit(&q->top, &t, t + 1,
+                memory_order_seq_cst, memory_order_relaxed);
+        atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+        return won;
+    }
+    return 1;
+}
+
+// Any thread. Returns 0 if the deque is empty or another thief won.
+static int deque_steal(WorkerQueue* q, Job* out) {
+    long t = atomic_load_explicit(&q->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long b = atomic_load_explicit(&q->bottom, memory_order_acquire);
+    
+    if (t >= b) return 0;
+    
+    *out = q->buffer[t & JOB_DEQUE_MASK];
+    return atomic_compare_exchange_strong_explicit(&q->top, &t, t + 1,
+            memory_order_seq_cst, memory_order_relaxed);
+}
+
+// Queue a job on the current thread's deque, or report that it is full
+static int push_job(JobFn fn, void* arg, int begin, int end, int grain, JobCounter* counter) {
+    Job job = {fn, arg, begin, end, grain, counter};
+    return deque_push(&queues[worker_index], &job);
+}
+
+// Run a job, splitting off the upper half of its range while it is larger
+// than its grain so that other workers can steal it
+static void execute_job(const Job* job) {
+    JobFn fn = job->fn;
+    void* arg = job->arg;
+    int begin = job->begin;
+    int end = job->end;
+    int grain = job->grain;
+    JobCounter* counter = job->counter;
+    
+    while (end - begin > grain) {
+        int mid = begin + (end - begin) / 2;
+        if (counter) atomic_fetch_add_explicit(&counter->pending, 1, memory_order_relaxed);
+        if (!push_job(fn, arg, mid, end, grain, counter)) {
+            if (counter) atomic_fetch_sub_explicit(&counter->pending, 1, memory_order_relaxed);
+            break;  // Deque full: just do the whole range here
+        }
+        end = mid;
+    }
+    
+    fn(arg, begin, end);
+    
+    if (counter) atomic_fetch_sub_explicit(&counter->pending, 1, memory_order_release);
+}
+
+// Take one job from our own deque or steal one; returns 0 if none found
+static int run_one_job(void) {
+    Job job;
+    int found = deque_pop(&queues[worker_index], &job);
+    
+    for (int i = 1; !found && i < worker_total; i++) {
+        found = deque_steal(&queues[(worker_index + i) % worker_total], &job);
+    }
+    
+    if (!found) return 0;
+    execute_job(&job);
+    return 1;
+}
+
+static void* worker_main(void* arg) {
+    worker_index = (int)(long)arg;
+    int idle = 0;
+    
+    while (atomic_load_explicit(&workers_running, memory_order_acquire)) {
+        if (run_one_job()) {
+            idle = 0;
+        } else if (++idle < JOB_IDLE_SPINS) {
+            sched_yield();
+        } else {
+            platform_sleep_ms(0.05);
+        }
+    }
+    return NULL;
+}
+
+void job_system_init(int worker_count) {
+    if (atomic_load(&workers_running)) job_system_shutdown();
+    
+    if (worker_count < 1) worker_count = 1;
+    if (worker_count > JOB_MAX_WORKERS) worker_count = JOB_MAX_WORKERS;
+    
+    memset(queues, 0, sizeof(queues));
+    worker_total = worker_count;
+    worker_index = 0;
+    
+    atomic_store(&workers_running, 1);
+    for (int i = 1; i < worker_total; i++) {
+        if (pthread_create(&threads[i], NULL, worker_main, (void*)(long)i) != 0) {
+            printf("Failed to start job worker %d\n", i);
+            worker_total = i;
+            break;
+        }
+    }
+    
+    printf("Job system started with %d workers\n", worker_total);
+}
+
+void job_system_shutdown(void) {
+    if (!atomic_exchange(&workers_running, 0)) return;
+    for (int i = 1; i < worker_total; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    worker_total = 1;
+}
+
+int job_worker_count(void) {
+    return worker_total;
+}
+
+void job_run(JobFn fn, void* arg, int begin, int end, int grain, JobCounter* counter) {
+    if (end <= begin) return;
+    if (grain < 1) grain = 1;
+    
+    if (counter) atomic_fetch_add_explicit(&counter->pending, 1, memory_order_relaxed);
+    if (!push_job(fn, arg, begin, end, grain, counter)) {
+        // No room to queue: run it now
+        Job job = {fn, arg, begin, end, grain, counter};
+        execute_job(&job);
+    }
+}
+
+void job_wait(JobCounter* counter) {
+    while (atomic_load_explicit(&counter->pending, memory_order_acquire) > 0) {
+        if (!run_one_job()) sched_yield();
+    }
+}
+
+void job_parallel_for(int count, int min_grain, JobFn fn, void* arg) {
+    if (count <= 0) return;
+    
+    if (worker_total <= 1 || count <= min_grain) {
+        fn(arg, 0, count);
+        return;
+    }
+    
+    int grain = count / (worker_total * JOB_SPLITS_PER_WORKER);
+    if (grain < min_grain) grain = min_grain;
+    
+    JobCounter counter = {0};
+    job_run(fn, arg, 0, count, grain, &counter);
+    job_wait(&counter);
+}
@@ -0,0 +1,45 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stdatomic.h>
+
+// Work-stealing job system
+// Each worker owns a Chase-Lev deque: it pushes/pops at the bottom while idle
+// workers steal from the top. Jobs operate on an index range so large loops
+// can be split lazily as other workers go idle.
+
+#define JOB_MAX_WORKERS 16
+#define JOB_DEQUE_SIZE 1024         // per worker, must be a power of two
+#define JOB_SPLITS_PER_WORKER 4     // target chunks per worker for parallel-for
+
+// Job body: process indices [begin, end)
+typedef void (*JobFn)(void* arg, int begin, int end);
+
+// Completion counter: incremented when a job is queued, decremented when it
+// finishes. Waiting for zero is how job dependencies are expressed.
+typedef struct {
+    atomic_int pending;
+} JobCounter;
+
+// Start the job system with the given number of workers (including the
+// calling thread, so 1 means "run everything inline")
+void job_system_init(int worker_count);
+
+// Stop and join all worker threads
+void job_system_shutdown(void);
+
+// Number of workers, including the submitting thread
+int job_worker_count(void);
+
+// Queue fn over [begin, end) without waiting. Ranges larger than grain are
+// split in half on execution so idle workers can steal the other half.
+void job_run(JobFn fn, void* arg, int begin, int end, int grain, JobCounter* counter);
+
+// Block until counter reaches zero, executing queued jobs meanwhile
+void job_wait(JobCounter* counter);
+
+// Split [0, count) across all workers and wait for completion.
+// Grain adapts to worker count but never drops below min_grain.
+void job_parallel_for(int count, int min_grain, JobFn fn, void* arg);
+
+#endif // JOBS_H
@@ -0,0 +1,116 @@
+#include "level.h"
+#include "gpu_resources.h"
+#include "gpu_trace.h"
+#include "sprite_batch.h"
+#include "stream.h"
+#include <stdio.h>
+#include <string.h>
+
+// Decoration record (see tools/build_level.py)
+typedef struct {
+    float x, y;
+    float rotation;
+    float scale;
+    uint32_t image;  // modulo the atlas image count
+    uint32_t color;
+} LevelDecoration;
+
+_Static_assert(LEVEL_MAX_DECORATIONS * sizeof(SpriteInstance) <= STREAM_SLOT_BYTES,
+               "a decoded region must fit a stream slot");
+_Static_assert(4 + LEVEL_MAX_DECORATIONS * sizeof(LevelDecoration) <= STREAM_RAW_BYTES,
+               "a region record must fit the stream's read buffer");
+
+static WGPUQueue level_queue = NULL;
+static WGPUBuffer region_buffer = NULL;  // STREAM_SLOT_BYTES per stream slot
+
+// Runs on the decode thread; the atlas table is not modified after loading
+static int decode_region(void* user, const void* raw, size_t raw_size, void* out, size_t capacity) {
+    (void)user;
+    uint32_t count;
+    int image_count = sprite_atlas_image_count();
+    if (raw_size < 4 || image_count == 0) return -1;
+    memcpy(&count, raw, 4);
+    if (count > LEVEL_MAX_DECORATIONS || raw_size < 4 + count * sizeof(LevelDecoration) ||
+        count * sizeof(SpriteInstance) > capacity) return -1;
+    
+    SpriteInstance* instances = (SpriteInstance*)out;
+    for (uint32_t i = 0; i < count; i++) {
+        LevelDecoration d;
+        memcpy(&d, (const uint8_t*)raw + 4 + i * sizeof(d), sizeof(d));
+        int image = (int)(d.image % (uint32_t)image_count);
+        const AtlasImage* img = sprite_atlas_image(image);
+        SpriteInstance* inst = &instances[i];
+        inst->position[0] = d.x;
+        inst->position[1] = d.y;
+        inst->position[2] = 0.0f;
+        inst->rotation = d.rotation;
+        inst->size[0] = img->width * d.scale;
+        inst->size[1] = img->height * d.scale;
+        memcpy(inst->uv_rect, img->uv_rect, sizeof(inst->uv_rect));
+        inst->layer = (uint16_t)img->layer;
+        inst->mesh = (uint16_t)image;
+        inst->color = d.color;
+    }
+    return (int)(count * sizeof(SpriteInstance));
+}
+
+static void upload_region(void* user, int slot, const void* data, size_t offset, size_t size) {
+    (void)user;
+    gpu_write_buffer(level_queue, region_buffer, (uint64_t)slot * STREAM_SLOT_BYTES + offset, data, size);
+}
+
+int level_open(WGPUDevice device, WGPUQueue queue, const char* path) {
+    if (!sprite_batch_is_ready() || region_buffer) return 1;
+    level_queue = queue;
+    
+    // Create region buffer: one fixed range per stream slot, so streaming
+    // never creates GPU objects
+    WGPUBufferDescriptor desc = {
+        .usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst,
+        .size = (uint64_t)STREAM_MAX_RESIDENT * STREAM_SLOT_BYTES,
+    };
+    region_buffer = gpu_create_buffer(device, &desc, "level");
+    
+    StreamHooks hooks = {
+        .decode = decode_region,
+        .upload = upload_region,
+        .user = NULL,
+    };
+    if (stream_open(path, &hooks)) {
+        gpu_release_buffer(region_buffer);
+        region_buffer = NULL;
+        return 1;
+    }
+    return 0;
+}
+
+void level_close(void) {
+    stream_close();
+    gpu_release_buffer(region_buffer);
+    region_buffer = NULL;
+}
+
+int level_update(const Camera* cam) {
+    if (!region_buffer) return 0;
+    return stream_update(cam->x, cam->y, (cam->max_x - cam->min_x) * 0.5f, (cam->max_y - cam->min_y) * 0.5f);
+}
+
+void level_draw(WGPURenderPassEncoder pass, const Camera* cam) {
+    if (!region_buffer) return;
+    
+    uint64_t offsets[STREAM_MAX_RESIDENT];
+    int counts[STREAM_MAX_RESIDENT];
+    int ranges = 0;
+    for (int slot = 0; slot < STREAM_MAX_RESIDENT; slot++) {
+        float rect[4];
+        int bytes = stream_slot_ready(slot, rect);
+        if (bytes <= 0) continue;
+        float half_w = (rect[2] - rect[0]) * 0.5f + LEVEL_DECORATION_MARGIN;
+        float half_h = (rect[3] - rect[1]) * 0.5f + LEVEL_DECORATION_MARGIN;
+        if (!camera_box_visible(cam, (rect[0] + rect[2]) * 0.5f, (rect[1] + rect[3]) * 0.5f, 0.0f, half_w, half_h)) continue;
+        offsets[ranges] = (uint64_t)slot * STREAM_SLOT_BYTES;
+        counts[ranges] = bytes / (int)sizeof(SpriteInstance);
+        ranges++;
+    }
+    sprite_batch_draw_ranges(pass, cam->view_proj, region_buffer, offsets, counts, ranges);
+}
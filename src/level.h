@@ -0,0 +1,30 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include <webgpu/webgpu.h>
+#include "camera.h"
+
+// Streamed level geometry
+// Ground decorations are read region by region through src/stream.c. Each
+// region decodes (on the stream's decode thread) straight into sprite
+// instances, which are uploaded into that region's fixed range of one
+// vertex buffer and drawn with the sprite batch pipeline.
+
+#define LEVEL_MAX_DECORATIONS 512      // per region, as tools/build_level.py writes them
+#define LEVEL_DECORATION_MARGIN 128.0f  // how far a decoration may reach past its region
+
+// Open a level archive (after the sprite batch pipeline). Returns 0 on
+// success.
+int level_open(WGPUDevice device, WGPUQueue queue, const char* path);
+
+// Stop streaming and release the region buffer
+void level_close(void);
+
+// Stream regions for the camera's view. Returns nonzero when a region
+// finished uploading, i.e. the next frame shows more of the level.
+int level_update(const Camera* cam);
+
+// Draw the resident regions the camera can see, one draw per region
+void level_draw(WGPURenderPassEncoder pass, const Camera* cam);
+
+#endif // LEVEL_H
@@ -0,0 +1,353 @@
+#include "lighting.h"
+#include "gpu_resources.h"
+#include "gpu_trace.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Uniform data (matches LightingUniforms in light_cull.wgsl and the lit
+// sprite shaders)
+typedef struct {
+    float view_proj[16];
+    float ambient[4];
+    float viewport[2];       // scene size in pixels
+    uint32_t tile_count[2];  // tiles across and down this frame
+    uint32_t light_count;
+    uint32_t padding[3];
+} LightingUniforms;
+
+// Light as queued, in world space (matches Light in light_cull.wgsl)
+typedef struct {
+    float position[2];
+    float radius;
+    float padding;
+    float color[4];
+} Light;
+
+// The pass writes each light again in scene pixels, same size as Light
+#define SCREEN_LIGHT_BYTES 32
+
+// Lighting WebGPU objects
+static WGPUDevice light_device = NULL;
+static WGPUQueue light_queue = NULL;
+static WGPUBuffer light_uniform_buffer = NULL;
+static WGPUBuffer light_buffer = NULL;         // Light per queued light
+static WGPUBuffer screen_light_buffer = NULL;  // projected lights, written by the pass
+static WGPUBuffer tile_buffer = NULL;          // LIGHT_TILE_WORDS per tile
+static WGPUBindGroupLayout render_layout = NULL;
+static WGPUBindGroup render_bind_group = NULL;
+static WGPUBindGroupLayout cull_layout = NULL;
+static WGPUBindGroup cull_bind_group = NULL;
+static WGPUComputePipeline project_pipeline = NULL;
+static WGPUComputePipeline bin_pipeline = NULL;
+
+// Tile grid the buffer was allocated for (the surface size)
+static int grid_width = 0;
+static int grid_height = 0;
+static int tiles_hold_lights = 0;  // whether the last pass binned any light
+
+// Lights queued this frame
+static Light lights[MAX_LIGHTS];
+static int light_count = 0;
+static int lights_dropped = 0;
+static int last_light_count = 0;
+static float ambient[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+
+void lighting_init(WGPUDevice device, WGPUQueue queue) {
+    light_device = device;
+    light_queue = queue;
+    
+    // Create buffers
+    WGPUBufferDescriptor ub_desc = {
+        .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+        .size = sizeof(LightingUniforms),
+    };
+    light_uniform_buffer = gpu_create_buffer(device, &ub_desc, "lighting");
+    
+    WGPUBufferDescriptor light_desc = {
+        .usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst,
+        .size = MAX_LIGHTS * sizeof(Light),
+    };
+    light_buffer = gpu_create_buffer(device, &light_desc, "lighting");
+    
+    WGPUBufferDescriptor screen_desc = {
+        .usage = WGPUBufferUsage_Storage,
+        .size = MAX_LIGHTS * SCREEN_LIGHT_BYTES,
+    };
+    screen_light_buffer = gpu_create_buffer(device, &screen_desc, "lighting");
+    
+    // Create the layout lit fragment shaders bind (uniform + projected
+    // lights + tile lists)
+    WGPUBindGroupLayoutEntry bgl_entries[] = {
+        {
+            .binding = 0,
+            .visibility = WGPUShaderStage_Fragment,
+            .buffer = {
+                .type = WGPUBufferBindingType_Uniform,
+                .minBindingSize = sizeof(LightingUniforms),
+            },
+        },
+        {
+            .binding = 1,
+            .visibility = WGPUShaderStage_Fragment,
+            .buffer = {.type = WGPUBufferBindingType_ReadOnlyStorage},
+        },
+        {
+            .binding = 2,
+            .visibility = WGPUShaderStage_Fragment,
+            .buffer = {.type = WGPUBufferBindingType_ReadOnlyStorage},
+        },
+    };
+    WGPUBindGroupLayoutDescriptor bgl_desc = {
+        .entryCount = 3,
+        .entries = bgl_entries,
+    };
+    render_layout = gpu_create_bind_group_layout(device, &bgl_desc, "lighting");
+    
+    // Until the first pass, every pixel gets the ambient color
+    LightingUniforms uniforms = {0};
+    memcpy(uniforms.ambient, ambient, sizeof(uniforms.ambient));
+    uniforms.tile_count[0] = 1;
+    uniforms.tile_count[1] = 1;
+    gpu_write_buffer(queue, light_uniform_buffer, 0, &uniforms, sizeof(uniforms));
+}
+
+// (Re)create the bind groups over the current tile buffer
+static void create_bind_groups(void) {
+    gpu_release_bind_group(render_bind_group);
+    gpu_release_bind_group(cull_bind_group);
+    render_bind_group = NULL;
+    cull_bind_group = NULL;
+    if (!tile_buffer) return;
+    
+    uint64_t tile_bytes = (uint64_t)grid_width * grid_height * LIGHT_TILE_WORDS * sizeof(uint32_t);
+    WGPUBindGroupEntry render_entries[] = {
+        {.binding = 0, .buffer = light_uniform_buffer, .offset = 0, .size = sizeof(LightingUniforms)},
+        {.binding = 1, .buffer = screen_light_buffer, .offset = 0, .size = MAX_LIGHTS * SCREEN_LIGHT_BYTES},
+        {.binding = 2, .buffer = tile_buffer, .offset = 0, .size = tile_bytes},
+    };
+    WGPUBindGroupDescriptor render_desc = {
+        .layout = render_layout,
+        .entryCount = 3,
+        .entries = render_entries,
+    };
+    render_bind_group = gpu_create_bind_group(light_device, &render_desc, "lighting");
+    
+    if (!cull_layout) return;
+    WGPUBindGroupEntry cull_entries[] = {
+        {.binding = 0, .buffer = light_uniform_buffer, .offset = 0, .size = sizeof(LightingUniforms)},
+        {.binding = 1, .buffer = light_buffer, .offset = 0, .size = MAX_LIGHTS * sizeof(Light)},
+        {.binding = 2, .buffer = screen_light_buffer, .offset = 0, .size = MAX_LIGHTS * SCREEN_LIGHT_BYTES},
+        {.binding = 3, .buffer = tile_buffer, .offset = 0, .size = tile_bytes},
+    };
+    WGPUBindGroupDescriptor cull_desc = {
+        .layout = cull_layout,
+        .entryCount = 4,
+        .entries = cull_entries,
+    };
+    cull_bind_group = gpu_create_bind_group(light_device, &cull_desc, "light cull");
+}
+
+void lighting_create_pipeline(const char* shader_source) {
+    if (!light_device || !shader_source || bin_pipeline) return;
+    
+    // Create shader module
+    WGPUShaderSourceWGSL wgsl_source = {
+        .chain = {.sType = WGPUSType_ShaderSourceWGSL},
+        .code = {.data = shader_source, .length = strlen(shader_source)},
+    };
+    WGPUShaderModuleDescriptor shader_desc = {
+        .nextInChain = (WGPUChainedStruct*)&wgsl_source,
+    };
+    WGPUShaderModule shader = gpu_create_shader_module(light_device, &shader_desc, "light cull");
+    
+    // Create bind group layout (uniform + lights + projected lights + tiles)
+    WGPUBindGroupLayoutEntry bgl_entries[] = {
+        {
+            .binding = 0,
+            .visibility = WGPUShaderStage_Compute,
+            .buffer = {
+                .type = WGPUBufferBindingType_Uniform,
+                .minBindingSize = sizeof(LightingUniforms),
+            },
+        },
+        {
+            .binding = 1,
+            .visibility = WGPUShaderStage_Compute,
+            .buffer = {.type = WGPUBufferBindingType_ReadOnlyStorage},
+        },
+        {
+            .binding = 2,
+            .visibility = WGPUShaderStage_Compute,
+            .buffer = {.type = WGPUBufferBindingType_Storage},
+        },
+        {
+            .binding = 3,
+            .visibility = WGPUShaderStage_Compute,
+            .buffer = {.type = WGPUBufferBindingType_Storage},
+        },
+    };
+    WGPUBindGroupLayoutDescriptor bgl_desc = {
+        .entryCount = 4,
+        .entries = bgl_entries,
+    };
+    cull_layout = gpu_create_bind_group_layout(light_device, &bgl_desc, "light cull");
+    
+    // Create pipelines: one entry point projects lights, the other bins them
+    WGPUPipelineLayoutDescriptor pl_desc = {
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &cull_layout,
+    };
+    WGPUPipelineLayout pipeline_layout = gpu_create_pipeline_layout(light_device, &pl_desc, "light cull");
+    
+    WGPUComputePipelineDescriptor project_desc = {
+        .layout = pipeline_layout,
+        .compute = {
+            .module = shader,
+            .entryPoint = {.data = "cs_project", .length = 10},
+        },
+    };
+    project_pipeline = gpu_create_compute_pipeline(light_device, &project_desc, "light cull");
+    
+    WGPUComputePipelineDescriptor bin_desc = {
+        .layout = pipeline_layout,
+        .compute = {
+            .module = shader,
+            .entryPoint = {.data = "cs_bin", .length = 6},
+        },
+    };
+    bin_pipeline = gpu_create_compute_pipeline(light_device, &bin_desc, "light cull");
+    
+    // Cleanup
+    gpu_release_shader_module(shader);
+    gpu_release_pipeline_layout(pipeline_layout);
+    
+    create_bind_groups();
+    printf("Light cull pipeline created\n");
+}
+
+void lighting_shutdown(void) {
+    gpu_release_compute_pipeline(project_pipeline);
+    gpu_release_compute_pipeline(bin_pipeline);
+    gpu_release_bind_group(cull_bind_group);
+    gpu_release_bind_group_layout(cull_layout);
+    gpu_release_bind_group(render_bind_group);
+    gpu_release_bind_group_layout(render_layout);
+    gpu_release_buffer(tile_buffer);
+    gpu_release_buffer(screen_light_buffer);
+    gpu_release_buffer(light_buffer);
+    gpu_release_buffer(light_uniform_buffer);
+    project_pipeline = NULL;
+    bin_pipeline = NULL;
+    cull_bind_group = NULL;
+    cull_layout = NULL;
+    render_bind_group = NULL;
+    render_layout = NULL;
+    tile_buffer = NULL;
+    screen_light_buffer = NULL;
+    light_buffer = NULL;
+    light_uniform_buffer = NULL;
+    grid_width = grid_height = 0;
+    light_count = 0;
+}
+
+void lighting_resize(int surface_width, int surface_height) {
+    if (!light_device) return;
+    int width = (surface_width + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE;
+    int height = (surface_height + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE;
+    if (width < 1) width = 1;
+    if (height < 1) height = 1;
+    if (tile_buffer && width == grid_width && height == grid_height) return;
+    
+    // New buffers start zeroed: every tile empty
+    gpu_release_buffer(tile_buffer);
+    WGPUBufferDescriptor tile_desc = {
+        .usage = WGPUBufferUsage_Storage,
+        .size = (uint64_t)width * height * LIGHT_TILE_WORDS * sizeof(uint32_t),
+    };
+    tile_buffer = gpu_create_buffer(light_device, &tile_desc, "lighting");
+    grid_width = width;
+    grid_height = height;
+    tiles_hold_lights = 0;
+    create_bind_groups();
+}
+
+void lighting_set_ambient(float r, float g, float b) {
+    ambient[0] = r;
+    ambient[1] = g;
+    ambient[2] = b;
+}
+
+void lighting_add(float x, float y, float radius, float r, float g, float b) {
+    if (light_count >= MAX_LIGHTS) {
+        lights_dropped++;
+        return;
+    }
+    Light* light = &lights[light_count++];
+    light->position[0] = x;
+    light->position[1] = y;
+    light->radius = radius;
+    light->padding = 0.0f;
+    light->color[0] = r;
+    light->color[1] = g;
+    light->color[2] = b;
+    light->color[3] = 1.0f;
+}
+
+void lighting_cull(WGPUCommandEncoder encoder, const float* view_proj, int width, int height) {
+    int count = light_count;
+    last_light_count = count;
+    light_count = 0;
+    if (!tile_buffer) return;
+    
+    // The scene may be drawn into part of the surface; bin only that part
+    uint32_t tiles_x = (uint32_t)(width + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE;
+    uint32_t tiles_y = (uint32_t)(height + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE;
+    if (tiles_x < 1) tiles_x = 1;
+    if (tiles_y < 1) tiles_y = 1;
+    if (tiles_x > (uint32_t)grid_width) tiles_x = (uint32_t)grid_width;
+    if (tiles_y > (uint32_t)grid_height) tiles_y = (uint32_t)grid_height;
+    
+    LightingUniforms uniforms = {0};
+    memcpy(uniforms.view_proj, view_proj, sizeof(uniforms.view_proj));
+    memcpy(uniforms.ambient, ambient, sizeof(uniforms.ambient));
+    uniforms.viewport[0] = (float)width;
+    uniforms.viewport[1] = (float)height;
+    uniforms.tile_count[0] = tiles_x;
+    uniforms.tile_count[1] = tiles_y;
+    uniforms.light_count = (uint32_t)count;
+    gpu_write_buffer(light_queue, light_uniform_buffer, 0, &uniforms, sizeof(uniforms));
+    
+    // Without the pass, or with no lights now or last frame, the tiles are
+    // already empty and every pixel gets the ambient color
+    if (!bin_pipeline || !cull_bind_group || (count == 0 && !tiles_hold_lights)) return;
+    if (count > 0) gpu_write_buffer(light_queue, light_buffer, 0, lights, count * sizeof(Light));
+    
+    // Project every light, then give each tile a workgroup that collects
+    // the lights overlapping it (dispatches in one pass run in order)
+    WGPUComputePassDescriptor pass_desc = {0};
+    WGPUComputePassEncoder pass = wgpuCommandEncoderBeginComputePass(encoder, &pass_desc);
+    wgpuComputePassEncoderSetBindGroup(pass, 0, cull_bind_group, 0, NULL);
+    if (count > 0) {
+        wgpuComputePassEncoderSetPipeline(pass, project_pipeline);
+        gpu_dispatch(pass, (count + LIGHT_CULL_WORKGROUP - 1) / LIGHT_CULL_WORKGROUP, 1, 1);
+    }
+    wgpuComputePassEncoderSetPipeline(pass, bin_pipeline);
+    gpu_dispatch(pass, tiles_x, tiles_y, 1);
+    wgpuComputePassEncoderEnd(pass);
+    wgpuComputePassEncoderRelease(pass);
+    tiles_hold_lights = count > 0;
+}
+
+WGPUBindGroupLayout lighting_bind_group_layout(void) {
+    return render_layout;
+}
+
+WGPUBindGroup lighting_bind_group(void) {
+    return render_bind_group;
+}
+
+void lighting_report(void) {
+    printf("Lighting: %d light(s) last frame, %d dropped over MAX_LIGHTS, %dx%d tile grid\n",
+           last_light_count, lights_dropped, grid_width, grid_height);
+}
@@ -0,0 +1,53 @@
+#ifndef LIGHTING_H
+#define LIGHTING_H
+
+#include <webgpu/webgpu.h>
+
+// Tiled 2D point lights
+// Lights are queued in world space every frame. A compute pass projects
+// them to scene pixels and bins them into LIGHT_TILE_SIZE square screen
+// tiles: each tile gets a count and a list of light indices in a storage
+// buffer. Lit fragment shaders bind group LIGHTING_BIND_GROUP and walk only
+// the list of the tile they fall in, so shading cost follows the lights that
+// actually touch a pixel rather than the total light count.
+
+#define MAX_LIGHTS 1024
+#define LIGHT_TILE_SIZE 16        // pixels; matches TILE_SIZE in the shaders
+#define LIGHT_TILE_WORDS 32       // per tile: the count, then up to 31 indices
+#define LIGHT_CULL_WORKGROUP 64   // matches @workgroup_size in light_cull.wgsl
+#define LIGHTING_BIND_GROUP 1     // group index of the lit shaders' bindings
+
+// Initialize lighting (after the WebGPU device is ready). The tile lists are
+// allocated by lighting_resize.
+void lighting_init(WGPUDevice device, WGPUQueue queue);
+
+// Create the light binning pipeline from WGSL source
+void lighting_create_pipeline(const char* shader_source);
+
+// Release all lighting objects
+void lighting_shutdown(void);
+
+// Reallocate the tile lists for a new surface size (in pixels)
+void lighting_resize(int surface_width, int surface_height);
+
+// Color every lit pixel starts from before lights are added (default white,
+// which leaves unlit scenes unchanged)
+void lighting_set_ambient(float r, float g, float b);
+
+// Queue a light for this frame; color is premultiplied by intensity. Lights
+// past MAX_LIGHTS are dropped.
+void lighting_add(float x, float y, float radius, float r, float g, float b);
+
+// Upload this frame's lights and record the binning pass for a scene of
+// width x height pixels; call before any pass of the frame begins. Clears
+// the queue.
+void lighting_cull(WGPUCommandEncoder encoder, const float* view_proj, int width, int height);
+
+// Layout and bind group of the tile lists for lit fragment shaders
+WGPUBindGroupLayout lighting_bind_group_layout(void);
+WGPUBindGroup lighting_bind_group(void);
+
+// Print last frame's light count
+void lighting_report(void);
+
+#endif // LIGHTING_H
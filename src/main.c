@@ -9,15 +9,94 @@
 #include "text.h"
 #include "math.h"
 #include "game.h"
+#include "sim_thread.h"
+#include "jobs.h"
+#include "platform.h"
+#include "arena.h"
+#include "archive.h"
+#include "sprite_batch.h"
+#include "lighting.h"
+#include "level.h"
+#include "stream.h"
+#include "sched.h"
+#include "render_layer.h"
+#include "resolution.h"
+#include "gpu_resources.h"
+#include "gpu_trace.h"
+#include "bench.h"
+
+// Job workers on the web, including the sim thread that submits work.
+// Must fit in PTHREAD_POOL_SIZE together with the sim thread itself and the
+// level decode thread.
+#define WEB_MAX_JOB_WORKERS 7
+
+// Drifting props scattered over the world at startup
+#define WORLD_PROP_COUNT 4000
 
 // Global state
 static double last_time = 0.0;
 
-// Canvas dimensions (updated dynamically)
+// Canvas dimensions in CSS pixels (updated dynamically); layout, text and
+// the camera work in these
 static int canvas_width = 800;
 static int canvas_height = 600;
 
+// Surface size in device pixels (CSS size times the capped pixel ratio)
+#define MAX_PIXEL_RATIO 2.0
+static int surface_width = 800;
+static int surface_height = 600;
+
+// Resize events only schedule a reconfigure; it happens once the size has
+// been stable for RESIZE_DEBOUNCE_MS, not on every event of a drag
+#define RESIZE_DEBOUNCE_MS 150.0
+static int resize_pending = 0;
+static double resize_time = 0.0;
+
+void configure_surface(void);
+
+// Scrolling view over the world, following the player
+static Camera camera;
+
+// Screen-space HUD, recorded only when game_update_hud reports a change
+static RenderLayer hud_layer;
+
+// Per-frame command budget (0 leaves a counter unlimited). Frames over it
+// are reported, up to FRAME_BUDGET_WARNINGS of them.
+#define FRAME_BUDGET_WARNINGS 10
+static const GpuFrameStats frame_budget = {
+    .passes = 4,
+    .draws = 64,
+    .vertices = 500000,
+    .buffer_bytes = 1024 * 1024,
+    .texture_bytes = 1024 * 1024,
+    .resources_created = 16,
+};
+static int budget_warnings = 0;
+
+// Idle tracking: a frame is only encoded and submitted if the simulation
+// changed (game_change_count), the HUD changed, or the surface was resized.
+// Input reaches the screen through the simulation, so a key press renders
+// on the next animation frame.
+static int idle_skip = 1;             // 0 renders every frame (benchmarks)
+static int frame_dirty = 1;           // force the next frame
+static uint64_t drawn_changes = 0;    // game_change_count of the last frame
+static uint32_t frames_rendered = 0;
+static uint32_t frames_skipped = 0;
+static double last_render_ms = 0.0;   // when the last frame was rendered
+static int rendered_last_frame = 0;   // frame times only span rendered frames
+
+// Benchmark runs (see render_bench): start of the previous frame
+static double bench_frame_start = 0.0;
+
+// Add the time since start to a benchmark phase; returns the current time
+static double bench_mark(BenchPhase phase, double start) {
+    double now = emscripten_get_now();
+    bench_phase(phase, now - start);
+    return now;
+}
+
 // WebGPU objects
+static WGPUInstance instance = NULL;
 static WGPUDevice device = NULL;
 static WGPUQueue queue = NULL;
 static WGPUSurface surface = NULL;
@@ -27,6 +106,9 @@ static WGPUBuffer uniform_buffer = NULL;
 static WGPUBindGroup bind_group = NULL;
 static WGPUTextureFormat surface_format = WGPUTextureFormat_BGRA8Unorm;
 
+// Player arrow mesh: 3 triangles around the shape (see init_webgpu)
+#define ARROW_MESH_VERTICES 9
+
 // Vertex data (position + uv)
 typedef struct {
     float position[2];
@@ -39,45 +121,38 @@ typedef struct {
     float color[4];       // RGBA color
 } Uniforms;
 
-// Shader source buffers (loaded from files)
+// Shader source buffers (loaded from files into the persistent arena)
 static char* sprite_shader_source = NULL;
 static char* text_shader_source = NULL;
-
-// Load a file from the virtual filesystem (preloaded by Emscripten)
-static char* load_file(const char* path) {
-    FILE* f = fopen(path, "rb");
-    if (!f) {
-        printf("Failed to open file: %s\n", path);
-        return NULL;
-    }
-    
-    fseek(f, 0, SEEK_END);
-    long size = ftell(f);
-    fseek(f, 0, SEEK_SET);
-    
-    char* buffer = (char*)malloc(size + 1);
-    if (!buffer) {
-        printf("Failed to allocate memory for file: %s\n", path);
-        fclose(f);
-        return NULL;
-    }
-    
-    size_t read = fread(buffer, 1, size, f);
-    buffer[read] = '\0';
-    fclose(f);
-    
-    printf("Loaded file: %s (%ld bytes)\n", path, size);
-    return buffer;
-}
+static char* sprite_batch_shader_source = NULL;
+static char* composite_shader_source = NULL;
+static char* upscale_shader_source = NULL;
+static char* sprite_cull_shader_source = NULL;
+static char* light_cull_shader_source = NULL;
 
 // Load all shader files
 static int load_shaders(void) {
-    sprite_shader_source = load_file("data/shaders/sprite.wgsl");
+    sprite_shader_source = assets_load(arena_persistent(), "data/shaders/sprite.wgsl", NULL);
     if (!sprite_shader_source) return 1;
     
-    text_shader_source = load_file("data/shaders/text.wgsl");
+    text_shader_source = assets_load(arena_persistent(), "data/shaders/text.wgsl", NULL);
     if (!text_shader_source) return 2;
     
+    sprite_batch_shader_source = assets_load(arena_persistent(), "data/shaders/sprite_batch.wgsl", NULL);
+    if (!sprite_batch_shader_source) return 3;
+    
+    composite_shader_source = assets_load(arena_persistent(), "data/shaders/composite.wgsl", NULL);
+    if (!composite_shader_source) return 4;
+    
+    upscale_shader_source = assets_load(arena_persistent(), "data/shaders/upscale.wgsl", NULL);
+    if (!upscale_shader_source) return 5;
+    
+    sprite_cull_shader_source = assets_load(arena_persistent(), "data/shaders/sprite_cull.wgsl", NULL);
+    if (!sprite_cull_shader_source) return 6;
+    
+    light_cull_shader_source = assets_load(arena_persistent(), "data/shaders/light_cull.wgsl", NULL);
+    if (!light_cull_shader_source) return 7;
+    
     return 0;
 }
 
@@ -85,39 +160,97 @@ static int load_shaders(void) {
 void render_frame(void) {
     if (!device) return;
     
+    // Everything allocated for the previous frame is dead now
+    arena_reset(arena_frame());
+    
+    // Apply a resize once the events have settled
+    double now_ms = emscripten_get_now();
+    if (resize_pending && now_ms - resize_time >= RESIZE_DEBOUNCE_MS) {
+        resize_pending = 0;
+        configure_surface();
+    }
+    
+#ifdef GAME_THREADED
+    // Simulation ticks on its own thread; render the latest completed state
+    // without ever waiting for it
+    const GameSnapshot* snapshot = sim_thread_latest();
+    const Sprite* sprite = &snapshot->sprite;
+    const Sprite* entities = snapshot->entities;
+    int entity_count = snapshot->entity_count;
+    uint64_t changes = snapshot->changes;
+    double play_time = snapshot->play_time;
+#else
     // Get current time and calculate delta
-    double current_time = emscripten_get_now() / 1000.0;
+    double current_time = now_ms / 1000.0;
     float dt = (float)(current_time - last_time);
     if (dt > 0.1f) dt = 0.1f;  // Cap delta time
     last_time = current_time;
     
-    // Update game state
-    game_update(dt, canvas_width, canvas_height);
+    // Update game state, consuming input that arrived during this frame
+    game_set_input_clock(current_time * 1000.0 - dt * 1000.0);
+    game_update(dt, WORLD_WIDTH, WORLD_HEIGHT);
     
     // Get sprite for rendering
     const Sprite* sprite = game_get_sprite();
+    const Sprite* entities = game_get_entities();
+    int entity_count = game_entity_count();
+    uint64_t changes = game_change_count();
+    double play_time = game_play_time();
+#endif
+    double phase_start = bench_mark(BENCH_PHASE_SIMULATE, now_ms);
+    
+    RenderContext render_ctx = {
+        .canvas_width = canvas_width,
+        .canvas_height = canvas_height,
+        .sprite = sprite,
+        .entities = entities,
+        .entity_count = entity_count,
+        .camera = &camera,
+        .time = now_ms / 1000.0,
+        .play_time = play_time,
+    };
+    int hud_changed = game_update_hud(&render_ctx);
+    phase_start = bench_mark(BENCH_PHASE_HUD, phase_start);
+    
+    // Stream level regions around last frame's view; a region that just
+    // finished uploading has to be shown even if nothing else changed
+    if (level_update(&camera)) frame_dirty = 1;
+    
+    // Nothing moved, the HUD is unchanged and the surface was not resized:
+    // the last presented frame is still correct, so encode nothing. The
+    // canvas keeps showing it until a texture is acquired again.
+    if (idle_skip && !frame_dirty && !hud_changed && changes == drawn_changes) {
+        frames_skipped++;
+        rendered_last_frame = 0;
+        return;
+    }
+    
+    // Steer the render scale by the time since the previous rendered frame
+    if (rendered_last_frame) resolution_frame_time(now_ms - last_render_ms);
+    last_render_ms = now_ms;
+    
+    // Re-record the HUD only if it changed; otherwise last frame's texture
+    // is composited as is
+    if (hud_changed) render_layer_mark_dirty(&hud_layer);
     
     // Update uniforms
     Uniforms uniforms;
     
-    // Build transformation matrix: projection * translation * rotation * scale
-    // Using perspective projection for 3D rendering
-    float proj[16], trans[16], rot[16], scale[16];
-    float temp1[16], temp2[16];
+    // Follow the player, then build this frame's view and visible rect
+    camera_look_at(&camera, sprite->x, sprite->y);
+    camera_update(&camera);
     
-    // Perspective projection: camera_dist controls FOV strength
-    // Objects at z=0 appear at same size as orthographic
+    // Build transformation matrix: view_proj * translation * rotation * scale
     // Objects with z<0 appear smaller (farther from camera)
-    const float camera_dist = 500.0f;
-    const float far_plane = 1000.0f;
-    mat4_perspective(proj, (float)canvas_width, (float)canvas_height, camera_dist, far_plane);
+    float trans[16], rot[16], scale[16];
+    float temp1[16], temp2[16];
     mat4_translate_3d(trans, sprite->x, sprite->y, sprite->z);
     mat4_rotate_z(rot, -sprite->angle);  // Negative because we rotate counter-clockwise
     mat4_scale(scale, SPRITE_SIZE, SPRITE_SIZE);
     
     mat4_multiply(temp1, rot, scale);
     mat4_multiply(temp2, trans, temp1);
-    mat4_multiply(uniforms.transform, proj, temp2);
+    mat4_multiply(uniforms.transform, camera.view_proj, temp2);
     
     // Sprite color (bright green)
     uniforms.color[0] = 0.2f;
@@ -125,7 +258,7 @@ void render_frame(void) {
     uniforms.color[2] = 0.3f;
     uniforms.color[3] = 1.0f;
     
-    wgpuQueueWriteBuffer(queue, uniform_buffer, 0, &uniforms, sizeof(Uniforms));
+    gpu_write_buffer(queue, uniform_buffer, 0, &uniforms, sizeof(Uniforms));
     
     // Get current texture view
     WGPUSurfaceTexture surface_texture;
@@ -133,6 +266,7 @@ void render_frame(void) {
     
     if (surface_texture.status != WGPUSurfaceGetCurrentTextureStatus_SuccessOptimal &&
         surface_texture.status != WGPUSurfaceGetCurrentTextureStatus_SuccessSuboptimal) {
+        frame_dirty = 1;  // try again next frame
         return;
     }
     
@@ -145,19 +279,65 @@ void render_frame(void) {
         .arrayLayerCount = 1,
         .aspect = WGPUTextureAspect_All,
     };
-    WGPUTextureView view = wgpuTextureCreateView(surface_texture.texture, &view_desc);
+    WGPUTextureView view = gpu_create_view(surface_texture.texture, &view_desc, "surface");
     
     // Create command encoder
     WGPUCommandEncoderDescriptor enc_desc = {};
     WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, &enc_desc);
     
-    // Begin render pass
+    // Cull entities and bin this frame's lights on the GPU before the
+    // passes that draw them
+    game_record_compute(&render_ctx, encoder);
+    int scene_width, scene_height;
+    resolution_scene_size(&scene_width, &scene_height);
+    lighting_cull(encoder, camera.view_proj, scene_width, scene_height);
+    
+    phase_start = bench_mark(BENCH_PHASE_RECORD, phase_start);
+    WGPURenderPassEncoder hud_pass = render_layer_begin(&hud_layer, encoder);
+    if (hud_pass) {
+        render_ctx.pass = hud_pass;
+        game_render_hud(&render_ctx);
+        render_layer_end(&hud_layer, hud_pass);
+    }
+    phase_start = bench_mark(BENCH_PHASE_HUD, phase_start);
+    
+    // Draw the world into the scene target at the current render scale
+    WGPUColor background = {0.1f, 0.1f, 0.15f, 1.0f};  // Dark blue-gray background
+    WGPURenderPassEncoder pass = resolution_begin_scene(encoder, background);
+    if (!pass) {
+        wgpuCommandEncoderRelease(encoder);
+        gpu_release_view(view);
+        wgpuTextureRelease(surface_texture.texture);
+        return;
+    }
+    
+    // Ground first, then the player and entities over it
+    level_draw(pass, &camera);
+    
+    // Draw sprite (the quad's corners are within SPRITE_SIZE of its center
+    // at any rotation)
+    if (camera_box_visible(&camera, sprite->x, sprite->y, sprite->z, SPRITE_SIZE, SPRITE_SIZE)) {
+        gpu_set_pipeline(pass, pipeline);
+        gpu_set_bind_group(pass, 0, bind_group);
+        gpu_set_bind_group(pass, LIGHTING_BIND_GROUP, lighting_bind_group());
+        gpu_set_vertex_buffer(pass, 0, vertex_buffer, 0, ARROW_MESH_VERTICES * sizeof(Vertex));
+        gpu_draw(pass, ARROW_MESH_VERTICES, 1);
+    }
+    
+    // Render game objects (text, etc.)
+    render_ctx.pass = pass;
+    game_render(&render_ctx);
+    
+    wgpuRenderPassEncoderEnd(pass);
+    
+    // Stretch the scene over the surface, then put the full-resolution HUD
+    // on top
     WGPURenderPassColorAttachment color_attachment = {
         .view = view,
         .depthSlice = WGPU_DEPTH_SLICE_UNDEFINED,  // Required for non-3D textures
         .loadOp = WGPULoadOp_Clear,
         .storeOp = WGPUStoreOp_Store,
-        .clearValue = {0.1f, 0.1f, 0.15f, 1.0f},  // Dark blue-gray background
+        .clearValue = background,
     };
     
     WGPURenderPassDescriptor pass_desc = {
@@ -165,39 +345,129 @@ void render_frame(void) {
         .colorAttachments = &color_attachment,
     };
     
-    WGPURenderPassEncoder pass = wgpuCommandEncoderBeginRenderPass(encoder, &pass_desc);
-    
-    // Draw sprite
-    wgpuRenderPassEncoderSetPipeline(pass, pipeline);
-    wgpuRenderPassEncoderSetBindGroup(pass, 0, bind_group, 0, NULL);
-    wgpuRenderPassEncoderSetVertexBuffer(pass, 0, vertex_buffer, 0, 6 * sizeof(Vertex));
-    wgpuRenderPassEncoderDraw(pass, 6, 1, 0, 0);
-    
-    // Render game objects (text, etc.)
-    RenderContext render_ctx = {
-        .pass = pass,
-        .canvas_width = canvas_width,
-        .canvas_height = canvas_height,
-    };
-    game_render(&render_ctx);
-    
-    wgpuRenderPassEncoderEnd(pass);
+    WGPURenderPassEncoder surface_pass = gpu_begin_pass(encoder, &pass_desc);
+    resolution_upscale(surface_pass);
+    render_layer_composite(&hud_layer, surface_pass);
+    wgpuRenderPassEncoderEnd(surface_pass);
+    phase_start = bench_mark(BENCH_PHASE_RECORD, phase_start);
     
     // Submit commands
     WGPUCommandBufferDescriptor cmd_desc = {};
     WGPUCommandBuffer commands = wgpuCommandEncoderFinish(encoder, &cmd_desc);
     wgpuQueueSubmit(queue, 1, &commands);
+    resolution_submitted();
+    bench_mark(BENCH_PHASE_SUBMIT, phase_start);
+    
+    if (bench_active()) {
+        if (bench_end_frame(now_ms - bench_frame_start)) {
+            bench_print_json("web");
+            idle_skip = 1;
+        }
+        bench_frame_start = now_ms;
+    }
+    
+    gpu_trace_end_frame();
+    if (budget_warnings < FRAME_BUDGET_WARNINGS && gpu_trace_check_budget(&frame_budget)) budget_warnings++;
+    
+    frames_rendered++;
+    rendered_last_frame = 1;
+    frame_dirty = 0;
+    drawn_changes = changes;
     
     // Note: wgpuSurfacePresent is not needed with Emscripten - presentation is automatic
     
     // Cleanup
     wgpuCommandBufferRelease(commands);
+    wgpuRenderPassEncoderRelease(surface_pass);
     wgpuRenderPassEncoderRelease(pass);
     wgpuCommandEncoderRelease(encoder);
-    wgpuTextureViewRelease(view);
+    gpu_release_view(view);
     wgpuTextureRelease(surface_texture.texture);
 }
 
+// Print render statistics (called from JavaScript)
+EMSCRIPTEN_KEEPALIVE
+void render_report(void) {
+    uint32_t total = frames_rendered + frames_skipped;
+    printf("Frames: %u rendered, %u skipped as unchanged (%.1f%% idle)\n",
+           frames_rendered, frames_skipped, total ? 100.0 * frames_skipped / total : 0.0);
+    render_layer_report(&hud_layer);
+    resolution_report();
+    lighting_report();
+    stream_report();
+    sched_report();
+    gpu_trace_report();
+    gpu_report();
+}
+
+// Stop rendering, release every GPU object and list any that are left
+// (called from JavaScript when the page goes away)
+EMSCRIPTEN_KEEPALIVE
+void render_shutdown(void) {
+    if (!device) return;
+    emscripten_cancel_main_loop();
+    
+#ifdef GAME_THREADED
+    sim_thread_stop();
+    job_system_shutdown();
+#endif
+    
+    game_release_hud();
+    render_layer_release(&hud_layer);
+    render_layers_shutdown();
+    resolution_shutdown();
+    level_close();
+    sprite_batch_shutdown();
+    lighting_shutdown();
+    text_shutdown();
+    
+    gpu_release_render_pipeline(pipeline);
+    gpu_release_bind_group(bind_group);
+    gpu_release_buffer(vertex_buffer);
+    gpu_release_buffer(uniform_buffer);
+    pipeline = NULL;
+    bind_group = NULL;
+    vertex_buffer = NULL;
+    uniform_buffer = NULL;
+    
+    wgpuSurfaceUnconfigure(surface);
+    wgpuSurfaceRelease(surface);
+    wgpuQueueRelease(queue);
+    wgpuDeviceRelease(device);
+    wgpuInstanceRelease(instance);
+    surface = NULL;
+    queue = NULL;
+    device = NULL;
+    instance = NULL;
+    
+    gpu_report_leaks();
+}
+
+// Lock the render scale (e.g. for benchmarks), or 0 to let it adapt
+// (called from JavaScript)
+EMSCRIPTEN_KEEPALIVE
+void render_set_resolution_scale(float scale) {
+    resolution_lock(scale);
+    frame_dirty = 1;
+}
+
+// Run the stress-scene benchmark instead of the normal scene (called from
+// JavaScript before WebGPU is ready; negative counts take the defaults).
+// Every frame is rendered until the results are printed.
+EMSCRIPTEN_KEEPALIVE
+void render_bench(int sprites, int labels, int frames, int seed) {
+    BenchConfig config = {sprites, labels, frames, (uint32_t)seed};
+    bench_start(&config);
+    idle_skip = 0;
+}
+
+// Turn skipping of unchanged frames on or off (called from JavaScript)
+EMSCRIPTEN_KEEPALIVE
+void render_set_idle_skip(int enabled) {
+    idle_skip = enabled;
+    frame_dirty = 1;
+}
+
 // Get current canvas size
 void get_canvas_size(int* width, int* height) {
     double w, h;
@@ -216,21 +486,36 @@ void configure_surface(void) {
     if (canvas_width < 1) canvas_width = 1;
     if (canvas_height < 1) canvas_height = 1;
     
+    // Back the canvas with device pixels so HUD text stays sharp on high-DPI
+    // screens; the world is scaled separately by the resolution controller
+    double pixel_ratio = emscripten_get_device_pixel_ratio();
+    if (pixel_ratio < 1.0) pixel_ratio = 1.0;
+    if (pixel_ratio > MAX_PIXEL_RATIO) pixel_ratio = MAX_PIXEL_RATIO;
+    surface_width = (int)(canvas_width * pixel_ratio + 0.5);
+    surface_height = (int)(canvas_height * pixel_ratio + 0.5);
+    emscripten_set_canvas_element_size("#canvas", surface_width, surface_height);
+    
     WGPUSurfaceConfiguration config = {
         .device = device,
         .format = surface_format,
         .usage = WGPUTextureUsage_RenderAttachment,
         .alphaMode = WGPUCompositeAlphaMode_Opaque,
-        .width = (uint32_t)canvas_width,
-        .height = (uint32_t)canvas_height,
+        .width = (uint32_t)surface_width,
+        .height = (uint32_t)surface_height,
         .presentMode = WGPUPresentMode_Fifo,
     };
     wgpuSurfaceConfigure(surface, &config);
     
-    // Update text rendering canvas size
+    // Text and the camera lay out in CSS pixels; offscreen targets match
+    // the surface
     text_set_canvas_size(canvas_width, canvas_height);
+    camera_set_viewport(&camera, canvas_width, canvas_height);
+    render_layer_resize(&hud_layer, surface_width, surface_height);
+    resolution_resize(surface_width, surface_height);
+    lighting_resize(surface_width, surface_height);
+    frame_dirty = 1;
     
-    printf("Surface configured: %dx%d\n", canvas_width, canvas_height);
+    printf("Surface configured: %dx%d (%dx%d CSS px)\n", surface_width, surface_height, canvas_width, canvas_height);
 }
 
 // Resize callback
@@ -238,10 +523,24 @@ EM_BOOL on_canvas_resize(int event_type, const EmscriptenUiEvent* ui_event, void
     (void)event_type;
     (void)ui_event;
     (void)user_data;
-    configure_surface();
+    resize_pending = 1;
+    resize_time = emscripten_get_now();
     return EM_TRUE;
 }
 
+// Scatter props over the whole world (fixed seed, so every run matches)
+static void spawn_world_props(void) {
+    uint32_t seed = 12345;
+    for (int i = 0; i < WORLD_PROP_COUNT; i++) {
+        float r[4];
+        for (int k = 0; k < 4; k++) {
+            seed = seed * 1664525u + 1013904223u;
+            r[k] = (seed >> 8) / 16777216.0f;
+        }
+        game_spawn_entity(r[0] * WORLD_WIDTH, r[1] * WORLD_HEIGHT, r[2] * 2.0f * PI, 20.0f + r[3] * 60.0f);
+    }
+}
+
 // Initialize WebGPU
 void init_webgpu(WGPUDevice dev) {
     device = dev;
@@ -257,6 +556,7 @@ void init_webgpu(WGPUDevice dev) {
     
     // Get initial canvas size
     get_canvas_size(&canvas_width, &canvas_height);
+    camera_init(&camera, canvas_width, canvas_height, WORLD_WIDTH, WORLD_HEIGHT);
     
     // Create surface from canvas
     WGPUEmscriptenSurfaceSourceCanvasHTMLSelector canvas_source = {
@@ -267,7 +567,6 @@ void init_webgpu(WGPUDevice dev) {
         .nextInChain = (WGPUChainedStruct*)&canvas_source,
     };
     
-    WGPUInstance instance = wgpuCreateInstance(NULL);
     surface = wgpuInstanceCreateSurface(instance, &surface_desc);
     
     // Configure surface with actual canvas size
@@ -276,6 +575,12 @@ void init_webgpu(WGPUDevice dev) {
     // Register resize callback
     emscripten_set_resize_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, NULL, EM_FALSE, on_canvas_resize);
     
+    // Initialize tiled lighting first: the sprite pipelines bind its tile
+    // lists
+    lighting_init(device, queue);
+    lighting_create_pipeline(light_cull_shader_source);
+    lighting_resize(surface_width, surface_height);
+    
     // Create shader module
     WGPUShaderSourceWGSL wgsl_source = {
         .chain = {.sType = WGPUSType_ShaderSourceWGSL},
@@ -284,16 +589,20 @@ void init_webgpu(WGPUDevice dev) {
     WGPUShaderModuleDescriptor shader_desc = {
         .nextInChain = (WGPUChainedStruct*)&wgsl_source,
     };
-    WGPUShaderModule shader = wgpuDeviceCreateShaderModule(device, &shader_desc);
-    
-    // Create vertex buffer
-    Vertex vertices[] = {
-        {{-0.5f, -0.5f}, {0.0f, 0.0f}},
-        {{ 0.5f, -0.5f}, {1.0f, 0.0f}},
-        {{ 0.5f,  0.5f}, {1.0f, 1.0f}},
-        {{-0.5f, -0.5f}, {0.0f, 0.0f}},
-        {{ 0.5f,  0.5f}, {1.0f, 1.0f}},
-        {{-0.5f,  0.5f}, {0.0f, 1.0f}},
+    WGPUShaderModule shader = gpu_create_shader_module(device, &shader_desc, "main");
+    
+    // Create vertex buffer: a fan over the convex hull of the arrow that
+    // sprite.wgsl draws, so the transparent 68% of the quad is never shaded
+    Vertex vertices[ARROW_MESH_VERTICES] = {
+        {{-0.15f, -0.3f}, {0.35f, 0.2f}},
+        {{ 0.15f, -0.3f}, {0.65f, 0.2f}},
+        {{ 0.3f,   0.2f}, {0.8f,  0.7f}},
+        {{-0.15f, -0.3f}, {0.35f, 0.2f}},
+        {{ 0.3f,   0.2f}, {0.8f,  0.7f}},
+        {{ 0.0f,   0.5f}, {0.5f,  1.0f}},
+        {{-0.15f, -0.3f}, {0.35f, 0.2f}},
+        {{ 0.0f,   0.5f}, {0.5f,  1.0f}},
+        {{-0.3f,   0.2f}, {0.2f,  0.7f}},
     };
     
     WGPUBufferDescriptor vb_desc = {
@@ -301,7 +610,7 @@ void init_webgpu(WGPUDevice dev) {
         .size = sizeof(vertices),
         .mappedAtCreation = true,
     };
-    vertex_buffer = wgpuDeviceCreateBuffer(device, &vb_desc);
+    vertex_buffer = gpu_create_buffer(device, &vb_desc, "main");
     memcpy(wgpuBufferGetMappedRange(vertex_buffer, 0, sizeof(vertices)), vertices, sizeof(vertices));
     wgpuBufferUnmap(vertex_buffer);
     
@@ -310,7 +619,7 @@ void init_webgpu(WGPUDevice dev) {
         .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
         .size = sizeof(Uniforms),
     };
-    uniform_buffer = wgpuDeviceCreateBuffer(device, &ub_desc);
+    uniform_buffer = gpu_create_buffer(device, &ub_desc, "main");
     
     // Create bind group layout
     WGPUBindGroupLayoutEntry bgl_entry = {
@@ -325,7 +634,7 @@ void init_webgpu(WGPUDevice dev) {
         .entryCount = 1,
         .entries = &bgl_entry,
     };
-    WGPUBindGroupLayout bind_group_layout = wgpuDeviceCreateBindGroupLayout(device, &bgl_desc);
+    WGPUBindGroupLayout bind_group_layout = gpu_create_bind_group_layout(device, &bgl_desc, "main");
     
     // Create bind group
     WGPUBindGroupEntry bg_entry = {
@@ -339,14 +648,15 @@ void init_webgpu(WGPUDevice dev) {
         .entryCount = 1,
         .entries = &bg_entry,
     };
-    bind_group = wgpuDeviceCreateBindGroup(device, &bg_desc);
+    bind_group = gpu_create_bind_group(device, &bg_desc, "main");
     
-    // Create pipeline layout
+    // Create pipeline layout (the arrow is lit through group 1)
+    WGPUBindGroupLayout layouts[] = {bind_group_layout, lighting_bind_group_layout()};
     WGPUPipelineLayoutDescriptor pl_desc = {
-        .bindGroupLayoutCount = 1,
-        .bindGroupLayouts = &bind_group_layout,
+        .bindGroupLayoutCount = 2,
+        .bindGroupLayouts = layouts,
     };
-    WGPUPipelineLayout pipeline_layout = wgpuDeviceCreatePipelineLayout(device, &pl_desc);
+    WGPUPipelineLayout pipeline_layout = gpu_create_pipeline_layout(device, &pl_desc, "main");
     
     // Create render pipeline
     WGPUVertexAttribute attrs[] = {
@@ -405,17 +715,18 @@ void init_webgpu(WGPUDevice dev) {
             .mask = 0xFFFFFFFF,
         },
     };
-    pipeline = wgpuDeviceCreateRenderPipeline(device, &rp_desc);
+    pipeline = gpu_create_render_pipeline(device, &rp_desc, "main");
     
     // Cleanup
-    wgpuShaderModuleRelease(shader);
-    wgpuBindGroupLayoutRelease(bind_group_layout);
-    wgpuPipelineLayoutRelease(pipeline_layout);
+    gpu_release_shader_module(shader);
+    gpu_release_bind_group_layout(bind_group_layout);
+    gpu_release_pipeline_layout(pipeline_layout);
     
     // Initialize time
     last_time = emscripten_get_now() / 1000.0;
     
     printf("WebGPU initialization complete\n");
+    memory_report();
     
     // Initialize text rendering system
     text_init(device, queue, surface_format);
@@ -423,8 +734,46 @@ void init_webgpu(WGPUDevice dev) {
     text_load_font_file("data/fonts/mikado-medium-f00f2383.fnt");
     text_create_pipeline(text_shader_source);
     
+    // Initialize batched sprite rendering
+    sprite_batch_init(device, queue, surface_format);
+    if (sprite_batch_load_atlas("data/sprites.atlas") == 0) {
+        sprite_batch_create_pipeline(sprite_batch_shader_source);
+        sprite_batch_create_cull_pipeline(sprite_cull_shader_source);
+    }
+    
+    // Level regions stream in around the camera from here on
+    if (level_open(device, queue, "level.pak")) {
+        printf("No streamed level\n");
+    }
+    assets_report();
+    
+    // Initialize retained layers and the scene target (surface sized,
+    // recreated on resize)
+    render_layers_init(device, surface_format);
+    render_layers_create_pipeline(composite_shader_source);
+    render_layer_init(&hud_layer, "hud", surface_width, surface_height);
+    resolution_init(device, queue, surface_format);
+    resolution_create_pipeline(upscale_shader_source);
+    resolution_resize(surface_width, surface_height);
+    
     // Initialize game state
-    game_init(canvas_width, canvas_height);
+    game_init(WORLD_WIDTH, WORLD_HEIGHT);
+    if (bench_active()) {
+        bench_spawn(WORLD_WIDTH, WORLD_HEIGHT);
+        game_set_label_count(bench_config()->labels);
+    } else {
+        spawn_world_props();
+    }
+    
+#ifdef GAME_THREADED
+    // Spread per-frame entity work across cores; the sim thread is worker 0
+    int job_workers = platform_cpu_count() - 1;
+    if (job_workers > WEB_MAX_JOB_WORKERS) job_workers = WEB_MAX_JOB_WORKERS;
+    job_system_init(job_workers);
+    
+    // Move simulation off the browser main thread
+    sim_thread_start(WORLD_WIDTH, WORLD_HEIGHT);
+#endif
     
     // Start render loop
     emscripten_set_main_loop(render_frame, 0, 0);
@@ -460,8 +809,19 @@ void request_adapter_callback(WGPURequestAdapterStatus status, WGPUAdapter adapt
 int main() {
     printf("Starting WebGPU Sprite Demo\n");
     
-    // Request adapter
-    WGPUInstance instance = wgpuCreateInstance(NULL);
+    // Reserve all arenas up front so the heap never grows mid-game
+    if (memory_init()) {
+        printf("Failed to reserve memory arenas!\n");
+        return 1;
+    }
+    
+    // Prefer the packed asset archive; ASSETS=preload builds ship loose files
+    if (assets_mount("game.pak")) {
+        printf("No asset archive, using loose files\n");
+    }
+    
+    // Request adapter (the instance is kept for the surface)
+    instance = wgpuCreateInstance(NULL);
     WGPURequestAdapterOptions options = {};
     WGPURequestAdapterCallbackInfo callback_info = {
         .mode = WGPUCallbackMode_AllowSpontaneous,
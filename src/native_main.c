@@ -0,0 +1,1030 @@
+// Headless native entry point (Linux)
+// Runs the same simulation code as the web build without a WebGPU device
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "anim.h"
+#include "archive.h"
+#include "arena.h"
+#include "bench.h"
+#include "collide.h"
+#include "game.h"
+#include "gpu_headless.h"
+#include "gpu_trace.h"
+#include "jobs.h"
+#include "path.h"
+#include "platform.h"
+#include "replay.h"
+#include "sched.h"
+#include "state_ring.h"
+#include "sim_thread.h"
+#include "stream.h"
+#include "text.h"
+
+#define NATIVE_CANVAS_WIDTH 800
+#define NATIVE_CANVAS_HEIGHT 600
+#define BENCH_DEFAULT_ENTITIES 100000
+#define BENCH_WARMUP_TICKS 30
+#define BENCH_TICKS 300
+#define DEMO_DEFAULT_TICKS 36000  // five minutes at 120 Hz
+#define DEMO_ENTITIES 2000
+#define SNAPSHOT_RING_SLOTS 64
+#define SNAPSHOT_BENCH_SAVES 512
+#define ASSET_BENCH_ITERATIONS 50
+#define STREAM_BENCH_FRAMES 300
+#define STREAM_BENCH_WARMUP 60       // frames for the first regions to arrive
+#define STREAM_BENCH_SPEED 1200.0f   // camera speed in world units per second
+#define ANIM_BENCH_PLAYERS 10000
+#define ANIM_BENCH_TICKS 1000
+#define ANIM_BENCH_DT (1.0f / 60.0f)
+#define PATH_BENCH_SIZE 1024
+#define PATH_BENCH_QUERIES 2000
+#define PATH_BENCH_FILL 0.3f      // fraction of the map covered by obstacles
+#define PATH_BENCH_GOALS 16       // shared targets in the cached run
+#define PATH_BENCH_SQUAD 8        // agents heading out together per leader
+#define SCHED_BENCH_ENTITIES 100000
+#define SCHED_BENCH_BEFORE 1000       // entities before the spike
+#define SCHED_BENCH_TICKS 120         // ticks timed before and after the spike
+#define SCHED_BENCH_GRID 256          // path grid for the planning system
+#define SCHED_BENCH_PLANNERS 256      // entities per agent that plans paths
+#define SCHED_BENCH_PLAN_BUDGET_MS 0.75
+#define SCHED_BENCH_TICK_BUDGET_MS 2.0
+#define OBB_BENCH_PAIRS 100000
+#define OBB_BENCH_ITERATIONS 50
+#define GPU_CHECK_LABELS 1000
+#define GPU_CHECK_FONT "data/fonts/mikado-medium-f00f2383.fnt"
+#define GPU_CHECK_SHADER "data/shaders/text.wgsl"
+
+static void print_usage(const char* exe) {
+    printf("Usage: %s [--seconds N] [--bench-jobs [ENTITIES]]\n", exe);
+    printf("  --seconds N            run the threaded simulation for N seconds (default 2)\n");
+    printf("  --bench-jobs [N]       time game_update with N entities at 1/2/4/8 workers\n");
+    printf("  --record-demo FILE [T] record a scripted T-tick session to FILE\n");
+    printf("  --replay FILE          replay FILE headlessly, print ticks/s and state hash\n");
+    printf("  --bench-snapshot [N]   time state ring save/restore with N entities\n");
+    printf("  --bench-scene [N] [F]  time F frames of a stress scene with N sprites (JSON)\n");
+    printf("  --bench-assets PAK FILE@NAME...\n");
+    printf("                         compare loading assets from PAK vs loose files\n");
+    printf("  --bench-stream LEVEL [F]\n");
+    printf("                         fly a camera over LEVEL for F frames, time streaming\n");
+    printf("  --bench-anim [N]       time a tick of N sprite animations, batched vs per-entity\n");
+    printf("  --bench-path [S] [Q]   time Q path queries on a seeded SxS obstacle map\n");
+    printf("  --bench-sched [N]      tick times when entities spike to N, time-sliced vs not\n");
+    printf("  --bench-obb [P]        rotated-box pairs per second, SIMD batches vs scalar\n");
+    printf("  --check-gpu            check text draw and upload budgets on the no-GPU backend\n");
+}
+
+// Small deterministic PRNG so benchmark runs are comparable
+static uint32_t bench_rng_state = 12345;
+static float bench_rand(void) {
+    bench_rng_state = bench_rng_state * 1664525u + 1013904223u;
+    return (bench_rng_state >> 8) / 16777216.0f;
+}
+
+// Scaling benchmark: same game_update workload at increasing worker counts.
+// Time slicing is off so every tick moves and thinks for every entity.
+static int run_job_bench(int entity_count) {
+    static const int worker_counts[] = {1, 2, 4, 8};
+    const float dt = 1.0f / 120.0f;
+    double base_ms = 0.0;
+    
+    printf("game_update scaling: %d entities, %d ticks, %d CPUs, full update (no time slicing)\n",
+           entity_count, BENCH_TICKS, platform_cpu_count());
+    printf("workers  ms/tick  speedup\n");
+    
+    for (size_t w = 0; w < sizeof(worker_counts) / sizeof(worker_counts[0]); w++) {
+        game_init(NATIVE_CANVAS_WIDTH, NATIVE_CANVAS_HEIGHT);
+        game_set_time_slicing(0);
+        bench_rng_state = 12345;
+        for (int i = 0; i < entity_count; i++) {
+            game_spawn_entity(bench_rand() * NATIVE_CANVAS_WIDTH, bench_rand() * NATIVE_CANVAS_HEIGHT,
+                              bench_rand() * 6.2831853f, 50.0f + bench_rand() * 150.0f);
+        }
+        
+        job_system_init(worker_counts[w]);
+        for (int i = 0; i < BENCH_WARMUP_TICKS; i++) {
+            game_update(dt, NATIVE_CANVAS_WIDTH, NATIVE_CANVAS_HEIGHT);
+        }
+        
+        double start = platform_now_ms();
+        for (int i = 0; i < BENCH_TICKS; i++) {
+            game_update(dt, NATIVE_CANVAS_WIDTH, NATIVE_CANVAS_HEIGHT);
+        }
+        double ms = (platform_now_ms() - start) / BENCH_TICKS;
+        job_system_shutdown();
+        
+        if (w == 0) base_ms = ms;
+        printf("%7d  %7.3f  %6.2fx\n", worker_counts[w], ms, base_ms / ms);
+    }
+    return 0;
+}
+
+// Stress scene: the frame loop the web build runs without a device, one
+// fixed 60 Hz game_update plus the snapshot copy a renderer would take.
+// Labels are only drawn by the web build.
+static int run_scene_bench(int sprite_count, int frames) {
+    static GameSnapshot snapshot;
+    const float dt = 1.0f / 60.0f;
+    BenchConfig config = {sprite_count, 0, frames, BENCH_DEFAULT_SEED};
+    
+    job_system_init(platform_cpu_count());
+    game_init(WORLD_WIDTH, WORLD_HEIGHT);
+    bench_start(&config);
+    bench_spawn(WORLD_WIDTH, WORLD_HEIGHT);
+    
+    double frame_start = platform_now_ms();
+    for (;;) {
+        double t = platform_now_ms();
+        game_update(dt, WORLD_WIDTH, WORLD_HEIGHT);
+        double now = platform_now_ms();
+        bench_phase(BENCH_PHASE_SIMULATE, now - t);
+        
+        t = now;
+        game_snapshot(&snapshot);
+        now = platform_now_ms();
+        bench_phase(BENCH_PHASE_SNAPSHOT, now - t);
+        
+        int done = bench_end_frame(now - frame_start);
+        frame_start = now;
+        if (done) break;
+    }
+    
+    job_system_shutdown();
+    bench_print_json("native");
+    return 0;
+}
+
+// Run the sim on its worker thread while this thread plays the renderer:
+// poll snapshots at ~60 Hz and check that time only moves forward
+static int run_threaded(double seconds) {
+    game_init(NATIVE_CANVAS_WIDTH, NATIVE_CANVAS_HEIGHT);
+    if (sim_thread_start(NATIVE_CANVAS_WIDTH, NATIVE_CANVAS_HEIGHT)) return 1;
+    
+    double start = platform_now_ms();
+    uint64_t last_tick = 0;
+    int frames = 0, fresh = 0, errors = 0;
+    
+    while (platform_now_ms() - start < seconds * 1000.0) {
+        const GameSnapshot* snap = sim_thread_latest();
+        if (snap->tick < last_tick) errors++;
+        if (snap->tick != last_tick) fresh++;
+        last_tick = snap->tick;
+        frames++;
+        platform_sleep_ms(1000.0 / 60.0);
+    }
+    
+    sim_thread_stop();
+    
+    double elapsed = (platform_now_ms() - start) / 1000.0;
+    printf("Rendered %d frames (%d with new state), sim ticks %llu (%.1f Hz), ordering errors %d\n",
+           frames, fresh, (unsigned long long)sim_thread_ticks(),
+           sim_thread_ticks() / elapsed, errors);
+    return errors ? 1 : 0;
+}
+
+// Save one snapshot per tick into a ring, then rewind; report bandwidth and
+// restore latency. The first static_fraction of the entities never move
+// (like level geometry spawned up front), which is the case delta snapshots
+// are meant for. The update is the game's default, time-sliced one: with
+// every entity thinking each tick, the static ones all turn away from the
+// player and no block stays unchanged. Returns nonzero if a save or restore
+// failed or was not exact.
+static int bench_snapshot_case(StateRingMode mode, int entity_count, float static_fraction) {
+    const float dt = 1.0f / SIM_TICK_RATE;
+    StateRing ring;
+    
+    game_init(NATIVE_CANVAS_WIDTH, NATIVE_CANVAS_HEIGHT);
+    game_set_time_slicing(1);
+    bench_rng_state = 777;
+    int static_count = (int)(entity_count * static_fraction);
+    for (int i = 0; i < entity_count; i++) {
+        float speed = i < static_count ? 0.0f : 50.0f + bench_rand() * 150.0f;
+        game_spawn_entity(bench_rand() * NATIVE_CANVAS_WIDTH, bench_rand() * NATIVE_CANVAS_HEIGHT,
+                          bench_rand() * 6.2831853f, speed);
+    }
+    state_ring_init(&ring, SNAPSHOT_RING_SLOTS, mode);
+    
+    // State hash at each save, to check restores against
+    static uint64_t hashes[SNAPSHOT_BENCH_SAVES];
+    uint64_t first_tick = game_tick() + 1;
+    double save_ms = 0.0;
+    int mismatches = 0;
+    for (int i = 0; i < SNAPSHOT_BENCH_SAVES; i++) {
+        game_update(dt, NATIVE_CANVAS_WIDTH, NATIVE_CANVAS_HEIGHT);
+        hashes[i] = game_state_hash();
+        double start = platform_now_ms();
+        if (state_ring_save(&ring)) mismatches++;
+        save_ms += platform_now_ms() - start;
+    }
+    
+    // Rewind one frame at a time and check each restore is exact
+    uint64_t expected = state_ring_tick(&ring, 1);
+    double restore_ms = 0.0;
+    int restores = 0;
+    while (state_ring_count(&ring) > 1) {
+        double start = platform_now_ms();
+        int failed = state_ring_restore(&ring, 1);
+        restore_ms += platform_now_ms() - start;
+        if (failed) {
+            mismatches++;
+            break;
+        }
+        uint64_t tick = game_tick();
+        if (tick != expected || tick < first_tick || hashes[tick - first_tick] != game_state_hash()) mismatches++;
+        expected = state_ring_tick(&ring, 1);
+        restores++;
+    }
+    
+    double state_mb = game_state_size() / (1024.0 * 1024.0);
+    double stored_mb = ring.bytes_saved / (1024.0 * 1024.0) / SNAPSHOT_BENCH_SAVES;
+    printf("%-5s %5.0f%% static  state %6.2f MB  stored %6.2f MB/save  save %7.1f us (%6.0f MB/s)  restore %7.1f us%s\n",
+           mode == STATE_RING_FULL ? "full" : "delta", static_fraction * 100.0f,
+           state_mb, stored_mb, save_ms * 1000.0 / SNAPSHOT_BENCH_SAVES,
+           state_mb * SNAPSHOT_BENCH_SAVES / (save_ms / 1000.0),
+           restores ? restore_ms * 1000.0 / restores : 0.0,
+           mismatches ? "  MISMATCH" : "");
+    state_ring_free(&ring);
+    return mismatches != 0;
+}
+
+static int run_snapshot_bench(int entity_count) {
+    printf("State ring: %d entities, %d slots, %d saves, time-sliced update\n",
+           entity_count, SNAPSHOT_RING_SLOTS, SNAPSHOT_BENCH_SAVES);
+    job_system_init(platform_cpu_count());
+    int failed = bench_snapshot_case(STATE_RING_FULL, entity_count, 0.0f);
+    failed |= bench_snapshot_case(STATE_RING_DELTA, entity_count, 0.0f);
+    failed |= bench_snapshot_case(STATE_RING_FULL, entity_count, 0.95f);
+    failed |= bench_snapshot_case(STATE_RING_DELTA, entity_count, 0.95f);
+    job_system_shutdown();
+    return failed;
+}
+
+// Load every asset once per iteration into the level arena. Returns the
+// average milliseconds per full load; *peak receives the most arena space
+// the loads needed at once.
+static double bench_asset_loads(const char** names, int count, size_t* peak) {
+    Arena* arena = arena_level();
+    double total_ms = 0.0;
+    *peak = 0;
+    
+    for (int iter = 0; iter < ASSET_BENCH_ITERATIONS; iter++) {
+        ArenaMark mark = arena_mark(arena);
+        double start = platform_now_ms();
+        for (int i = 0; i < count; i++) {
+            if (!assets_load(arena, names[i], NULL)) return -1.0;
+        }
+        total_ms += platform_now_ms() - start;
+        if (arena->used - mark > *peak) *peak = arena->used - mark;
+        arena_rewind(arena, mark);
+    }
+    return total_ms / ASSET_BENCH_ITERATIONS;
+}
+
+// Compare the archive against the plain preload path. Preloaded files stay
+// resident in the in-memory filesystem for the page's lifetime, so the
+// resident figure is what the filesystem holds plus the decoded copies.
+static int run_asset_bench(const char* pak_path, char** specs, int count) {
+    const char** files = (const char**)calloc(count, sizeof(char*));
+    const char** names = (const char**)calloc(count, sizeof(char*));
+    size_t loose_bytes = 0;
+    
+    // Split <file>@<name> in place
+    for (int i = 0; i < count; i++) {
+        char* at = strchr(specs[i], '@');
+        if (at) *at = '\0';
+        files[i] = specs[i];
+        names[i] = at ? at + 1 : specs[i];
+        loose_bytes += assets_size(files[i]);
+    }
+    
+    size_t loose_peak = 0, pak_peak = 0;
+    double loose_ms = bench_asset_loads(files, count, &loose_peak);
+    
+    if (assets_mount(pak_path)) return 1;
+    size_t pak_bytes = assets_size(pak_path);
+    double pak_ms = bench_asset_loads(names, count, &pak_peak);
+    assets_unmount();
+    
+    if (loose_ms < 0.0 || pak_ms < 0.0) return 1;
+    
+    printf("Assets: %d files, %d loads each\n", count, ASSET_BENCH_ITERATIONS);
+    printf("source    download KB  load ms  resident KB\n");
+    printf("preload   %11.1f  %7.3f  %11.1f\n", loose_bytes / 1024.0, loose_ms,
+           (loose_bytes + loose_peak) / 1024.0);
+    printf("archive   %11.1f  %7.3f  %11.1f\n", pak_bytes / 1024.0, pak_ms,
+           (pak_bytes + pak_peak) / 1024.0);
+    
+    free(files);
+    free(names);
+    return 0;
+}
+
+// Stand-ins for the renderer's hooks: regions are copied as stored and
+// "uploaded" into a buffer shaped like the GPU one
+static uint8_t stream_bench_gpu[STREAM_MAX_RESIDENT * STREAM_SLOT_BYTES];
+
+static int stream_bench_decode(void* user, const void* raw, size_t raw_size, void* out, size_t capacity) {
+    (void)user;
+    if (raw_size > capacity) return -1;
+    memcpy(out, raw, raw_size);
+    return (int)(raw_size & ~(size_t)3);
+}
+
+static void stream_bench_upload(void* user, int slot, const void* data, size_t offset, size_t size) {
+    (void)user;
+    memcpy(stream_bench_gpu + (size_t)slot * STREAM_SLOT_BYTES + offset, data, size);
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Fly a camera around the level at 60 Hz in real time, so the decode thread
+// runs at the pace it would in the game, and time the main thread's share
+static int run_stream_bench(const char* level_path, int frames) {
+    const float half_width = NATIVE_CANVAS_WIDTH * 0.5f;
+    const float half_height = NATIVE_CANVAS_HEIGHT * 0.5f;
+    const double frame_ms = 1000.0 / 60.0;
+    StreamHooks hooks = {
+        .decode = stream_bench_decode,
+        .upload = stream_bench_upload,
+        .user = NULL,
+    };
+    if (frames < 1) frames = 1;
+    if (stream_open(level_path, &hooks)) return 1;
+    
+    // Loop around a rectangle inset by one view from the world's edges
+    float left = half_width, right = WORLD_WIDTH - half_width;
+    float bottom = half_height, top = WORLD_HEIGHT - half_height;
+    float perimeter = 2.0f * ((right - left) + (top - bottom));
+    double* update_ms = (double*)calloc(frames, sizeof(double));
+    int missing_frames = 0;
+    
+    double next_frame = platform_now_ms();
+    for (int f = 0; f < frames; f++) {
+        float d = fmodf(f * STREAM_BENCH_SPEED / 60.0f, perimeter);
+        float x, y;
+        if (d < right - left) {
+            x = left + d, y = bottom;
+        } else if ((d -= right - left) < top - bottom) {
+            x = right, y = bottom + d;
+        } else if ((d -= top - bottom) < right - left) {
+            x = right - d, y = top;
+        } else {
+            x = left, y = top - (d - (right - left));
+        }
+        
+        double start = platform_now_ms();
+        stream_update(x, y, half_width, half_height);
+        update_ms[f] = platform_now_ms() - start;
+        if (f >= STREAM_BENCH_WARMUP && stream_missing(x, y, half_width, half_height) > 0) missing_frames++;
+        
+        next_frame += frame_ms;
+        double now = platform_now_ms();
+        if (next_frame > now) platform_sleep_ms(next_frame - now);
+    }
+    
+    const StreamStats* stats = stream_stats();
+    qsort(update_ms, frames, sizeof(double), compare_doubles);
+    printf("Streaming: %d frames at %.0f units/s, view %dx%d\n", frames, STREAM_BENCH_SPEED,
+           NATIVE_CANVAS_WIDTH, NATIVE_CANVAS_HEIGHT);
+    printf("update ms: p50 %.4f  p99 %.4f  max %.4f\n", update_ms[frames / 2],
+           update_ms[(frames * 99) / 100], update_ms[frames - 1]);
+    printf("regions: %d loaded, %d evicted, %d failed, peak %d of %d slots resident\n",
+           stats->regions_loaded, stats->regions_evicted, stats->regions_failed,
+           stats->peak_resident, STREAM_MAX_RESIDENT);
+    printf("upload: %.1f KB total, peak %.1f KB/frame (budget %d KB); decode %.3f ms/region\n",
+           stats->bytes_uploaded / 1024.0, stats->peak_frame_bytes / 1024.0, STREAM_UPLOAD_BUDGET / 1024,
+           stats->regions_loaded ? stats->decode_ms / stats->regions_loaded : 0.0);
+    printf("frames with a visible region missing (after %d warm-up): %d\n", STREAM_BENCH_WARMUP, missing_frames);
+    
+    free(update_ms);
+    stream_close();
+    return 0;
+}
+
+// Record a synthetic session (random key taps and holds over a field of
+// drifting entities) to produce a repeatable replay workload
+// Clips like the game's: short frame lists in each loop mode
+static const uint16_t anim_bench_images[4] = {0, 1, 2, 3};
+static const float anim_bench_durations[3][4] = {
+    {0.3f, 0.3f, 0.3f, 0.3f},
+    {0.25f, 0.1f, 0.25f, 0.1f},
+    {0.15f, 0.15f, 0.15f, 0.4f},
+};
+static const AnimClipDef anim_bench_clips[] = {
+    {anim_bench_images, anim_bench_durations[0], 2, ANIM_LOOP},
+    {anim_bench_images, anim_bench_durations[1], 3, ANIM_PING_PONG},
+    {anim_bench_images, anim_bench_durations[2], 4, ANIM_LOOP},
+    {anim_bench_images, anim_bench_durations[1], 4, ANIM_ONCE},
+};
+#define ANIM_BENCH_CLIPS (int)(sizeof(anim_bench_clips) / sizeof(anim_bench_clips[0]))
+
+// Baseline: one record per entity, stepping frame by frame through its
+// clip's definition with a branch per loop mode
+typedef struct {
+    const AnimClipDef* clip;
+    int frame;
+    int direction;      // +1 or -1 (ping-pong)
+    float frame_time;   // seconds into the current frame
+    float rate;
+    uint16_t image;
+} NaiveAnim;
+
+static void naive_anim_advance(NaiveAnim* anims, int count, float dt) {
+    for (int i = 0; i < count; i++) {
+        NaiveAnim* a = &anims[i];
+        const AnimClipDef* clip = a->clip;
+        a->frame_time += dt * a->rate;
+        while (a->frame_time >= clip->durations[a->frame]) {
+            int last = clip->frame_count - 1;
+            if (clip->mode == ANIM_ONCE && a->frame == last) {
+                a->frame_time = clip->durations[a->frame];
+                break;
+            }
+            a->frame_time -= clip->durations[a->frame];
+            if (clip->mode == ANIM_LOOP) {
+                a->frame = a->frame == last ? 0 : a->frame + 1;
+            } else if (clip->mode == ANIM_PING_PONG && last > 0) {
+                if (a->frame + a->direction < 0 || a->frame + a->direction > last) a->direction = -a->direction;
+                a->frame += a->direction;
+            } else if (clip->mode == ANIM_ONCE) {
+                a->frame++;
+            }
+        }
+        a->image = clip->images[a->frame];
+    }
+}
+
+static int run_anim_bench(int count) {
+    if (count < 1 || count > ANIM_MAX_PLAYERS) {
+        printf("Animation bench takes 1 to %d players\n", ANIM_MAX_PLAYERS);
+        return 1;
+    }
+    if (anim_bake(anim_bench_clips, ANIM_BENCH_CLIPS)) return 1;
+    
+    NaiveAnim* naive = malloc((size_t)count * sizeof(NaiveAnim));
+    if (!naive) return 1;
+    for (int i = 0; i < count; i++) {
+        int clip = i % ANIM_BENCH_CLIPS;
+        float rate = 0.8f + 0.4f * bench_rand();
+        anim_play(i, clip, 0.0f, rate);
+        naive[i] = (NaiveAnim){&anim_bench_clips[clip], 0, 1, 0.0f, rate, 0};
+    }
+    
+    // Same dt every tick; the checksums keep either loop from being dropped
+    uint64_t batched_sum = 0, naive_sum = 0;
+    double start = platform_now_ms();
+    for (int t = 0; t < ANIM_BENCH_TICKS; t++) {
+        anim_advance(count, ANIM_BENCH_DT);
+        batched_sum += anim_frames()[t % count];
+    }
+    double batched_ms = platform_now_ms() - start;
+    
+    start = platform_now_ms();
+    for (int t = 0; t < ANIM_BENCH_TICKS; t++) {
+        naive_anim_advance(naive, count, ANIM_BENCH_DT);
+        naive_sum += naive[t % count].image;
+    }
+    double naive_ms = platform_now_ms() - start;
+    
+    // Both should agree away from frame boundaries, where float rounding
+    // can put one a step ahead
+    int mismatched = 0;
+    const uint16_t* frames = anim_frames();
+    for (int i = 0; i < count; i++) mismatched += frames[i] != naive[i].image;
+    free(naive);
+    
+    printf("Animation: %d players, %d ticks, %d clips\n", count, ANIM_BENCH_TICKS, ANIM_BENCH_CLIPS);
+    printf("  batched:    %8.2f us/tick  %6.2f ns/player  (checksum %llu)\n",
+           batched_ms * 1000.0 / ANIM_BENCH_TICKS, batched_ms * 1e6 / ANIM_BENCH_TICKS / count,
+           (unsigned long long)batched_sum);
+    printf("  per-entity: %8.2f us/tick  %6.2f ns/player  (checksum %llu)\n",
+           naive_ms * 1000.0 / ANIM_BENCH_TICKS, naive_ms * 1e6 / ANIM_BENCH_TICKS / count,
+           (unsigned long long)naive_sum);
+    printf("  speedup %.1fx, %d players on a different frame at the end\n",
+           batched_ms > 0.0 ? naive_ms / batched_ms : 0.0, mismatched);
+    return 0;
+}
+
+// Scatter rectangular obstacles, plus long walls with gaps, until fill of
+// the map is covered
+static void path_bench_map(int size, float fill) {
+    int target = (int)(fill * size * size), covered = 0;
+    for (int wall = 0; wall < size / 64; wall++) {
+        int y = (int)(bench_rand() * size);
+        for (int x = 0; x < size; x++) {
+            if ((x / 48) % 4 == 0 || path_is_blocked(x, y)) continue;  // gaps
+            path_set_blocked(x, y, 1);
+            covered++;
+        }
+    }
+    while (covered < target) {
+        int w = 2 + (int)(bench_rand() * 24), h = 2 + (int)(bench_rand() * 24);
+        int x0 = (int)(bench_rand() * size), y0 = (int)(bench_rand() * size);
+        for (int y = y0; y < y0 + h && y < size; y++) {
+            for (int x = x0; x < x0 + w && x < size; x++) {
+                if (path_is_blocked(x, y)) continue;
+                path_set_blocked(x, y, 1);
+                covered++;
+            }
+        }
+    }
+}
+
+static PathPoint path_bench_open_cell(int size) {
+    for (;;) {
+        PathPoint p = {(int)(bench_rand() * size), (int)(bench_rand() * size)};
+        if (!path_is_blocked(p.x, p.y)) return p;
+    }
+}
+
+// Walk a path cell by cell: every step must be open, diagonal steps may not
+// cut a corner, and the cost must add up. Returns 1 if the path is valid.
+static int path_bench_valid(const Path* path, PathPoint start, PathPoint goal) {
+    if (path->count < 1) return 0;
+    PathPoint first = path->points[0], last = path->points[path->count - 1];
+    if (first.x != start.x || first.y != start.y || last.x != goal.x || last.y != goal.y) return 0;
+    
+    float length = 0.0f;
+    for (int i = 0; i + 1 < path->count; i++) {
+        PathPoint a = path->points[i], b = path->points[i + 1];
+        int dx = (b.x > a.x) - (b.x < a.x), dy = (b.y > a.y) - (b.y < a.y);
+        int ax = abs(b.x - a.x), ay = abs(b.y - a.y);
+        if ((ax != 0 && ay != 0 && ax != ay) || (ax == 0 && ay == 0)) return 0;
+        for (int x = a.x, y = a.y; x != b.x || y != b.y; x += dx, y += dy) {
+            if (path_is_blocked(x + dx, y + dy)) return 0;
+            if (dx != 0 && dy != 0 && (path_is_blocked(x + dx, y) || path_is_blocked(x, y + dy))) return 0;
+        }
+        length += ax > ay ? (ax - ay) + 1.41421356f * ay : (ay - ax) + 1.41421356f * ax;
+    }
+    return fabsf(length - path->cost) < 0.01f * (1.0f + length);
+}
+
+// Random queries with nothing to share, then squads of agents heading to a
+// few shared goals: each leader searches, and its squad starts along the
+// leader's path, as agents that spawned behind it or are re-planning would
+static int run_path_bench(int size, int queries) {
+    if (size < 16 || (int64_t)size * size > PATH_MAX_CELLS || queries < 1) {
+        printf("Path bench takes a size from 16 to %d and at least one query\n", 4096);
+        return 1;
+    }
+    Arena arena;
+    size_t cells = (size_t)(size + 2) * (size + 2);
+    if (arena_init(&arena, "path bench", cells * 22 + 4 * 1024 * 1024)) return 1;
+    if (path_grid_init(&arena, size, size)) return 1;
+    path_bench_map(size, PATH_BENCH_FILL);
+    
+    static Path path;
+    double* query_ms = (double*)calloc(queries, sizeof(double));
+    int invalid = 0;
+    
+    // Uncached: every query searches
+    double start = platform_now_ms();
+    for (int q = 0; q < queries; q++) {
+        PathPoint a = path_bench_open_cell(size), b = path_bench_open_cell(size);
+        double t0 = platform_now_ms();
+        path_cache_clear();
+        int found = path_find(a.x, a.y, b.x, b.y, &path);
+        query_ms[q] = platform_now_ms() - t0;
+        if (found && !path_bench_valid(&path, a, b)) invalid++;
+    }
+    double search_total = platform_now_ms() - start;
+    PathStats searched = *path_stats();
+    qsort(query_ms, queries, sizeof(double), compare_doubles);
+    
+    printf("Paths: %dx%d map, %.0f%% blocked, %d queries\n", size, size, PATH_BENCH_FILL * 100.0f, queries);
+    printf("  searched: %8.0f queries/s  p50 %.3f ms  p99 %.3f ms  max %.3f ms  %.0f jump points avg  %llu no path\n",
+           queries * 1000.0 / search_total, query_ms[queries / 2], query_ms[(queries * 99) / 100],
+           query_ms[queries - 1], (double)searched.cells_expanded / searched.searches,
+           (unsigned long long)searched.failures);
+    
+    // Shared goals: squads follow their leader's path
+    PathPoint goals[PATH_BENCH_GOALS];
+    for (int g = 0; g < PATH_BENCH_GOALS; g++) goals[g] = path_bench_open_cell(size);
+    path_cache_clear();
+    path_stats_reset();
+    int done = 0;
+    start = platform_now_ms();
+    while (done < queries) {
+        PathPoint goal = goals[done % PATH_BENCH_GOALS];
+        PathPoint lead = path_bench_open_cell(size);
+        if (!path_find(lead.x, lead.y, goal.x, goal.y, &path)) {
+            done++;
+            continue;
+        }
+        Path leader = path;
+        for (int m = 0; m < PATH_BENCH_SQUAD && ++done < queries; m++) {
+            // A cell some way along one of the leader's segments
+            int k = (int)(bench_rand() * (leader.count - 1));
+            PathPoint a = leader.points[k], b = leader.points[k + 1];
+            int steps = abs(b.x - a.x) > abs(b.y - a.y) ? abs(b.x - a.x) : abs(b.y - a.y);
+            int t = (int)(bench_rand() * steps);
+            PathPoint s = {a.x + t * ((b.x > a.x) - (b.x < a.x)), a.y + t * ((b.y > a.y) - (b.y < a.y))};
+            if (path_find(s.x, s.y, goal.x, goal.y, &path) && !path_bench_valid(&path, s, goal)) invalid++;
+        }
+        done++;
+    }
+    double shared_total = platform_now_ms() - start;
+    const PathStats* shared = path_stats();
+    printf("  shared:   %8.0f queries/s  %d goals, squads of %d, %.0f%% from cache\n",
+           queries * 1000.0 / shared_total, PATH_BENCH_GOALS, PATH_BENCH_SQUAD + 1,
+           100.0 * shared->cache_hits / shared->queries);
+    printf("  %d invalid paths\n", invalid);
+    
+    free(query_ms);
+    arena_free(&arena);
+    return invalid != 0;
+}
+
+// Planning system for the scheduler bench: each agent in the slice plans a
+// path from a random cell to one of a few goals
+static PathPoint sched_bench_goals[PATH_BENCH_GOALS];
+
+static void sched_bench_plan(void* user, int begin, int end, float elapsed) {
+    static Path path;
+    (void)user;
+    (void)elapsed;
+    for (int i = begin; i < end; i++) {
+        PathPoint start = path_bench_open_cell(SCHED_BENCH_GRID);
+        PathPoint goal = sched_bench_goals[i % PATH_BENCH_GOALS];
+        path_find(start.x, start.y, goal.x, goal.y, &path);
+    }
+}
+
+static void print_tick_times(const char* label, double* ms, int count) {
+    qsort(ms, count, sizeof(double), compare_doubles);
+    printf("  %-22s p50 %7.3f ms  p99 %7.3f ms  max %7.3f ms\n", label, ms[count / 2],
+           ms[(count * 99) / 100], ms[count - 1]);
+}
+
+// Run the spike scenario once and print its tick times
+static void sched_bench_case(int sliced, int plan_system, int entities) {
+    static double tick_ms[SCHED_BENCH_TICKS];
+    const float dt = 1.0f / 60.0f;
+    
+    game_init(WORLD_WIDTH, WORLD_HEIGHT);
+    game_set_time_slicing(sliced);
+    sched_set_budget(plan_system, sliced ? SCHED_BENCH_PLAN_BUDGET_MS : 1e9);
+    sched_set_tick_budget(sliced ? SCHED_BENCH_TICK_BUDGET_MS : 0.0);
+    bench_rng_state = 12345;
+    
+    printf("%s:\n", sliced ? "time-sliced" : "every tick");
+    for (int phase = 0; phase < 2; phase++) {
+        int target = phase == 0 ? SCHED_BENCH_BEFORE : entities;
+        while (game_entity_count() < target) {
+            game_spawn_entity(bench_rand() * WORLD_WIDTH, bench_rand() * WORLD_HEIGHT,
+                              bench_rand() * 6.2831853f, 50.0f + bench_rand() * 150.0f);
+        }
+        sched_set_items(plan_system, game_entity_count() / SCHED_BENCH_PLANNERS);
+        int misses = 0;
+        for (int t = 0; t < SCHED_BENCH_TICKS; t++) {
+            double start = platform_now_ms();
+            game_update(dt, WORLD_WIDTH, WORLD_HEIGHT);
+            tick_ms[t] = platform_now_ms() - start;
+            if (tick_ms[t] > SCHED_BENCH_TICK_BUDGET_MS) misses++;
+        }
+        char label[64];
+        snprintf(label, sizeof(label), "%d entities", target);
+        print_tick_times(label, tick_ms, SCHED_BENCH_TICKS);
+        printf("  %-22s %d of %d ticks over the %.1f ms budget\n", "", misses, SCHED_BENCH_TICKS,
+               SCHED_BENCH_TICK_BUDGET_MS);
+    }
+}
+
+// Entity AI, movement and a path planning system across a sudden spike in
+// entity count, with time slicing and update LOD, then with everything
+// running every tick
+static int run_sched_bench(int entities) {
+    if (entities <= SCHED_BENCH_BEFORE || entities > MAX_ENTITIES) {
+        printf("Scheduler bench takes %d to %d entities\n", SCHED_BENCH_BEFORE + 1, MAX_ENTITIES);
+        return 1;
+    }
+    Arena arena;
+    if (arena_init(&arena, "sched bench", 8 * 1024 * 1024)) return 1;
+    if (path_grid_init(&arena, SCHED_BENCH_GRID, SCHED_BENCH_GRID)) return 1;
+    path_bench_map(SCHED_BENCH_GRID, PATH_BENCH_FILL);
+    for (int g = 0; g < PATH_BENCH_GOALS; g++) sched_bench_goals[g] = path_bench_open_cell(SCHED_BENCH_GRID);
+    
+    SchedSystemDesc plan = {
+        .name = "path planning",
+        .priority = 1,
+        .budget_ms = SCHED_BENCH_PLAN_BUDGET_MS,
+        .item_cost_us = 50.0,
+        .mode = SCHED_ADAPTIVE,
+        .update = sched_bench_plan,
+    };
+    int plan_system = sched_register(&plan);
+    if (plan_system < 0) return 1;
+    
+    job_system_init(platform_cpu_count());
+    printf("Scheduler: %d then %d entities, %d ticks each at 60 Hz, 1 planner per %d entities\n",
+           SCHED_BENCH_BEFORE, entities, SCHED_BENCH_TICKS, SCHED_BENCH_PLANNERS);
+    sched_bench_case(1, plan_system, entities);
+    sched_report();
+    sched_bench_case(0, plan_system, entities);
+    job_system_shutdown();
+    arena_free(&arena);
+    return 0;
+}
+
+// Best of OBB_BENCH_ITERATIONS runs of a narrowphase, in milliseconds
+static double time_narrowphase(int (*narrowphase)(const BoxSet*, const CollidePair*, int, Contact*),
+                               const BoxSet* set, const CollidePair* pairs, int count, Contact* out,
+                               int* contacts) {
+    double best = 1e30;
+    for (int i = 0; i < OBB_BENCH_ITERATIONS; i++) {
+        double start = platform_now_ms();
+        *contacts = narrowphase(set, pairs, count, out);
+        double ms = platform_now_ms() - start;
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+// Candidate pairs as a broadphase would hand them over: boxes of assorted
+// sizes and angles, each pair close enough that most overlap, with
+// the boxes of a pair scattered through memory
+static int run_obb_bench(int count) {
+    if (count < 1 || count > MAX_ENTITIES) {
+        printf("OBB bench takes 1 to %d pairs\n", MAX_ENTITIES);
+        return 1;
+    }
+    int boxes = 2 * count;
+    Arena arena;
+    if (arena_init(&arena, "obb bench", (size_t)boxes * 64 + (size_t)count * 80 + 1024 * 1024)) return 1;
+    BoxSet set;
+    if (box_set_init(&set, &arena, boxes)) return 1;
+    uint32_t* order = (uint32_t*)arena_alloc(&arena, (size_t)boxes * sizeof(uint32_t));
+    CollidePair* pairs = (CollidePair*)arena_alloc(&arena, (size_t)count * sizeof(CollidePair));
+    Contact* simd = (Contact*)arena_alloc(&arena, (size_t)count * sizeof(Contact));
+    Contact* scalar = (Contact*)arena_alloc(&arena, (size_t)count * sizeof(Contact));
+    if (!order || !pairs || !simd || !scalar) return 1;
+    
+    bench_rng_state = 12345;
+    for (int i = 0; i < boxes; i++) order[i] = (uint32_t)i;
+    for (int i = boxes - 1; i > 0; i--) {
+        int j = (int)(bench_rand() * (i + 1));
+        uint32_t t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+    for (int p = 0; p < count; p++) {
+        uint32_t a = order[2 * p], b = order[2 * p + 1];
+        pairs[p] = (CollidePair){a, b};
+        float x = bench_rand() * WORLD_WIDTH, y = bench_rand() * WORLD_HEIGHT;
+        float reach = 0.0f;
+        uint32_t box[2] = {a, b};
+        for (int k = 0; k < 2; k++) {
+            float angle = bench_rand() * 6.2831853f;
+            set.half_w[box[k]] = 8.0f + bench_rand() * 40.0f;
+            set.half_h[box[k]] = 8.0f + bench_rand() * 40.0f;
+            set.cos_a[box[k]] = cosf(angle);
+            set.sin_a[box[k]] = sinf(angle);
+            reach += sqrtf(set.half_w[box[k]] * set.half_w[box[k]] + set.half_h[box[k]] * set.half_h[box[k]]);
+        }
+        float heading = bench_rand() * 6.2831853f, distance = bench_rand() * reach;
+        set.x[a] = x;
+        set.y[a] = y;
+        set.x[b] = x + sinf(heading) * distance;
+        set.y[b] = y + cosf(heading) * distance;
+    }
+    set.count = boxes;
+    
+    int simd_contacts = 0, scalar_contacts = 0;
+    double simd_ms = time_narrowphase(collide_obb_pairs, &set, pairs, count, simd, &simd_contacts);
+    double scalar_ms = time_narrowphase(collide_obb_pairs_scalar, &set, pairs, count, scalar, &scalar_contacts);
+    
+    // Both must find the same contacts
+    int mismatched = simd_contacts != scalar_contacts;
+    for (int i = 0; i < simd_contacts && !mismatched; i++) {
+        const Contact* v = &simd[i];
+        const Contact* s = &scalar[i];
+        mismatched = v->a != s->a || v->b != s->b || fabsf(v->depth - s->depth) > 1e-3f ||
+                     fabsf(v->normal[0] - s->normal[0]) > 1e-4f || fabsf(v->normal[1] - s->normal[1]) > 1e-4f ||
+                     fabsf(v->point[0] - s->point[0]) > 1e-2f || fabsf(v->point[1] - s->point[1]) > 1e-2f;
+    }
+    
+    printf("OBB narrowphase: %d pairs, %d contacts, best of %d runs\n", count, simd_contacts, OBB_BENCH_ITERATIONS);
+    printf("  SIMD x%d: %8.3f ms  %7.1f M pairs/s\n", COLLIDE_BATCH, simd_ms, count / simd_ms / 1000.0);
+    printf("  scalar:  %8.3f ms  %7.1f M pairs/s\n", scalar_ms, count / scalar_ms / 1000.0);
+    printf("  speedup %.2fx, results %s\n", scalar_ms / simd_ms, mismatched ? "DIFFER" : "match");
+    arena_free(&arena);
+    return mismatched;
+}
+
+// Close a frame drawn on the no-GPU backend and check its counters against
+// budget, and that it drew exactly draws times. Returns nonzero on failure.
+static int gpu_check_frame(const char* name, const GpuFrameStats* budget, uint32_t draws) {
+    gpu_trace_end_frame();
+    const GpuFrameStats* s = gpu_trace_last_frame();
+    int failed = gpu_trace_check_budget(budget) != 0 || s->draws != draws;
+    printf("  %-28s %u draws  %u pipeline binds  %u buffer writes (%u bytes)  %s\n", name, s->draws,
+           s->pipeline_binds, s->buffer_writes, s->buffer_bytes, failed ? "FAILED" : "ok");
+    return failed;
+}
+
+// Draw and upload budgets of the text renderer, run natively: the renderer
+// issues its real commands, the backend drops them and gpu_trace.c counts
+// them
+static int run_gpu_check(void) {
+    static unsigned char font_pixels[4 * 4 * 4];
+    if (memory_init()) return 1;
+    text_init(gpu_headless_device(), gpu_headless_queue(), WGPUTextureFormat_BGRA8Unorm);
+    text_set_canvas_size(NATIVE_CANVAS_WIDTH, NATIVE_CANVAS_HEIGHT);
+    text_load_font_file(GPU_CHECK_FONT);
+    upload_font_texture(font_pixels, 4, 4);
+    const char* shader = assets_load(arena_persistent(), GPU_CHECK_SHADER, NULL);
+    if (!shader) return 1;
+    text_create_pipeline(shader);
+    if (!text_is_ready()) {
+        printf("Text renderer did not start\n");
+        return 1;
+    }
+    gpu_trace_end_frame();  // setup uploads are not part of any frame
+    
+    WGPURenderPassColorAttachment target = {.loadOp = WGPULoadOp_Load, .storeOp = WGPUStoreOp_Store};
+    WGPURenderPassDescriptor pass_desc = {.colorAttachmentCount = 1, .colorAttachments = &target};
+    int failed = 0;
+    printf("Text on the no-GPU backend:\n");
+    
+    // Every label shares one vertex upload and one draw, however many there are
+    WGPURenderPassEncoder pass = gpu_begin_pass(gpu_headless_encoder(), &pass_desc);
+    for (int i = 0; i < GPU_CHECK_LABELS; i++) {
+        char label[16];
+        snprintf(label, sizeof(label), "%d", i);
+        text_label_add(label, (i % 40) * 20.0f, (i / 40) * 24.0f, 0.3f);
+    }
+    text_label_flush(pass, 1.0f, 1.0f, 1.0f);
+    GpuFrameStats labels = {.passes = 1, .draws = 1, .pipeline_binds = 1, .bind_group_binds = 1,
+                            .vertex_buffer_binds = 1, .buffer_writes = 2};
+    failed |= gpu_check_frame("1000 labels", &labels, 1);
+    
+    // HUD-style paragraphs: one draw each. Once uploaded, an unchanged
+    // layout only rewrites its uniforms, and appending text uploads only
+    // the last line.
+    TextLayout help, dialogue;
+    if (text_layout_init(&help, arena_persistent(), 128, 320.0f, 0.35f, TEXT_ALIGN_RIGHT) ||
+        text_layout_init(&dialogue, arena_persistent(), 512, 752.0f, 0.4f, TEXT_ALIGN_LEFT)) {
+        return 1;
+    }
+    text_layout_set(&help, "Up/Down: move\nLeft/Right: turn\nP: pause");
+    text_layout_set(&dialogue, "Welcome, traveller! Use the arrow keys to steer. The world is much "
+                               "bigger than the screen, so keep exploring.");
+    uint32_t uniform_bytes = 0;
+    for (int frame = 0; frame < 3; frame++) {
+        if (frame == 2) text_layout_append(&dialogue, " More", 5);
+        pass = gpu_begin_pass(gpu_headless_encoder(), &pass_desc);
+        render_text_layout(pass, &help, 456.0f, 576.0f, 0.7f, 0.8f, 0.9f);
+        render_text_layout(pass, &dialogue, 24.0f, 120.0f, 1.0f, 0.95f, 0.8f);
+        if (frame == 0) {
+            failed |= gpu_check_frame("HUD, first frame", &(GpuFrameStats){.passes = 1, .buffer_writes = 4}, 2);
+        } else if (frame == 1) {
+            // Two uniform writes and no vertex upload
+            failed |= gpu_check_frame("HUD, unchanged", &(GpuFrameStats){.passes = 1, .buffer_writes = 2}, 2);
+            uniform_bytes = gpu_trace_last_frame()->buffer_bytes;
+        } else {
+            // Only the uniforms plus the vertices of one line
+            uint32_t line_bytes = (uint32_t)(dialogue.lines[dialogue.line_count - 1].vertex_count * sizeof(TextVertex));
+            GpuFrameStats append = {.passes = 1, .buffer_writes = 3, .buffer_bytes = uniform_bytes + line_bytes};
+            failed |= gpu_check_frame("HUD, 5 characters appended", &append, 2);
+        }
+    }
+    text_layout_release(&help);
+    text_layout_release(&dialogue);
+    return failed;
+}
+
+static int run_record_demo(const char* path, int ticks) {
+    static const int keys[] = {37, 38, 39, 40};
+    const float dt = 1.0f / SIM_TICK_RATE;
+    const double step_ms = 1000.0 / SIM_TICK_RATE;
+    int held[4] = {0};
+    
+    job_system_init(platform_cpu_count());
+    replay_record_start();
+    game_init(NATIVE_CANVAS_WIDTH, NATIVE_CANVAS_HEIGHT);
+    
+    bench_rng_state = 4242;
+    for (int i = 0; i < DEMO_ENTITIES; i++) {
+        game_spawn_entity(bench_rand() * NATIVE_CANVAS_WIDTH, bench_rand() * NATIVE_CANVAS_HEIGHT,
+                          bench_rand() * 6.2831853f, 50.0f + bench_rand() * 150.0f);
+    }
+    
+    for (int t = 0; t < ticks; t++) {
+        double step_start = t * step_ms;
+        game_set_input_clock(step_start);
+        
+        // Roughly one key change every 10 ticks, at a random point in the step
+        if (bench_rand() < 0.1f) {
+            int k = (int)(bench_rand() * 4) & 3;
+            held[k] = !held[k];
+            game_push_input(keys[k], held[k], step_start + bench_rand() * step_ms);
+        }
+        game_update(dt, NATIVE_CANVAS_WIDTH, NATIVE_CANVAS_HEIGHT);
+    }
+    
+    // Copy the recording before stopping, as the page does on F8
+    uint64_t hash = game_state_hash();
+    size_t copy_size;
+    uint8_t* copy = replay_copy_alloc(&copy_size);
+    replay_record_stop();
+    printf("Recorded %d ticks, state hash %016llx\n", ticks, (unsigned long long)hash);
+    int result = replay_save(path);
+    
+    // The in-progress copy must replay to the same state
+    ReplayResult replayed;
+    if (!copy || replay_run(copy, copy_size, &replayed) || replayed.ticks != (uint64_t)ticks ||
+        replayed.state_hash != hash) {
+        printf("Replay of the in-progress copy does not match the recording\n");
+        result = 1;
+    } else {
+        printf("Replay of the in-progress copy matches (%zu bytes)\n", copy_size);
+    }
+    free(copy);
+    job_system_shutdown();
+    return result;
+}
+
+static int run_replay(const char* path) {
+    ReplayResult result;
+    job_system_init(platform_cpu_count());
+    int status = replay_run_file(path, &result);
+    job_system_shutdown();
+    if (status) return status;
+    
+    printf("Replayed %llu ticks in %.1f ms (%.0f ticks/s), state hash %016llx\n",
+           (unsigned long long)result.ticks, result.elapsed_ms, result.ticks_per_sec,
+           (unsigned long long)result.state_hash);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    double seconds = 2.0;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--bench-jobs") == 0) {
+            int entities = BENCH_DEFAULT_ENTITIES;
+            if (i + 1 < argc && argv[i + 1][0] != '-') entities = atoi(argv[++i]);
+            return run_job_bench(entities);
+        } else if (strcmp(argv[i], "--record-demo") == 0 && i + 1 < argc) {
+            const char* path = argv[++i];
+            int ticks = DEMO_DEFAULT_TICKS;
+            if (i + 1 < argc && argv[i + 1][0] != '-') ticks = atoi(argv[++i]);
+            return run_record_demo(path, ticks);
+        } else if (strcmp(argv[i], "--bench-snapshot") == 0) {
+            int entities = BENCH_DEFAULT_ENTITIES;
+            if (i + 1 < argc && argv[i + 1][0] != '-') entities = atoi(argv[++i]);
+            return run_snapshot_bench(entities);
+        } else if (strcmp(argv[i], "--bench-scene") == 0) {
+            int sprites = BENCH_DEFAULT_SPRITES;
+            int frames = BENCH_DEFAULT_FRAMES;
+            if (i + 1 < argc && argv[i + 1][0] != '-') sprites = atoi(argv[++i]);
+            if (i + 1 < argc && argv[i + 1][0] != '-') frames = atoi(argv[++i]);
+            return run_scene_bench(sprites, frames);
+        } else if (strcmp(argv[i], "--bench-assets") == 0 && i + 2 < argc) {
+            if (memory_init()) return 1;
+            return run_asset_bench(argv[i + 1], argv + i + 2, argc - i - 2);
+        } else if (strcmp(argv[i], "--bench-stream") == 0 && i + 1 < argc) {
+            const char* path = argv[++i];
+            int frames = STREAM_BENCH_FRAMES;
+            if (i + 1 < argc && argv[i + 1][0] != '-') frames = atoi(argv[++i]);
+            if (memory_init()) return 1;
+            return run_stream_bench(path, frames);
+        } else if (strcmp(argv[i], "--bench-anim") == 0) {
+            int players = ANIM_BENCH_PLAYERS;
+            if (i + 1 < argc && argv[i + 1][0] != '-') players = atoi(argv[++i]);
+            return run_anim_bench(players);
+        } else if (strcmp(argv[i], "--bench-path") == 0) {
+            int size = PATH_BENCH_SIZE;
+            int queries = PATH_BENCH_QUERIES;
+            if (i + 1 < argc && argv[i + 1][0] != '-') size = atoi(argv[++i]);
+            if (i + 1 < argc && argv[i + 1][0] != '-') queries = atoi(argv[++i]);
+            return run_path_bench(size, queries);
+        } else if (strcmp(argv[i], "--bench-sched") == 0) {
+            int entities = SCHED_BENCH_ENTITIES;
+            if (i + 1 < argc && argv[i + 1][0] != '-') entities = atoi(argv[++i]);
+            return run_sched_bench(entities);
+        } else if (strcmp(argv[i], "--bench-obb") == 0) {
+            int pairs = OBB_BENCH_PAIRS;
+            if (i + 1 < argc && argv[i + 1][0] != '-') pairs = atoi(argv[++i]);
+            return run_obb_bench(pairs);
+        } else if (strcmp(argv[i], "--check-gpu") == 0) {
+            return run_gpu_check();
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            return run_replay(argv[++i]);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    
+    return run_threaded(seconds);
+}
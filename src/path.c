@@ -0,0 +1,490 @@
+#include "path.h"
+#include "platform.h"
+#include <stdio.h>
+#include <string.h>
+
+#define PATH_MAX_OPEN (256 * 1024)  // open set capacity; a query that overflows it fails
+#define SQRT2 1.41421356f
+#define CELL_CLOSED -1
+#define LINE_PAD 64
+
+typedef struct {
+    float f;   // cost so far plus the estimate to the goal
+    int cell;
+} OpenEntry;
+
+typedef struct {
+    PathPoint goal;
+    uint32_t version;  // grid_version the path was found on
+    int count;         // 0 if the entry is unused
+    PathPoint points[PATH_MAX_WAYPOINTS];
+} CacheEntry;
+
+// Grid, padded with a border of blocked cells so scans stop without bounds
+// checks. Cell (x, y) is at (y + 1) * stride + x + 1 in every per-cell array.
+static int grid_width = 0;
+static int grid_height = 0;
+static int stride = 0;
+static uint8_t* blocked = NULL;
+
+// blocked again as bits, one line per padded row and one per
+// padded column, with LINE_PAD blocked bits before and after each line so a
+// 64-bit window never leaves it
+static uint64_t* row_bits = NULL;
+static uint64_t* col_bits = NULL;
+static int line_words = 0;
+static uint32_t grid_version = 0;
+
+// Connected area per open cell, so a query between two areas fails at once
+// instead of flooding the start's whole area. Labelled again on the first
+// query after the grid changes.
+static uint32_t* area = NULL;
+static uint32_t area_version = 0;
+
+// Search state; a cell's cost, parent and heap position are only valid
+// while its stamp equals the current query's
+static uint32_t* stamp = NULL;
+static float* cost = NULL;
+static int* parent = NULL;
+static int* heap_pos = NULL;  // index in open, or CELL_CLOSED
+static OpenEntry* open = NULL;
+static int open_count = 0;
+static uint32_t query_stamp = 0;
+
+static CacheEntry cache[PATH_CACHE_ENTRIES];
+static int cache_next = 0;  // entry replaced by the next store (round robin)
+
+static PathStats stats;
+
+static inline int cell_index(int x, int y) {
+    return (y + 1) * stride + x + 1;
+}
+
+static inline PathPoint cell_point(int cell) {
+    return (PathPoint){cell % stride - 1, cell / stride - 1};
+}
+
+static inline void set_line_bit(uint64_t* line, int pos, int value) {
+    int bit = pos + LINE_PAD;
+    if (value) line[bit >> 6] |= 1ull << (bit & 63);
+    else line[bit >> 6] &= ~(1ull << (bit & 63));
+}
+
+// 64 bits of a line starting at pos (bit 0 = pos)
+static inline uint64_t line_window(const uint64_t* line, int pos) {
+    int bit = pos + LINE_PAD;
+    int word = bit >> 6, shift = bit & 63;
+    return shift ? (line[word] >> shift) | (line[word + 1] << (64 - shift)) : line[word];
+}
+
+static inline int sign(int v) {
+    return (v > 0) - (v < 0);
+}
+
+// Length of the shortest 8-way route between two cells on an open grid
+static inline float octile(PathPoint a, PathPoint b) {
+    int dx = a.x > b.x ? a.x - b.x : b.x - a.x;
+    int dy = a.y > b.y ? a.y - b.y : b.y - a.y;
+    return dx > dy ? (dx - dy) + SQRT2 * dy : (dy - dx) + SQRT2 * dx;
+}
+
+int path_grid_init(Arena* arena, int width, int height) {
+    grid_width = grid_height = stride = 0;
+    if (width <= 0 || height <= 0 || (int64_t)width * height > PATH_MAX_CELLS) {
+        printf("Unsupported path grid: %dx%d\n", width, height);
+        return 1;
+    }
+    
+    size_t cells = (size_t)(width + 2) * (height + 2);
+    blocked = (uint8_t*)arena_alloc(arena, cells);
+    stamp = (uint32_t*)arena_calloc(arena, cells * sizeof(*stamp));
+    cost = (float*)arena_alloc(arena, cells * sizeof(*cost));
+    parent = (int*)arena_alloc(arena, cells * sizeof(*parent));
+    heap_pos = (int*)arena_alloc(arena, cells * sizeof(*heap_pos));
+    area = (uint32_t*)arena_alloc(arena, cells * sizeof(*area));
+    open = (OpenEntry*)arena_alloc(arena, PATH_MAX_OPEN * sizeof(*open));
+    int longest = (width > height ? width : height) + 2;
+    int words = (longest + 2 * LINE_PAD + 63) / 64 + 1;
+    row_bits = (uint64_t*)arena_alloc(arena, (size_t)(height + 2) * words * sizeof(uint64_t));
+    col_bits = (uint64_t*)arena_alloc(arena, (size_t)(width + 2) * words * sizeof(uint64_t));
+    if (!blocked || !stamp || !cost || !parent || !heap_pos || !area || !open || !row_bits || !col_bits) {
+        printf("Arena too small for a %dx%d path grid\n", width, height);
+        return 1;
+    }
+    
+    // Everything walkable inside the border
+    grid_width = width;
+    grid_height = height;
+    stride = width + 2;
+    line_words = words;
+    memset(blocked, 1, cells);
+    memset(row_bits, 0xFF, (size_t)(height + 2) * words * sizeof(uint64_t));
+    memset(col_bits, 0xFF, (size_t)(width + 2) * words * sizeof(uint64_t));
+    for (int y = 0; y < height; y++) {
+        memset(blocked + cell_index(0, y), 0, width);
+        for (int x = 0; x < width; x++) {
+            set_line_bit(row_bits + (size_t)(y + 1) * words, x + 1, 0);
+            set_line_bit(col_bits + (size_t)(x + 1) * words, y + 1, 0);
+        }
+    }
+    query_stamp = 0;
+    grid_version++;
+    path_cache_clear();
+    return 0;
+}
+
+int path_grid_width(void) {
+    return grid_width;
+}
+
+int path_grid_height(void) {
+    return grid_height;
+}
+
+void path_set_blocked(int x, int y, int value) {
+    if (x < 0 || y < 0 || x >= grid_width || y >= grid_height) return;
+    uint8_t* cell = &blocked[cell_index(x, y)];
+    if (*cell == (value != 0)) return;
+    *cell = value != 0;
+    set_line_bit(row_bits + (size_t)(y + 1) * line_words, x + 1, *cell);
+    set_line_bit(col_bits + (size_t)(x + 1) * line_words, y + 1, *cell);
+    grid_version++;
+}
+
+int path_is_blocked(int x, int y) {
+    if (x < 0 || y < 0 || x >= grid_width || y >= grid_height) return 1;
+    return blocked[cell_index(x, y)];
+}
+
+// Flood fill every open cell with the number of its area. Diagonal moves
+// need both cells beside them open, so areas are 4-connected. The parent
+// array is free between queries and serves as the fill's stack.
+static void label_areas(void) {
+    size_t cells = (size_t)stride * (grid_height + 2);
+    memset(area, 0, cells * sizeof(*area));
+    uint32_t label = 0;
+    for (int y = 0; y < grid_height; y++) {
+        for (int c = cell_index(0, y), end = c + grid_width; c < end; c++) {
+            if (blocked[c] || area[c]) continue;
+            label++;
+            int top = 0;
+            parent[top++] = c;
+            area[c] = label;
+            while (top > 0) {
+                int n = parent[--top];
+                const int neighbours[4] = {n - 1, n + 1, n - stride, n + stride};
+                for (int i = 0; i < 4; i++) {
+                    int m = neighbours[i];
+                    if (blocked[m] || area[m]) continue;
+                    area[m] = label;
+                    parent[top++] = m;
+                }
+            }
+        }
+    }
+    area_version = grid_version;
+}
+
+// Binary min-heap on f, tracking each cell's position for decrease-key
+
+static void heap_place(int i, OpenEntry entry) {
+    open[i] = entry;
+    heap_pos[entry.cell] = i;
+}
+
+static void heap_up(int i) {
+    OpenEntry entry = open[i];
+    while (i > 0) {
+        int up = (i - 1) / 2;
+        if (open[up].f <= entry.f) break;
+        heap_place(i, open[up]);
+        i = up;
+    }
+    heap_place(i, entry);
+}
+
+static int heap_pop(void) {
+    int cell = open[0].cell;
+    OpenEntry last = open[--open_count];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= open_count) break;
+        if (child + 1 < open_count && open[child + 1].f < open[child].f) child++;
+        if (last.f <= open[child].f) break;
+        heap_place(i, open[child]);
+        i = child;
+    }
+    if (open_count > 0) heap_place(i, last);
+    heap_pos[cell] = CELL_CLOSED;
+    return cell;
+}
+
+// Jumps. Each scans from the cell after from in one direction and returns
+// the first cell a search has to stop at (the goal, or one where the route
+// may turn), or -1 if it runs into a wall.
+
+// Straight scans test 64 cells at a time on the line bitsets. Walking
+// along a line, a position is a jump point when the cell beside it on a
+// neighbouring line is open but the one beside the previous position was
+// not, i.e. a wall beside the route just ended and the route could turn
+// around it. target (-1 for none) is a position to stop at as well.
+static int scan_line(const uint64_t* line, const uint64_t* prev, const uint64_t* next, int pos, int dir,
+                     int target) {
+    if (dir > 0) {
+        for (int i = pos + 1;; i += 64) {
+            uint64_t wall = line_window(line, i);
+            uint64_t turn = (~line_window(prev, i) & line_window(prev, i - 1)) |
+                            (~line_window(next, i) & line_window(next, i - 1));
+            if (target >= i && target < i + 64) turn |= 1ull << (target - i);
+            if (turn && (!wall || __builtin_ctzll(turn) < __builtin_ctzll(wall))) return i + __builtin_ctzll(turn);
+            if (wall) return -1;
+        }
+    }
+    for (int i = pos - 1;; i -= 64) {
+        int base = i - 63;
+        uint64_t wall = line_window(line, base);
+        uint64_t turn = (~line_window(prev, base) & line_window(prev, base + 1)) |
+                        (~line_window(next, base) & line_window(next, base + 1));
+        if (target >= 0 && target <= i && target >= base) turn |= 1ull << (target - base);
+        if (turn && (!wall || __builtin_clzll(turn) < __builtin_clzll(wall))) return i - __builtin_clzll(turn);
+        if (wall) return -1;
+    }
+}
+
+// Straight jump from cell along a row (vertical == 0) or a column, in
+// direction dir (+-1)
+static int jump_straight(int from, int vertical, int dir, int goal) {
+    int x = from % stride, y = from / stride;
+    int goal_x = goal % stride, goal_y = goal / stride;
+    if (!vertical) {
+        const uint64_t* line = row_bits + (size_t)y * line_words;
+        int end = scan_line(line, line - line_words, line + line_words, x, dir, goal_y == y ? goal_x : -1);
+        return end < 0 ? -1 : y * stride + end;
+    }
+    const uint64_t* line = col_bits + (size_t)x * line_words;
+    int end = scan_line(line, line - line_words, line + line_words, y, dir, goal_x == x ? goal_y : -1);
+    return end < 0 ? -1 : end * stride + x;
+}
+
+// Diagonal: a cell is a jump point when either straight scan from it finds
+// one. The diagonal continues only while both cells it passes between are
+// open (no corner cutting); the caller checked that for the first step.
+static int jump_diagonal(int from, int dx, int dy, int goal) {
+    int vertical = dy * stride;
+    for (int n = from + dx + vertical;; n += dx + vertical) {
+        if (blocked[n]) return -1;
+        if (n == goal) return n;
+        if (jump_straight(n, 0, dx, goal) >= 0 || jump_straight(n, 1, dy, goal) >= 0) return n;
+        if (blocked[n + dx] || blocked[n + vertical]) return -1;
+    }
+}
+
+static inline void add_direction(int dirs[8][2], int* n, int dx, int dy) {
+    dirs[*n][0] = dx;
+    dirs[*n][1] = dy;
+    (*n)++;
+}
+
+// Directions worth jumping in from cell, given the direction it was reached
+// in (0, 0 for the start). Writes up to 8 (dx, dy) pairs; returns the count.
+static int prune_directions(int cell, int dx, int dy, int dirs[8][2]) {
+    int n = 0;
+    if (dx == 0 && dy == 0) {
+        for (int y = -1; y <= 1; y++) {
+            for (int x = -1; x <= 1; x++) {
+                if ((x == 0 && y == 0) || blocked[cell + x + y * stride]) continue;
+                if (x != 0 && y != 0 && (blocked[cell + x] || blocked[cell + y * stride])) continue;
+                add_direction(dirs, &n, x, y);
+            }
+        }
+        return n;
+    }
+    
+    if (dx != 0 && dy != 0) {
+        // Diagonal: carry on, or split into its two straight parts
+        int open_x = !blocked[cell + dx];
+        int open_y = !blocked[cell + dy * stride];
+        if (open_y) add_direction(dirs, &n, 0, dy);
+        if (open_x) add_direction(dirs, &n, dx, 0);
+        if (open_x && open_y) add_direction(dirs, &n, dx, dy);
+        return n;
+    }
+    
+    // Straight: carry on, and turn to either side that is open (the jump
+    // stopped here because a wall beside the route ended)
+    int px = dy != 0, py = dx != 0;  // perpendicular axis
+    int ahead = !blocked[cell + dx + dy * stride];
+    int left = !blocked[cell + px + py * stride];
+    int right = !blocked[cell - px - py * stride];
+    if (ahead) {
+        add_direction(dirs, &n, dx, dy);
+        if (left) add_direction(dirs, &n, dx + px, dy + py);
+        if (right) add_direction(dirs, &n, dx - px, dy - py);
+    }
+    if (left) add_direction(dirs, &n, px, py);
+    if (right) add_direction(dirs, &n, -px, -py);
+    return n;
+}
+
+// Walk parents back from goal into out. Returns the waypoint count, or 0 if
+// the path has too many.
+static int write_path(int start, int goal, Path* out) {
+    int count = 1;
+    for (int c = goal; c != start; c = parent[c]) count++;
+    if (count > PATH_MAX_WAYPOINTS) return 0;
+    
+    int i = count;
+    for (int c = goal;; c = parent[c]) {
+        out->points[--i] = cell_point(c);
+        if (c == start) break;
+    }
+    out->count = count;
+    out->cost = cost[goal];
+    return count;
+}
+
+static int search(int start, int goal, Path* out) {
+    // A new stamp makes every cell unvisited; on wrap-around clear for real
+    if (++query_stamp == 0) {
+        memset(stamp, 0, (size_t)stride * (grid_height + 2) * sizeof(*stamp));
+        query_stamp = 1;
+    }
+    
+    PathPoint goal_point = cell_point(goal);
+    stamp[start] = query_stamp;
+    cost[start] = 0.0f;
+    parent[start] = start;
+    open_count = 0;
+    heap_place(open_count++, (OpenEntry){octile(cell_point(start), goal_point), start});
+    
+    while (open_count > 0) {
+        int cell = heap_pop();
+        stats.cells_expanded++;
+        if (cell == goal) return write_path(start, goal, out);
+        
+        PathPoint p = cell_point(cell);
+        PathPoint from = cell_point(parent[cell]);
+        int dirs[8][2];
+        int dir_count = prune_directions(cell, sign(p.x - from.x), sign(p.y - from.y), dirs);
+        for (int d = 0; d < dir_count; d++) {
+            int dx = dirs[d][0], dy = dirs[d][1];
+            int next = dx != 0 && dy != 0 ? jump_diagonal(cell, dx, dy, goal)
+                     : dx != 0 ? jump_straight(cell, 0, dx, goal)
+                     : jump_straight(cell, 1, dy, goal);
+            if (next < 0) continue;
+            
+            PathPoint q = cell_point(next);
+            float g = cost[cell] + octile(p, q);
+            if (stamp[next] != query_stamp) {
+                if (open_count == PATH_MAX_OPEN) return 0;
+                stamp[next] = query_stamp;
+                cost[next] = g;
+                parent[next] = cell;
+                heap_place(open_count, (OpenEntry){g + octile(q, goal_point), next});
+                heap_up(open_count++);
+            } else if (heap_pos[next] != CELL_CLOSED && g < cost[next]) {
+                cost[next] = g;
+                parent[next] = cell;
+                open[heap_pos[next]].f = g + octile(q, goal_point);
+                heap_up(heap_pos[next]);
+            }
+        }
+    }
+    return 0;
+}
+
+// Whether p lies on the segment from a towards b, b itself excluded
+static int on_segment(PathPoint a, PathPoint b, PathPoint p) {
+    int dx = sign(b.x - a.x), dy = sign(b.y - a.y);
+    int steps = dx != 0 ? (p.x - a.x) * dx : (p.y - a.y) * dy;
+    int length = dx != 0 ? (b.x - a.x) * dx : (b.y - a.y) * dy;
+    return steps >= 0 && steps < length && p.x == a.x + steps * dx && p.y == a.y + steps * dy;
+}
+
+// Rest of a cached path to goal that passes through start, written to out
+static int cache_lookup(PathPoint start, PathPoint goal, Path* out) {
+    for (int e = 0; e < PATH_CACHE_ENTRIES; e++) {
+        const CacheEntry* entry = &cache[e];
+        if (entry->count == 0 || entry->version != grid_version ||
+            entry->goal.x != goal.x || entry->goal.y != goal.y) continue;
+        
+        for (int k = 0; k + 1 < entry->count; k++) {
+            if (!on_segment(entry->points[k], entry->points[k + 1], start)) continue;
+            
+            int count = entry->count - k;
+            out->points[0] = start;
+            memcpy(&out->points[1], &entry->points[k + 1], (count - 1) * sizeof(PathPoint));
+            out->count = count;
+            out->cost = 0.0f;
+            for (int i = 0; i + 1 < count; i++) out->cost += octile(out->points[i], out->points[i + 1]);
+            return count;
+        }
+    }
+    return 0;
+}
+
+static void cache_store(const Path* path) {
+    CacheEntry* entry = &cache[cache_next];
+    cache_next = (cache_next + 1) % PATH_CACHE_ENTRIES;
+    entry->goal = path->points[path->count - 1];
+    entry->version = grid_version;
+    entry->count = path->count;
+    memcpy(entry->points, path->points, path->count * sizeof(PathPoint));
+}
+
+int path_find(int sx, int sy, int gx, int gy, Path* out) {
+    stats.queries++;
+    out->count = 0;
+    out->cost = 0.0f;
+    if (path_is_blocked(sx, sy) || path_is_blocked(gx, gy)) {
+        stats.failures++;
+        return 0;
+    }
+    
+    PathPoint start = {sx, sy}, goal = {gx, gy};
+    if (sx == gx && sy == gy) {
+        out->points[0] = start;
+        out->count = 1;
+        return 1;
+    }
+    if (cache_lookup(start, goal, out)) {
+        stats.cache_hits++;
+        return out->count;
+    }
+    
+    double t0 = platform_now_ms();
+    if (area_version != grid_version) label_areas();
+    int count = 0;
+    if (area[cell_index(sx, sy)] == area[cell_index(gx, gy)]) count = search(cell_index(sx, sy), cell_index(gx, gy), out);
+    stats.search_ms += platform_now_ms() - t0;
+    stats.searches++;
+    if (count == 0) {
+        stats.failures++;
+        return 0;
+    }
+    cache_store(out);
+    return count;
+}
+
+void path_cache_clear(void) {
+    for (int e = 0; e < PATH_CACHE_ENTRIES; e++) cache[e].count = 0;
+    cache_next = 0;
+}
+
+const PathStats* path_stats(void) {
+    return &stats;
+}
+
+void path_stats_reset(void) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+void path_report(void) {
+    if (stats.queries == 0) return;
+    printf("Paths: %llu queries, %llu from cache, %llu searched (%.3f ms avg, %.0f jump points avg), %llu failed\n",
+           (unsigned long long)stats.queries, (unsigned long long)stats.cache_hits,
+           (unsigned long long)stats.searches, stats.searches ? stats.search_ms / stats.searches : 0.0,
+           stats.searches ? (double)stats.cells_expanded / stats.searches : 0.0,
+           (unsigned long long)stats.failures);
+}
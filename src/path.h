@@ -0,0 +1,73 @@
+#ifndef PATH_H
+#define PATH_H
+
+#include <stdint.h>
+#include "arena.h"
+
+// Grid pathfinding
+//
+// Jump point search over a grid of walkable and blocked cells, with 8-way
+// moves that never cut a blocked corner. Straight runs with nothing beside
+// them are skipped in one scan instead of being pushed cell by cell, so the
+// open set only ever holds the few cells where the route can turn. All
+// search state (open heap, costs, parents) is allocated with the grid, and
+// every cell carries the number of the query that last touched it, so a
+// query neither allocates nor clears anything.
+//
+// Found paths are kept in a cache of PATH_CACHE_ENTRIES. A query whose goal
+// matches a cached path and whose start lies on it (an agent following the
+// path, or one that joined it later) takes the rest of that path without
+// searching. Any change to the grid invalidates the cache.
+//
+// Not thread safe: query from one thread.
+
+#define PATH_MAX_CELLS (4096 * 4096)
+#define PATH_MAX_WAYPOINTS 256  // longer paths fail; agents plan to a nearer goal
+#define PATH_CACHE_ENTRIES 64
+
+typedef struct {
+    int x, y;
+} PathPoint;
+
+// Turning points from start to goal; consecutive points are joined by a
+// straight or 45-degree line
+typedef struct {
+    int count;   // 0 if there is no path
+    float cost;  // length in cells, diagonal steps counting sqrt(2)
+    PathPoint points[PATH_MAX_WAYPOINTS];
+} Path;
+
+typedef struct {
+    uint64_t queries;
+    uint64_t cache_hits;
+    uint64_t searches;
+    uint64_t failures;        // no path, or more than PATH_MAX_WAYPOINTS
+    uint64_t cells_expanded;  // jump points taken off the open set
+    double search_ms;
+} PathStats;
+
+// Allocate a width x height grid, all walkable, and its search state from
+// arena (21 bytes per cell plus a 2 MB open set). Returns 0 on success.
+int path_grid_init(Arena* arena, int width, int height);
+
+int path_grid_width(void);
+int path_grid_height(void);
+
+// Cells outside the grid count as blocked
+void path_set_blocked(int x, int y, int blocked);
+int path_is_blocked(int x, int y);
+
+// Find a path from (sx, sy) to (gx, gy), from the cache if possible. Returns
+// the number of waypoints written to out (0 if there is none).
+int path_find(int sx, int sy, int gx, int gy, Path* out);
+
+// Forget every cached path (grid edits do this themselves)
+void path_cache_clear(void);
+
+const PathStats* path_stats(void);
+void path_stats_reset(void);
+
+// Print the stats
+void path_report(void);
+
+#endif // PATH_H
@@ -0,0 +1,34 @@
+#include "platform.h"
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/threading.h>
+#endif
+
+double platform_now_ms(void) {
+#ifdef __EMSCRIPTEN__
+    return emscripten_get_now();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#endif
+}
+
+void platform_sleep_ms(double ms) {
+    if (ms <= 0.0) return;
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ms / 1000.0);
+    ts.tv_nsec = (long)((ms - ts.tv_sec * 1000.0) * 1000000.0);
+    nanosleep(&ts, NULL);
+}
+
+int platform_cpu_count(void) {
+#ifdef __EMSCRIPTEN__
+    int n = emscripten_num_logical_cores();
+#else
+    int n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return n > 0 ? n : 1;
+}
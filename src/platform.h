@@ -0,0 +1,22 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+// Thin shims so simulation code builds both under Emscripten and natively
+// (native builds are headless and used for tests/benchmarks on Linux)
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#else
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+
+// Monotonic time in milliseconds
+double platform_now_ms(void);
+
+// Sleep the calling thread (never call on the browser main thread)
+void platform_sleep_ms(double ms);
+
+// Number of logical CPUs available to worker threads
+int platform_cpu_count(void);
+
+#endif // PLATFORM_H
@@ -0,0 +1,219 @@
+#include "render_layer.h"
+#include "gpu_resources.h"
+#include "gpu_trace.h"
+#include <stdio.h>
+#include <string.h>
+
+// Composite WebGPU objects, shared by all layers
+static WGPUDevice layer_device = NULL;
+static WGPUTextureFormat layer_format = WGPUTextureFormat_BGRA8Unorm;
+static WGPUBindGroupLayout layer_bind_group_layout = NULL;
+static WGPURenderPipeline composite_pipeline = NULL;
+
+void render_layers_init(WGPUDevice device, WGPUTextureFormat format) {
+    layer_device = device;
+    layer_format = format;
+    
+    // Create bind group layout (the layer texture, read with textureLoad)
+    WGPUBindGroupLayoutEntry bgl_entry = {
+        .binding = 0,
+        .visibility = WGPUShaderStage_Fragment,
+        .texture = {
+            .sampleType = WGPUTextureSampleType_Float,
+            .viewDimension = WGPUTextureViewDimension_2D,
+            .multisampled = false,
+        },
+    };
+    WGPUBindGroupLayoutDescriptor bgl_desc = {
+        .entryCount = 1,
+        .entries = &bgl_entry,
+    };
+    layer_bind_group_layout = gpu_create_bind_group_layout(layer_device, &bgl_desc, "layers");
+}
+
+void render_layers_create_pipeline(const char* shader_source) {
+    if (!layer_device || !shader_source) return;
+    
+    // Create shader module
+    WGPUShaderSourceWGSL wgsl_source = {
+        .chain = {.sType = WGPUSType_ShaderSourceWGSL},
+        .code = {.data = shader_source, .length = strlen(shader_source)},
+    };
+    WGPUShaderModuleDescriptor shader_desc = {
+        .nextInChain = (WGPUChainedStruct*)&wgsl_source,
+    };
+    WGPUShaderModule shader = gpu_create_shader_module(layer_device, &shader_desc, "layers");
+    
+    // Create pipeline layout
+    WGPUPipelineLayoutDescriptor pl_desc = {
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &layer_bind_group_layout,
+    };
+    WGPUPipelineLayout pipeline_layout = gpu_create_pipeline_layout(layer_device, &pl_desc, "layers");
+    
+    // Layers are premultiplied, so "over" is One, OneMinusSrcAlpha
+    WGPUBlendState blend_state = {
+        .color = {
+            .srcFactor = WGPUBlendFactor_One,
+            .dstFactor = WGPUBlendFactor_OneMinusSrcAlpha,
+            .operation = WGPUBlendOperation_Add,
+        },
+        .alpha = {
+            .srcFactor = WGPUBlendFactor_One,
+            .dstFactor = WGPUBlendFactor_OneMinusSrcAlpha,
+            .operation = WGPUBlendOperation_Add,
+        },
+    };
+    
+    WGPUColorTargetState color_target = {
+        .format = layer_format,
+        .blend = &blend_state,
+        .writeMask = WGPUColorWriteMask_All,
+    };
+    
+    WGPUFragmentState fragment = {
+        .module = shader,
+        .entryPoint = {.data = "fs_main", .length = 7},
+        .targetCount = 1,
+        .targets = &color_target,
+    };
+    
+    // Create render pipeline (no vertex buffers: one generated triangle)
+    WGPURenderPipelineDescriptor rp_desc = {
+        .layout = pipeline_layout,
+        .vertex = {
+            .module = shader,
+            .entryPoint = {.data = "vs_main", .length = 7},
+        },
+        .fragment = &fragment,
+        .primitive = {
+            .topology = WGPUPrimitiveTopology_TriangleList,
+            .frontFace = WGPUFrontFace_CCW,
+            .cullMode = WGPUCullMode_None,
+        },
+        .multisample = {
+            .count = 1,
+            .mask = 0xFFFFFFFF,
+        },
+    };
+    composite_pipeline = gpu_create_render_pipeline(layer_device, &rp_desc, "layers");
+    
+    // Cleanup
+    gpu_release_shader_module(shader);
+    gpu_release_pipeline_layout(pipeline_layout);
+}
+
+void render_layers_shutdown(void) {
+    gpu_release_render_pipeline(composite_pipeline);
+    gpu_release_bind_group_layout(layer_bind_group_layout);
+    composite_pipeline = NULL;
+    layer_bind_group_layout = NULL;
+    layer_device = NULL;
+}
+
+// Drop the layer's GPU objects, keeping its name and counters
+static void release_texture(RenderLayer* layer) {
+    gpu_release_bind_group(layer->bind_group);
+    gpu_release_view(layer->view);
+    gpu_release_texture(layer->texture);
+    layer->bind_group = NULL;
+    layer->view = NULL;
+    layer->texture = NULL;
+}
+
+static int create_texture(RenderLayer* layer) {
+    WGPUTextureDescriptor tex_desc = {
+        .usage = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_TextureBinding,
+        .dimension = WGPUTextureDimension_2D,
+        .size = {(uint32_t)layer->width, (uint32_t)layer->height, 1},
+        .format = layer_format,
+        .mipLevelCount = 1,
+        .sampleCount = 1,
+    };
+    layer->texture = gpu_create_texture(layer_device, &tex_desc, "layers");
+    if (!layer->texture) {
+        printf("Failed to create render layer: %s (%dx%d)\n", layer->name, layer->width, layer->height);
+        return 1;
+    }
+    layer->view = gpu_create_view(layer->texture, NULL, "layers");
+    
+    WGPUBindGroupEntry bg_entry = {
+        .binding = 0,
+        .textureView = layer->view,
+    };
+    WGPUBindGroupDescriptor bg_desc = {
+        .layout = layer_bind_group_layout,
+        .entryCount = 1,
+        .entries = &bg_entry,
+    };
+    layer->bind_group = gpu_create_bind_group(layer_device, &bg_desc, "layers");
+    layer->dirty = 1;
+    return 0;
+}
+
+int render_layer_init(RenderLayer* layer, const char* name, int width, int height) {
+    memset(layer, 0, sizeof(*layer));
+    layer->name = name;
+    layer->width = width > 0 ? width : 1;
+    layer->height = height > 0 ? height : 1;
+    if (!layer_device) return 1;
+    return create_texture(layer);
+}
+
+void render_layer_release(RenderLayer* layer) {
+    release_texture(layer);
+}
+
+void render_layer_resize(RenderLayer* layer, int width, int height) {
+    if (width < 1) width = 1;
+    if (height < 1) height = 1;
+    if (!layer_device || (layer->texture && width == layer->width && height == layer->height)) return;
+    
+    release_texture(layer);
+    layer->width = width;
+    layer->height = height;
+    create_texture(layer);
+}
+
+void render_layer_mark_dirty(RenderLayer* layer) {
+    layer->dirty = 1;
+}
+
+WGPURenderPassEncoder render_layer_begin(RenderLayer* layer, WGPUCommandEncoder encoder) {
+    if (!layer->dirty || !layer->view) return NULL;
+    
+    WGPURenderPassColorAttachment color_attachment = {
+        .view = layer->view,
+        .depthSlice = WGPU_DEPTH_SLICE_UNDEFINED,
+        .loadOp = WGPULoadOp_Clear,
+        .storeOp = WGPUStoreOp_Store,
+        .clearValue = {0.0f, 0.0f, 0.0f, 0.0f},
+    };
+    WGPURenderPassDescriptor pass_desc = {
+        .colorAttachmentCount = 1,
+        .colorAttachments = &color_attachment,
+    };
+    return gpu_begin_pass(encoder, &pass_desc);
+}
+
+void render_layer_end(RenderLayer* layer, WGPURenderPassEncoder pass) {
+    wgpuRenderPassEncoderEnd(pass);
+    wgpuRenderPassEncoderRelease(pass);
+    layer->dirty = 0;
+    layer->redraw_count++;
+}
+
+void render_layer_composite(RenderLayer* layer, WGPURenderPassEncoder pass) {
+    if (!composite_pipeline || !layer->bind_group) return;
+    
+    gpu_set_pipeline(pass, composite_pipeline);
+    gpu_set_bind_group(pass, 0, layer->bind_group);
+    gpu_draw(pass, 3, 1);
+    layer->composite_count++;
+}
+
+void render_layer_report(const RenderLayer* layer) {
+    printf("Layer %s: %dx%d, recorded %u of %u frames (%.1f%%)\n",
+           layer->name, layer->width, layer->height, layer->redraw_count, layer->composite_count,
+           layer->composite_count ? 100.0 * layer->redraw_count / layer->composite_count : 0.0);
+}
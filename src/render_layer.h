@@ -0,0 +1,60 @@
+#ifndef RENDER_LAYER_H
+#define RENDER_LAYER_H
+
+#include <stdint.h>
+#include <webgpu/webgpu.h>
+
+// Retained render layers
+//
+// A layer owns an offscreen texture the size of the canvas. Its content is
+// recorded only on frames where it has been marked dirty (or resized); on
+// every other frame it is composited onto the surface with one fullscreen
+// triangle, so static UI costs the same however many glyphs it holds.
+// Layers hold premultiplied color, which is what the text and sprite
+// pipelines produce when drawing into a transparent target.
+
+typedef struct {
+    const char* name;
+    WGPUTexture texture;
+    WGPUTextureView view;
+    WGPUBindGroup bind_group;
+    int width;
+    int height;
+    int dirty;                 // content must be recorded again
+    uint32_t redraw_count;     // frames the content was recorded
+    uint32_t composite_count;  // frames the layer was composited
+} RenderLayer;
+
+// Initialize layer compositing (after the WebGPU device is ready)
+void render_layers_init(WGPUDevice device, WGPUTextureFormat format);
+
+// Create the composite pipeline from WGSL source
+void render_layers_create_pipeline(const char* shader_source);
+
+// Release the composite pipeline (after every layer has been released)
+void render_layers_shutdown(void);
+
+// Create a layer's texture. The name must outlive the layer. Returns 0 on success.
+int render_layer_init(RenderLayer* layer, const char* name, int width, int height);
+
+void render_layer_release(RenderLayer* layer);
+
+// Match the canvas size; a new size recreates the texture and marks it dirty
+void render_layer_resize(RenderLayer* layer, int width, int height);
+
+void render_layer_mark_dirty(RenderLayer* layer);
+
+// If the layer is dirty, begin a pass on encoder that clears it to
+// transparent and return it; draw the content, then call render_layer_end.
+// Returns NULL while the retained content is still valid.
+WGPURenderPassEncoder render_layer_begin(RenderLayer* layer, WGPUCommandEncoder encoder);
+
+void render_layer_end(RenderLayer* layer, WGPURenderPassEncoder pass);
+
+// Blend the layer over a pass whose target is the same size as the layer
+void render_layer_composite(RenderLayer* layer, WGPURenderPassEncoder pass);
+
+// Print how often the layer was recorded versus composited
+void render_layer_report(const RenderLayer* layer);
+
+#endif // RENDER_LAYER_H
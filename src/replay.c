@@ -0,0 +1,354 @@
+#include "replay.h"
+#include "game.h"
+#include "platform.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Record tags
+#define REC_PARAMS 'P'  // f32 dt, varint width, varint height
+#define REC_EVENT 'E'   // u8 key, u8 pressed, varint offset_us
+#define REC_SPAWN 'S'   // f32 x, y, angle, speed
+#define REC_END 'X'     // no payload
+
+#define REPLAY_INITIAL_CAPACITY 4096
+#define REPLAY_END_RECORD_MAX 11  // tag plus a 64-bit varint
+
+// Recorder state. The buffer is appended to by the simulation thread and may
+// be copied out by the main thread, so access goes through a mutex (taken at
+// most a few times per tick).
+static pthread_mutex_t rec_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint8_t* rec_data = NULL;
+static size_t rec_size = 0;
+static size_t rec_capacity = 0;
+static int rec_armed = 0;
+static atomic_int rec_active = 0;  // read without the lock by the hooks
+static uint64_t rec_last_tick = 0;
+static atomic_uint_fast64_t rec_end_tick = 0;  // ticks whose records are all in
+static float rec_dt = 0.0f;
+static int rec_width = -1;
+static int rec_height = -1;
+
+static void rec_reserve(size_t extra) {
+    if (rec_size + extra <= rec_capacity) return;
+    size_t cap = rec_capacity ? rec_capacity : REPLAY_INITIAL_CAPACITY;
+    while (cap < rec_size + extra) cap *= 2;
+    uint8_t* data = (uint8_t*)realloc(rec_data, cap);
+    if (!data) {
+        printf("Replay recording out of memory, stopping\n");
+        rec_active = 0;
+        return;
+    }
+    rec_data = data;
+    rec_capacity = cap;
+}
+
+static void put_u8(uint8_t v) {
+    rec_reserve(1);
+    if (rec_active) rec_data[rec_size++] = v;
+}
+
+static void put_varint(uint64_t v) {
+    while (v >= 0x80) {
+        put_u8((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    put_u8((uint8_t)v);
+}
+
+static void put_f32(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    for (int i = 0; i < 4; i++) put_u8((uint8_t)(bits >> (i * 8)));
+}
+
+// Tag plus tick delta since the previous record
+static void put_record(uint8_t tag, uint64_t tick) {
+    put_u8(tag);
+    put_varint(tick - rec_last_tick);
+    rec_last_tick = tick;
+}
+
+// End record for a recording still in progress, which copies and saves
+// append so they can be replayed. Call with rec_lock held. Returns its size.
+static size_t end_record(uint8_t out[REPLAY_END_RECORD_MAX]) {
+    if (!rec_active) return 0;
+    uint64_t end = atomic_load_explicit(&rec_end_tick, memory_order_acquire);
+    uint64_t delta = end > rec_last_tick ? end - rec_last_tick : 0;
+    size_t size = 0;
+    out[size++] = REC_END;
+    while (delta >= 0x80) {
+        out[size++] = (uint8_t)(delta | 0x80);
+        delta >>= 7;
+    }
+    out[size++] = (uint8_t)delta;
+    return size;
+}
+
+void replay_record_start(void) {
+    pthread_mutex_lock(&rec_lock);
+    rec_armed = 1;
+    pthread_mutex_unlock(&rec_lock);
+}
+
+void replay_record_stop(void) {
+    pthread_mutex_lock(&rec_lock);
+    if (rec_active) {
+        put_record(REC_END, atomic_load_explicit(&rec_end_tick, memory_order_relaxed));
+        printf("Replay recording stopped (%zu bytes)\n", rec_size);
+    }
+    rec_active = 0;
+    rec_armed = 0;
+    pthread_mutex_unlock(&rec_lock);
+}
+
+int replay_is_recording(void) {
+    return rec_active;
+}
+
+void replay_record_init(int canvas_width, int canvas_height) {
+    pthread_mutex_lock(&rec_lock);
+    if (rec_armed) {
+        rec_size = 0;
+        rec_active = 1;
+        rec_last_tick = 0;
+        atomic_store_explicit(&rec_end_tick, 0, memory_order_relaxed);
+        rec_dt = 0.0f;
+        rec_width = -1;
+        rec_height = -1;
+        for (int i = 0; i < 4; i++) put_u8((uint8_t)REPLAY_MAGIC[i]);
+        put_u8(REPLAY_VERSION);
+        put_varint((uint64_t)canvas_width);
+        put_varint((uint64_t)canvas_height);
+    }
+    pthread_mutex_unlock(&rec_lock);
+}
+
+void replay_record_step(uint64_t tick, float dt, int canvas_width, int canvas_height) {
+    if (!rec_active) return;
+    if (dt == rec_dt && canvas_width == rec_width && canvas_height == rec_height) return;
+    
+    pthread_mutex_lock(&rec_lock);
+    rec_dt = dt;
+    rec_width = canvas_width;
+    rec_height = canvas_height;
+    put_record(REC_PARAMS, tick);
+    put_f32(dt);
+    put_varint((uint64_t)canvas_width);
+    put_varint((uint64_t)canvas_height);
+    pthread_mutex_unlock(&rec_lock);
+}
+
+void replay_record_event(uint64_t tick, int key_code, int pressed, uint32_t offset_us) {
+    if (!rec_active) return;
+    
+    pthread_mutex_lock(&rec_lock);
+    put_record(REC_EVENT, tick);
+    put_u8((uint8_t)key_code);
+    put_u8((uint8_t)(pressed != 0));
+    put_varint(offset_us);
+    pthread_mutex_unlock(&rec_lock);
+}
+
+void replay_record_step_end(uint64_t tick) {
+    // Released after the step's records, so a copy that ends at this tick
+    // also holds all of them
+    if (rec_active) atomic_store_explicit(&rec_end_tick, tick + 1, memory_order_release);
+}
+
+void replay_record_spawn(uint64_t tick, float x, float y, float angle, float speed) {
+    if (!rec_active) return;
+    
+    pthread_mutex_lock(&rec_lock);
+    put_record(REC_SPAWN, tick);
+    put_f32(x);
+    put_f32(y);
+    put_f32(angle);
+    put_f32(speed);
+    pthread_mutex_unlock(&rec_lock);
+}
+
+EMSCRIPTEN_KEEPALIVE
+uint8_t* replay_copy_alloc(size_t* size) {
+    *size = 0;
+    pthread_mutex_lock(&rec_lock);
+    uint8_t end[REPLAY_END_RECORD_MAX];
+    size_t end_size = end_record(end);
+    uint8_t* out = rec_size > 0 ? (uint8_t*)malloc(rec_size + end_size) : NULL;
+    if (out) {
+        memcpy(out, rec_data, rec_size);
+        memcpy(out + rec_size, end, end_size);
+        *size = rec_size + end_size;
+    }
+    pthread_mutex_unlock(&rec_lock);
+    return out;
+}
+
+int replay_save(const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        printf("Failed to open replay file for writing: %s\n", path);
+        return 1;
+    }
+    
+    pthread_mutex_lock(&rec_lock);
+    uint8_t end[REPLAY_END_RECORD_MAX];
+    size_t end_size = end_record(end);
+    size_t written = fwrite(rec_data, 1, rec_size, f);
+    written += fwrite(end, 1, end_size, f);
+    size_t size = rec_size + end_size;
+    pthread_mutex_unlock(&rec_lock);
+    fclose(f);
+    
+    if (written != size) {
+        printf("Failed to write replay file: %s\n", path);
+        return 1;
+    }
+    printf("Saved replay: %s (%zu bytes)\n", path, size);
+    return 0;
+}
+
+// Bounds-checked reader over a recording
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    int error;
+} ReplayReader;
+
+static uint8_t get_u8(ReplayReader* r) {
+    if (r->pos >= r->size) {
+        r->error = 1;
+        return 0;
+    }
+    return r->data[r->pos++];
+}
+
+static uint64_t get_varint(ReplayReader* r) {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t b = get_u8(r);
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) return v;
+    }
+    r->error = 1;
+    return 0;
+}
+
+static float get_f32(ReplayReader* r) {
+    uint32_t bits = 0;
+    for (int i = 0; i < 4; i++) bits |= (uint32_t)get_u8(r) << (i * 8);
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+int replay_run(const uint8_t* data, size_t size, ReplayResult* out) {
+    ReplayReader r = {data, size, 0, 0};
+    
+    for (int i = 0; i < 4; i++) {
+        if (get_u8(&r) != (uint8_t)REPLAY_MAGIC[i]) {
+            printf("Not a replay file\n");
+            return 1;
+        }
+    }
+    if (get_u8(&r) != REPLAY_VERSION) {
+        printf("Unsupported replay version\n");
+        return 1;
+    }
+    
+    int width = (int)get_varint(&r);
+    int height = (int)get_varint(&r);
+    float dt = 1.0f / 60.0f;
+    if (r.error) return 1;
+    
+    double start = platform_now_ms();
+    game_init(width, height);
+    
+    // Every step starts at input time 0, so an event's timestamp is just its
+    // offset inside the step and quantizes back to the recorded value
+    uint64_t tick = 0;
+    uint64_t record_tick = 0;
+    int done = 0;
+    
+    while (!done) {
+        uint8_t tag = get_u8(&r);
+        record_tick += get_varint(&r);
+        if (r.error) break;
+        
+        // Run the steps that happened before this record
+        while (tick < record_tick) {
+            game_set_input_clock(0.0);
+            game_update(dt, width, height);
+            tick++;
+        }
+        
+        switch (tag) {
+            case REC_PARAMS:
+                dt = get_f32(&r);
+                width = (int)get_varint(&r);
+                height = (int)get_varint(&r);
+                break;
+            case REC_EVENT: {
+                int key = get_u8(&r);
+                int pressed = get_u8(&r);
+                double offset_ms = get_varint(&r) / 1000.0;
+                if (offset_ms > dt * 1000.0) offset_ms = dt * 1000.0;  // Undo rounding past step end
+                game_push_input(key, pressed, offset_ms);
+                break;
+            }
+            case REC_SPAWN: {
+                float x = get_f32(&r);
+                float y = get_f32(&r);
+                float angle = get_f32(&r);
+                float speed = get_f32(&r);
+                game_spawn_entity(x, y, angle, speed);
+                break;
+            }
+            case REC_END:
+                done = 1;
+                break;
+            default:
+                r.error = 1;
+                break;
+        }
+        if (r.error) break;
+    }
+    
+    if (r.error || !done) {
+        printf("Replay data is truncated or corrupt at byte %zu\n", r.pos);
+        return 1;
+    }
+    
+    out->ticks = tick;
+    out->elapsed_ms = platform_now_ms() - start;
+    out->ticks_per_sec = out->elapsed_ms > 0.0 ? tick * 1000.0 / out->elapsed_ms : 0.0;
+    out->state_hash = game_state_hash();
+    return 0;
+}
+
+int replay_run_file(const char* path, ReplayResult* out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        printf("Failed to open replay file: %s\n", path);
+        return 1;
+    }
+    
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    
+    uint8_t* data = (uint8_t*)malloc(size > 0 ? size : 1);
+    if (!data) {
+        fclose(f);
+        return 1;
+    }
+    size_t read = fread(data, 1, size, f);
+    fclose(f);
+    
+    int result = replay_run(data, read, out);
+    free(data);
+    return result;
+}
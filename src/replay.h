@@ -0,0 +1,59 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Session recording and deterministic replay
+//
+// A recording holds the game_init parameters followed by a compact stream of
+// records, each tagged with the tick it applies to (delta-encoded varints):
+// step parameter changes (dt, playfield size), key events with their
+// microsecond offset inside the step, and entity spawns. Replaying feeds the
+// same stream back through game_update with no GPU, as fast as possible.
+
+#define REPLAY_MAGIC "PFRP"
+#define REPLAY_VERSION 3  // bumped when the simulation changes, so old recordings are refused
+
+typedef struct {
+    uint64_t ticks;        // simulation steps replayed
+    double elapsed_ms;     // wall time spent replaying
+    double ticks_per_sec;  // replay throughput
+    uint64_t state_hash;   // game_state_hash() after the final tick
+} ReplayResult;
+
+// Arm the recorder; the next game_init starts a new recording
+void replay_record_start(void);
+
+// Stop recording and append the end marker
+void replay_record_stop(void);
+
+// Whether a recording is in progress
+int replay_is_recording(void);
+
+// Recording hooks (called by game.c)
+void replay_record_init(int canvas_width, int canvas_height);
+void replay_record_step(uint64_t tick, float dt, int canvas_width, int canvas_height);
+void replay_record_step_end(uint64_t tick);
+void replay_record_event(uint64_t tick, int key_code, int pressed, uint32_t offset_us);
+void replay_record_spawn(uint64_t tick, float x, float y, float angle, float speed);
+
+// Copy the recording so far into a malloc'd buffer the caller frees, ended
+// as if recording stopped after the last completed tick, so it can be
+// replayed. Sets *size; returns NULL if nothing was recorded (or out of
+// memory). Safe to call while recording: the copy is taken in one locked
+// step, so a sim thread appending meanwhile cannot truncate it.
+uint8_t* replay_copy_alloc(size_t* size);
+
+// Write the recording to a file, ended like replay_copy_alloc; returns 0 on
+// success
+int replay_save(const char* path);
+
+// Replay a recording headlessly. Returns 0 on success, nonzero if the data
+// is malformed.
+int replay_run(const uint8_t* data, size_t size, ReplayResult* out);
+
+// Load and replay a recording file
+int replay_run_file(const char* path, ReplayResult* out);
+
+#endif // REPLAY_H
@@ -0,0 +1,370 @@
+#include "resolution.h"
+#include "gpu_resources.h"
+#include "gpu_trace.h"
+#include "platform.h"
+#include <stdio.h>
+#include <string.h>
+
+// Uniform data (matches upscale.wgsl)
+typedef struct {
+    float uv_scale[2];  // drawn part of the target, as a fraction of it
+    float uv_max[2];    // last texel center inside it, so filtering never reads past
+} UpscaleUniforms;
+
+// Upscale WebGPU objects
+static WGPUDevice res_device = NULL;
+static WGPUQueue res_queue = NULL;
+static WGPUTextureFormat res_format = WGPUTextureFormat_BGRA8Unorm;
+static WGPUBindGroupLayout res_bind_group_layout = NULL;
+static WGPURenderPipeline upscale_pipeline = NULL;
+static WGPUBuffer upscale_uniform_buffer = NULL;
+static WGPUSampler upscale_sampler = NULL;
+
+// Scene target, always full surface size
+static WGPUTexture scene_texture = NULL;
+static WGPUTextureView scene_view = NULL;
+static WGPUBindGroup scene_bind_group = NULL;
+static int target_width = 0;
+static int target_height = 0;
+
+// Controller state
+static float scale = RESOLUTION_MAX_SCALE;
+static int locked = 0;
+static double frame_ms = RESOLUTION_TARGET_MS;  // smoothed
+static int settle_frames = 0;
+static int on_budget_frames = 0;
+
+// Refresh interval estimate: shortest GPU-unbound frame in the current and
+// the previous window (0 while a window has none)
+static double window_min_ms[2] = {0.0, 0.0};
+static int window_frames = 0;
+static double budget_ms = RESOLUTION_TARGET_MS;
+
+// Submit-to-done GPU time, smoothed (negative until the first measurement)
+static double gpu_ms = -1.0;
+static double gpu_submit_ms = 0.0;
+static int gpu_pending = 0;
+
+// Pixels drawn this frame on one axis
+static int scaled_size(int size) {
+    int scaled = (int)(size * scale + 0.5f);
+    return scaled > 0 ? scaled : 1;
+}
+
+void resolution_init(WGPUDevice device, WGPUQueue queue, WGPUTextureFormat format) {
+    res_device = device;
+    res_queue = queue;
+    res_format = format;
+    
+    // Create uniform buffer
+    WGPUBufferDescriptor ub_desc = {
+        .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+        .size = sizeof(UpscaleUniforms),
+    };
+    upscale_uniform_buffer = gpu_create_buffer(res_device, &ub_desc, "resolution");
+    
+    // Create sampler (bilinear is the whole filter)
+    WGPUSamplerDescriptor sampler_desc = {
+        .addressModeU = WGPUAddressMode_ClampToEdge,
+        .addressModeV = WGPUAddressMode_ClampToEdge,
+        .addressModeW = WGPUAddressMode_ClampToEdge,
+        .magFilter = WGPUFilterMode_Linear,
+        .minFilter = WGPUFilterMode_Linear,
+        .mipmapFilter = WGPUMipmapFilterMode_Nearest,
+        .maxAnisotropy = 1,
+    };
+    upscale_sampler = gpu_create_sampler(res_device, &sampler_desc, "resolution");
+    
+    // Create bind group layout (uniforms + scene texture + sampler)
+    WGPUBindGroupLayoutEntry bgl_entries[] = {
+        {
+            .binding = 0,
+            .visibility = WGPUShaderStage_Fragment,
+            .buffer = {
+                .type = WGPUBufferBindingType_Uniform,
+                .minBindingSize = sizeof(UpscaleUniforms),
+            },
+        },
+        {
+            .binding = 1,
+            .visibility = WGPUShaderStage_Fragment,
+            .texture = {
+                .sampleType = WGPUTextureSampleType_Float,
+                .viewDimension = WGPUTextureViewDimension_2D,
+                .multisampled = false,
+            },
+        },
+        {
+            .binding = 2,
+            .visibility = WGPUShaderStage_Fragment,
+            .sampler = {
+                .type = WGPUSamplerBindingType_Filtering,
+            },
+        },
+    };
+    WGPUBindGroupLayoutDescriptor bgl_desc = {
+        .entryCount = 3,
+        .entries = bgl_entries,
+    };
+    res_bind_group_layout = gpu_create_bind_group_layout(res_device, &bgl_desc, "resolution");
+}
+
+void resolution_create_pipeline(const char* shader_source) {
+    if (!res_device || !shader_source) return;
+    
+    // Create shader module
+    WGPUShaderSourceWGSL wgsl_source = {
+        .chain = {.sType = WGPUSType_ShaderSourceWGSL},
+        .code = {.data = shader_source, .length = strlen(shader_source)},
+    };
+    WGPUShaderModuleDescriptor shader_desc = {
+        .nextInChain = (WGPUChainedStruct*)&wgsl_source,
+    };
+    WGPUShaderModule shader = gpu_create_shader_module(res_device, &shader_desc, "resolution");
+    
+    // Create pipeline layout
+    WGPUPipelineLayoutDescriptor pl_desc = {
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &res_bind_group_layout,
+    };
+    WGPUPipelineLayout pipeline_layout = gpu_create_pipeline_layout(res_device, &pl_desc, "resolution");
+    
+    // Opaque copy: the scene covers every pixel
+    WGPUColorTargetState color_target = {
+        .format = res_format,
+        .writeMask = WGPUColorWriteMask_All,
+    };
+    
+    WGPUFragmentState fragment = {
+        .module = shader,
+        .entryPoint = {.data = "fs_main", .length = 7},
+        .targetCount = 1,
+        .targets = &color_target,
+    };
+    
+    // Create render pipeline (no vertex buffers: one generated triangle)
+    WGPURenderPipelineDescriptor rp_desc = {
+        .layout = pipeline_layout,
+        .vertex = {
+            .module = shader,
+            .entryPoint = {.data = "vs_main", .length = 7},
+        },
+        .fragment = &fragment,
+        .primitive = {
+            .topology = WGPUPrimitiveTopology_TriangleList,
+            .frontFace = WGPUFrontFace_CCW,
+            .cullMode = WGPUCullMode_None,
+        },
+        .multisample = {
+            .count = 1,
+            .mask = 0xFFFFFFFF,
+        },
+    };
+    upscale_pipeline = gpu_create_render_pipeline(res_device, &rp_desc, "resolution");
+    
+    // Cleanup
+    gpu_release_shader_module(shader);
+    gpu_release_pipeline_layout(pipeline_layout);
+}
+
+void resolution_shutdown(void) {
+    gpu_release_bind_group(scene_bind_group);
+    gpu_release_view(scene_view);
+    gpu_release_texture(scene_texture);
+    gpu_release_render_pipeline(upscale_pipeline);
+    gpu_release_bind_group_layout(res_bind_group_layout);
+    gpu_release_sampler(upscale_sampler);
+    gpu_release_buffer(upscale_uniform_buffer);
+    scene_bind_group = NULL;
+    scene_view = NULL;
+    scene_texture = NULL;
+    upscale_pipeline = NULL;
+    res_bind_group_layout = NULL;
+    upscale_sampler = NULL;
+    upscale_uniform_buffer = NULL;
+    res_device = NULL;
+}
+
+void resolution_resize(int surface_width, int surface_height) {
+    if (!res_device) return;
+    if (surface_width < 1) surface_width = 1;
+    if (surface_height < 1) surface_height = 1;
+    if (scene_texture && surface_width == target_width && surface_height == target_height) return;
+    
+    gpu_release_bind_group(scene_bind_group);
+    gpu_release_view(scene_view);
+    gpu_release_texture(scene_texture);
+    
+    // Create scene texture
+    WGPUTextureDescriptor tex_desc = {
+        .usage = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_TextureBinding,
+        .dimension = WGPUTextureDimension_2D,
+        .size = {(uint32_t)surface_width, (uint32_t)surface_height, 1},
+        .format = res_format,
+        .mipLevelCount = 1,
+        .sampleCount = 1,
+    };
+    scene_texture = gpu_create_texture(res_device, &tex_desc, "resolution");
+    scene_view = gpu_create_view(scene_texture, NULL, "resolution");
+    target_width = surface_width;
+    target_height = surface_height;
+    
+    // Create bind group
+    WGPUBindGroupEntry bg_entries[] = {
+        {
+            .binding = 0,
+            .buffer = upscale_uniform_buffer,
+            .offset = 0,
+            .size = sizeof(UpscaleUniforms),
+        },
+        {
+            .binding = 1,
+            .textureView = scene_view,
+        },
+        {
+            .binding = 2,
+            .sampler = upscale_sampler,
+        },
+    };
+    WGPUBindGroupDescriptor bg_desc = {
+        .layout = res_bind_group_layout,
+        .entryCount = 3,
+        .entries = bg_entries,
+    };
+    scene_bind_group = gpu_create_bind_group(res_device, &bg_desc, "resolution");
+}
+
+// The display refreshes no faster than the shortest frame; one the GPU
+// held up says nothing about it
+static void update_budget(double ms) {
+    if (gpu_ms < 0.0 || gpu_ms < ms * RESOLUTION_GPU_BUSY) {
+        if (window_min_ms[0] == 0.0 || ms < window_min_ms[0]) window_min_ms[0] = ms;
+    }
+    if (++window_frames >= RESOLUTION_REFRESH_FRAMES) {
+        window_frames = 0;
+        if (window_min_ms[0] > 0.0) {
+            window_min_ms[1] = window_min_ms[0];
+            window_min_ms[0] = 0.0;
+        }
+    }
+    
+    double refresh = window_min_ms[1];
+    if (window_min_ms[0] > 0.0 && (refresh == 0.0 || window_min_ms[0] < refresh)) refresh = window_min_ms[0];
+    budget_ms = refresh > RESOLUTION_TARGET_MS ? refresh : RESOLUTION_TARGET_MS;
+}
+
+static void on_work_done(WGPUQueueWorkDoneStatus status, WGPUStringView message, void* userdata1, void* userdata2) {
+    (void)message;
+    (void)userdata1;
+    (void)userdata2;
+    gpu_pending = 0;
+    if (status != WGPUQueueWorkDoneStatus_Success) return;
+    double ms = platform_now_ms() - gpu_submit_ms;
+    gpu_ms = gpu_ms < 0.0 ? ms : gpu_ms + (ms - gpu_ms) * 0.1;
+}
+
+void resolution_submitted(void) {
+    if (!res_queue || gpu_pending) return;
+    gpu_pending = 1;
+    gpu_submit_ms = platform_now_ms();
+    WGPUQueueWorkDoneCallbackInfo callback_info = {
+        .mode = WGPUCallbackMode_AllowSpontaneous,
+        .callback = on_work_done,
+        .userdata1 = NULL,
+        .userdata2 = NULL,
+    };
+    wgpuQueueOnSubmittedWorkDone(res_queue, callback_info);
+}
+
+void resolution_frame_time(double ms) {
+    frame_ms += (ms - frame_ms) * 0.1;
+    update_budget(ms);
+    if (locked) return;
+    
+    // Give the last change time to show up in the average
+    if (settle_frames > 0) {
+        settle_frames--;
+        return;
+    }
+    
+    // A vsynced frame never comes in under budget, so headroom is unknown:
+    // after a long run on budget, try one step up and let the next frames
+    // tell whether it still fits. Late frames with the GPU mostly idle are
+    // the CPU's or the browser's doing, and a lower scale would not help.
+    float next = scale;
+    int gpu_bound = gpu_ms < 0.0 || gpu_ms > budget_ms * RESOLUTION_GPU_BUSY;
+    if (frame_ms > budget_ms * 1.15 && gpu_bound) {
+        next -= RESOLUTION_STEP;
+        on_budget_frames = 0;
+    } else if (frame_ms < budget_ms * 1.05 && ++on_budget_frames >= RESOLUTION_PROBE_FRAMES) {
+        next += RESOLUTION_STEP;
+        on_budget_frames = 0;
+    }
+    if (next < RESOLUTION_MIN_SCALE) next = RESOLUTION_MIN_SCALE;
+    if (next > RESOLUTION_MAX_SCALE) next = RESOLUTION_MAX_SCALE;
+    if (next != scale) {
+        scale = next;
+        settle_frames = RESOLUTION_SETTLE_FRAMES;
+    }
+}
+
+void resolution_lock(float locked_scale) {
+    locked = locked_scale > 0.0f;
+    if (!locked) return;
+    if (locked_scale < RESOLUTION_MIN_SCALE) locked_scale = RESOLUTION_MIN_SCALE;
+    if (locked_scale > RESOLUTION_MAX_SCALE) locked_scale = RESOLUTION_MAX_SCALE;
+    scale = locked_scale;
+}
+
+float resolution_scale(void) {
+    return scale;
+}
+
+void resolution_scene_size(int* width, int* height) {
+    *width = scaled_size(target_width);
+    *height = scaled_size(target_height);
+}
+
+WGPURenderPassEncoder resolution_begin_scene(WGPUCommandEncoder encoder, WGPUColor clear) {
+    if (!scene_view) return NULL;
+    
+    WGPURenderPassColorAttachment color_attachment = {
+        .view = scene_view,
+        .depthSlice = WGPU_DEPTH_SLICE_UNDEFINED,
+        .loadOp = WGPULoadOp_Clear,
+        .storeOp = WGPUStoreOp_Store,
+        .clearValue = clear,
+    };
+    WGPURenderPassDescriptor pass_desc = {
+        .colorAttachmentCount = 1,
+        .colorAttachments = &color_attachment,
+    };
+    WGPURenderPassEncoder pass = gpu_begin_pass(encoder, &pass_desc);
+    
+    // Clip space maps onto the scaled top-left corner of the target
+    wgpuRenderPassEncoderSetViewport(pass, 0.0f, 0.0f, (float)scaled_size(target_width),
+                                     (float)scaled_size(target_height), 0.0f, 1.0f);
+    return pass;
+}
+
+void resolution_upscale(WGPURenderPassEncoder pass) {
+    if (!upscale_pipeline || !scene_bind_group) return;
+    
+    int w = scaled_size(target_width);
+    int h = scaled_size(target_height);
+    UpscaleUniforms uniforms = {
+        .uv_scale = {(float)w / target_width, (float)h / target_height},
+        .uv_max = {(w - 0.5f) / target_width, (h - 0.5f) / target_height},
+    };
+    gpu_write_buffer(res_queue, upscale_uniform_buffer, 0, &uniforms, sizeof(UpscaleUniforms));
+    
+    gpu_set_pipeline(pass, upscale_pipeline);
+    gpu_set_bind_group(pass, 0, scene_bind_group);
+    gpu_draw(pass, 3, 1);
+}
+
+void resolution_report(void) {
+    printf("Resolution: scale %.2f%s (%dx%d of %dx%d), frame %.1f ms (budget %.1f ms), GPU %.1f ms\n",
+           scale, locked ? " locked" : "", scaled_size(target_width), scaled_size(target_height),
+           target_width, target_height, frame_ms, budget_ms, gpu_ms > 0.0 ? gpu_ms : 0.0);
+}
@@ -0,0 +1,68 @@
+#ifndef RESOLUTION_H
+#define RESOLUTION_H
+
+#include <webgpu/webgpu.h>
+
+// Dynamic resolution
+//
+// The world is drawn into an offscreen scene target and stretched to the
+// surface with one bilinear pass. The target is allocated at full surface
+// size once; each frame only its top-left scale x scale portion is drawn
+// (through the viewport), so changing the scale never reallocates. A frame
+// time controller lowers the scale while frames run over budget and probes
+// back up once they have been on budget for a while.
+//
+// The budget is the display's refresh interval, estimated as the shortest
+// frame seen recently (never less than RESOLUTION_TARGET_MS), so a 50 Hz
+// display or a tab throttled to 30 fps is not mistaken for a slow GPU.
+// Frames only count towards the estimate while the GPU keeps up with them,
+// and the scale only drops while the GPU itself (submit to work done) takes
+// most of the budget.
+
+#define RESOLUTION_MIN_SCALE 0.5f
+#define RESOLUTION_MAX_SCALE 1.0f
+#define RESOLUTION_STEP 0.05f
+#define RESOLUTION_TARGET_MS (1000.0 / 60.0)  // shortest frame budget
+#define RESOLUTION_REFRESH_FRAMES 300         // frames per refresh estimate window
+#define RESOLUTION_GPU_BUSY 0.8               // GPU time over budget that limits frames
+#define RESOLUTION_SETTLE_FRAMES 15           // frames to wait after a change
+#define RESOLUTION_PROBE_FRAMES 120           // on-budget frames before scaling up
+
+// Initialize the scene target (after the WebGPU device is ready)
+void resolution_init(WGPUDevice device, WGPUQueue queue, WGPUTextureFormat format);
+
+// Create the upscale pipeline from WGSL source
+void resolution_create_pipeline(const char* shader_source);
+
+// Release the scene target and upscale pipeline
+void resolution_shutdown(void);
+
+// Reallocate the scene target for a new surface size (in pixels)
+void resolution_resize(int surface_width, int surface_height);
+
+// Feed the time between two consecutive rendered frames to the controller
+void resolution_frame_time(double frame_ms);
+
+// Call right after submitting a frame's commands; times when the GPU
+// finishes them (one measurement in flight at a time)
+void resolution_submitted(void);
+
+// Fix the scale (clamped to the bounds), e.g. for benchmarks; 0 unlocks
+void resolution_lock(float scale);
+
+float resolution_scale(void);
+
+// Size in pixels of the part of the scene target drawn this frame
+void resolution_scene_size(int* width, int* height);
+
+// Begin a pass that clears the scene target and restricts drawing to the
+// scaled viewport. Returns NULL if the target does not exist yet.
+WGPURenderPassEncoder resolution_begin_scene(WGPUCommandEncoder encoder, WGPUColor clear);
+
+// Stretch the drawn part of the scene target over the whole pass target
+void resolution_upscale(WGPURenderPassEncoder pass);
+
+// Print the current scale and frame time
+void resolution_report(void);
+
+#endif // RESOLUTION_H
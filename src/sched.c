@@ -0,0 +1,141 @@
+#include "sched.h"
+#include "platform.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SCHED_AVERAGE_WEIGHT 0.1  // weight of the newest tick in moving averages
+#define SCHED_ADAPTIVE_CHUNKS 8   // budget checks per adaptive slice
+
+typedef struct {
+    SchedSystemDesc desc;
+    SchedStats stats;
+    int cursor;  // next item (adaptive systems; fixed ones derive it from the tick)
+} SchedSystem;
+
+static SchedSystem systems[SCHED_MAX_SYSTEMS];
+static int system_count = 0;
+static int order[SCHED_MAX_SYSTEMS];  // ids by priority, then registration
+static double tick_budget_ms = 0.0;
+
+int sched_register(const SchedSystemDesc* desc) {
+    if (system_count == SCHED_MAX_SYSTEMS || !desc->update || desc->item_cost_us <= 0.0) {
+        printf("Cannot register update system %s\n", desc->name);
+        return -1;
+    }
+    int id = system_count++;
+    SchedSystem* s = &systems[id];
+    memset(s, 0, sizeof(*s));
+    s->desc = *desc;
+    s->stats.item_cost_us = desc->item_cost_us;
+    
+    // Keep order sorted; equal priorities run in registration order
+    int i = id;
+    while (i > 0 && systems[order[i - 1]].desc.priority > desc->priority) {
+        order[i] = order[i - 1];
+        i--;
+    }
+    order[i] = id;
+    return id;
+}
+
+void sched_set_items(int id, int count) {
+    if (id < 0 || id >= system_count) return;
+    systems[id].stats.items = count > 0 ? count : 0;
+}
+
+void sched_set_budget(int id, double budget_ms) {
+    if (id < 0 || id >= system_count) return;
+    systems[id].desc.budget_ms = budget_ms;
+}
+
+void sched_set_tick_budget(double ms) {
+    tick_budget_ms = ms > 0.0 ? ms : 0.0;
+}
+
+// Items a system may process this tick
+static int slice_size(const SchedSystem* s) {
+    double quota = s->desc.budget_ms * 1000.0 / s->stats.item_cost_us;
+    if (quota < 1.0) return 1;
+    return quota < s->stats.items ? (int)quota : s->stats.items;
+}
+
+// Adaptive systems work through their slice a chunk at a time and stop once
+// their budget is spent, so a few slow items overrun it by one chunk at most.
+// Returns the number of items processed.
+static int run_adaptive(SchedSystem* s, int slice, float elapsed, double start) {
+    int count = s->stats.items;
+    int chunk = slice / SCHED_ADAPTIVE_CHUNKS > 0 ? slice / SCHED_ADAPTIVE_CHUNKS : 1;
+    int cursor = s->cursor < count ? s->cursor : 0;
+    int done = 0;
+    while (done < slice) {
+        int n = slice - done < chunk ? slice - done : chunk;
+        if (n > count - cursor) n = count - cursor;
+        s->desc.update(s->desc.user, cursor, cursor + n, elapsed);
+        done += n;
+        cursor = (cursor + n) % count;
+        if (platform_now_ms() - start >= s->desc.budget_ms) break;
+    }
+    s->cursor = cursor;
+    return done;
+}
+
+static void run_system(SchedSystem* s, uint64_t tick, float dt) {
+    SchedStats* st = &s->stats;
+    int count = st->items;
+    int slice = slice_size(s);
+    st->round_ticks = (count + slice - 1) / slice;
+    float elapsed = dt * st->round_ticks;
+    
+    double start = platform_now_ms();
+    if (s->desc.mode == SCHED_FIXED) {
+        // Fixed systems take the slices of a round in turn, so the same tick
+        // always covers the same items and every item comes up once a round
+        int begin = (int)(tick % (uint64_t)st->round_ticks) * slice;
+        int end = begin + slice < count ? begin + slice : count;
+        s->desc.update(s->desc.user, begin, end, elapsed);
+        st->slice = end - begin;
+    } else {
+        st->slice = run_adaptive(s, slice, elapsed, start);
+    }
+    double ms = platform_now_ms() - start;
+    
+    st->last_ms = ms;
+    st->avg_ms += (ms - st->avg_ms) * SCHED_AVERAGE_WEIGHT;
+    if (ms > st->peak_ms) st->peak_ms = ms;
+    if (ms > s->desc.budget_ms) st->overruns++;
+    if (s->desc.mode == SCHED_ADAPTIVE) {
+        double cost = ms * 1000.0 / st->slice;
+        st->item_cost_us += (cost - st->item_cost_us) * SCHED_AVERAGE_WEIGHT;
+        if (st->item_cost_us < 1e-4) st->item_cost_us = 1e-4;
+    }
+}
+
+void sched_run(uint64_t tick, float dt) {
+    double tick_start = platform_now_ms();
+    for (int i = 0; i < system_count; i++) {
+        SchedSystem* s = &systems[order[i]];
+        if (s->stats.items == 0) continue;
+        if (s->desc.mode == SCHED_ADAPTIVE && tick_budget_ms > 0.0 &&
+            platform_now_ms() - tick_start >= tick_budget_ms) {
+            s->stats.skipped++;
+            continue;
+        }
+        run_system(s, tick, dt);
+    }
+}
+
+const SchedStats* sched_stats(int id) {
+    if (id < 0 || id >= system_count) return NULL;
+    return &systems[id].stats;
+}
+
+void sched_report(void) {
+    for (int i = 0; i < system_count; i++) {
+        const SchedSystem* s = &systems[order[i]];
+        const SchedStats* st = &s->stats;
+        printf("Update %s: %d items, %d per tick (round of %d ticks), %.3f ms avg / %.3f peak "
+               "(budget %.3f), %llu over budget, %llu skipped\n",
+               s->desc.name, st->items, st->slice, st->round_ticks, st->avg_ms, st->peak_ms,
+               s->desc.budget_ms, (unsigned long long)st->overruns, (unsigned long long)st->skipped);
+    }
+}
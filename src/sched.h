@@ -0,0 +1,77 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+
+// Time-sliced update scheduler
+//
+// Systems that cycle over many items (agents thinking, paths being planned
+// again) register an update function with a priority and a per-tick time
+// budget. Each tick, in priority order, every system processes the next
+// slice of its items round-robin, so its cost stays near its budget however
+// many items there are. When the item count spikes, items come round less
+// often instead of the tick getting longer.
+//
+// A system's budget becomes an item quota through its cost per item.
+// SCHED_FIXED systems keep the declared cost, and their slice depends only
+// on the tick number and item count, so a simulation using them stays
+// deterministic: replays and state rewinds see the same slices.
+// SCHED_ADAPTIVE systems learn the cost from measured time, stop partway
+// through a slice once their budget is spent and are skipped for a tick once
+// the tick budget is spent, so use them only for work whose result may
+// depend on timing.
+
+#define SCHED_MAX_SYSTEMS 16
+
+typedef enum {
+    SCHED_FIXED,
+    SCHED_ADAPTIVE,
+} SchedMode;
+
+// Process items [begin, end). elapsed is the simulated time since these
+// items were last processed (one full round at the current slice size).
+typedef void (*SchedUpdateFn)(void* user, int begin, int end, float elapsed);
+
+typedef struct {
+    const char* name;
+    int priority;          // lower runs first
+    double budget_ms;      // per tick
+    double item_cost_us;   // cost of one item (the starting guess for adaptive systems)
+    SchedMode mode;
+    SchedUpdateFn update;
+    void* user;
+} SchedSystemDesc;
+
+typedef struct {
+    int items;
+    int slice;             // items processed in the last tick
+    int round_ticks;       // ticks to get round every item at that slice size
+    double item_cost_us;   // current estimate
+    double last_ms;
+    double avg_ms;         // moving average
+    double peak_ms;
+    uint64_t overruns;     // ticks the system went over its budget
+    uint64_t skipped;      // ticks skipped for want of tick budget (adaptive only)
+} SchedStats;
+
+// Register a system. Returns its id, or -1 when the table is full.
+int sched_register(const SchedSystemDesc* desc);
+
+// Number of items a system cycles through
+void sched_set_items(int id, int count);
+
+void sched_set_budget(int id, double budget_ms);
+
+// Adaptive systems do not start once this much of a tick is spent
+// (0, the default, for no limit)
+void sched_set_tick_budget(double ms);
+
+// Run one tick of every system, dt seconds long
+void sched_run(uint64_t tick, float dt);
+
+const SchedStats* sched_stats(int id);
+
+// Print every system's stats
+void sched_report(void);
+
+#endif // SCHED_H
@@ -0,0 +1,122 @@
+#include "sim_thread.h"
+#include "platform.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+
+#define SNAPSHOT_INDEX_MASK 3
+#define SNAPSHOT_FRESH 4
+
+// Worker state
+static pthread_t sim_thread;
+static atomic_int sim_running = 0;
+static atomic_int sim_viewport_width = 800;
+static atomic_int sim_viewport_height = 600;
+static atomic_uint_fast64_t sim_ticks = 0;
+static SnapshotBuffer sim_snapshots;
+
+void snapshot_buffer_init(SnapshotBuffer* sb, const GameSnapshot* initial) {
+    for (int i = 0; i < 3; i++) {
+        sb->slots[i] = *initial;
+    }
+    sb->back = 0;
+    sb->front = 1;
+    atomic_store_explicit(&sb->middle, 2, memory_order_relaxed);
+}
+
+GameSnapshot* snapshot_buffer_back(SnapshotBuffer* sb) {
+    return &sb->slots[sb->back];
+}
+
+void snapshot_buffer_publish(SnapshotBuffer* sb) {
+    // Release makes the slot contents visible before the consumer can see it
+    int prev = atomic_exchange_explicit(&sb->middle, sb->back | SNAPSHOT_FRESH, memory_order_acq_rel);
+    sb->back = prev & SNAPSHOT_INDEX_MASK;
+}
+
+const GameSnapshot* snapshot_buffer_acquire(SnapshotBuffer* sb) {
+    if (atomic_load_explicit(&sb->middle, memory_order_relaxed) & SNAPSHOT_FRESH) {
+        int prev = atomic_exchange_explicit(&sb->middle, sb->front, memory_order_acq_rel);
+        sb->front = prev & SNAPSHOT_INDEX_MASK;
+    }
+    return &sb->slots[sb->front];
+}
+
+// Worker loop: fixed-step simulation paced against the wall clock
+static void* sim_thread_main(void* arg) {
+    (void)arg;
+    const double step_ms = 1000.0 / SIM_TICK_RATE;
+    const float step_s = 1.0f / SIM_TICK_RATE;
+    // Each step covers the interval ending at next_tick, so it only runs once
+    // every input event inside it can have arrived
+    double next_tick = platform_now_ms() + step_ms;
+    game_set_input_clock(next_tick - step_ms);
+    
+    while (atomic_load_explicit(&sim_running, memory_order_acquire)) {
+        double now = platform_now_ms();
+        if (now < next_tick) {
+            platform_sleep_ms(next_tick - now);
+            continue;
+        }
+        
+        int width = atomic_load_explicit(&sim_viewport_width, memory_order_relaxed);
+        int height = atomic_load_explicit(&sim_viewport_height, memory_order_relaxed);
+        
+        int steps = 0;
+        while (next_tick <= now && steps < SIM_MAX_STEPS_PER_WAKE) {
+            game_update(step_s, width, height);
+            next_tick += step_ms;
+            steps++;
+        }
+        if (next_tick <= now) {
+            // Too far behind, skip ahead (input timing resyncs with it)
+            next_tick = now + step_ms;
+            game_set_input_clock(now);
+        }
+        
+        // Publish only the final state of this batch of steps
+        game_snapshot(snapshot_buffer_back(&sim_snapshots));
+        snapshot_buffer_publish(&sim_snapshots);
+        atomic_fetch_add_explicit(&sim_ticks, steps, memory_order_relaxed);
+    }
+    return NULL;
+}
+
+int sim_thread_start(int canvas_width, int canvas_height) {
+    if (atomic_load(&sim_running)) return 0;
+    
+    GameSnapshot initial;
+    game_snapshot(&initial);
+    snapshot_buffer_init(&sim_snapshots, &initial);
+    sim_thread_set_viewport(canvas_width, canvas_height);
+    
+    atomic_store(&sim_running, 1);
+    if (pthread_create(&sim_thread, NULL, sim_thread_main, NULL) != 0) {
+        atomic_store(&sim_running, 0);
+        printf("Failed to start simulation thread\n");
+        return 1;
+    }
+    
+    printf("Simulation thread started (%d Hz)\n", SIM_TICK_RATE);
+    return 0;
+}
+
+void sim_thread_stop(void) {
+    if (!atomic_exchange(&sim_running, 0)) return;
+    pthread_join(sim_thread, NULL);
+    printf("Simulation thread stopped after %llu ticks\n",
+           (unsigned long long)atomic_load(&sim_ticks));
+}
+
+void sim_thread_set_viewport(int canvas_width, int canvas_height) {
+    atomic_store_explicit(&sim_viewport_width, canvas_width, memory_order_relaxed);
+    atomic_store_explicit(&sim_viewport_height, canvas_height, memory_order_relaxed);
+}
+
+const GameSnapshot* sim_thread_latest(void) {
+    return snapshot_buffer_acquire(&sim_snapshots);
+}
+
+uint64_t sim_thread_ticks(void) {
+    return atomic_load_explicit(&sim_ticks, memory_order_relaxed);
+}
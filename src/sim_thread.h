@@ -0,0 +1,51 @@
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include "game.h"
+
+// Fixed simulation rate used by the worker thread
+#define SIM_TICK_RATE 120
+#define SIM_MAX_STEPS_PER_WAKE 8  // Drop time instead of spiralling when far behind
+
+// Lock-free triple buffer of game snapshots.
+// One producer (sim thread) and one consumer (render thread) never block each
+// other: the producer always has a private back buffer to write into, the
+// consumer always has a private front buffer to read from, and the middle
+// buffer is swapped atomically between them.
+typedef struct {
+    GameSnapshot slots[3];
+    int back;               // producer-owned slot index
+    int front;              // consumer-owned slot index
+    _Atomic int middle;     // shared slot index | SNAPSHOT_FRESH
+} SnapshotBuffer;
+
+// Reset buffer so that all slots hold the given snapshot
+void snapshot_buffer_init(SnapshotBuffer* sb, const GameSnapshot* initial);
+
+// Producer: slot to fill before calling snapshot_buffer_publish
+GameSnapshot* snapshot_buffer_back(SnapshotBuffer* sb);
+
+// Producer: hand the filled back slot to the consumer
+void snapshot_buffer_publish(SnapshotBuffer* sb);
+
+// Consumer: latest published snapshot (never waits; returns the previous one
+// again if nothing new was published)
+const GameSnapshot* snapshot_buffer_acquire(SnapshotBuffer* sb);
+
+// Start ticking game_update on a worker thread. game_init must already have
+// been called. Returns 0 on success.
+int sim_thread_start(int canvas_width, int canvas_height);
+
+// Stop and join the worker thread
+void sim_thread_stop(void);
+
+// Update the playfield size used by the simulation (safe from any thread)
+void sim_thread_set_viewport(int canvas_width, int canvas_height);
+
+// Render thread: most recent completed simulation state
+const GameSnapshot* sim_thread_latest(void);
+
+// Total number of simulation ticks run by the worker so far
+uint64_t sim_thread_ticks(void);
+
+#endif // SIM_THREAD_H
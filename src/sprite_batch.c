@@ -0,0 +1,734 @@
+#include "sprite_batch.h"
+#include "arena.h"
+#include "archive.h"
+#include "gpu_resources.h"
+#include "gpu_trace.h"
+#include "lighting.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ATLAS_MAGIC "PFAT"
+#define ATLAS_VERSION 2
+
+// Uniform data
+typedef struct {
+    float view_proj[16];
+    uint32_t mesh_vertices;
+    uint32_t padding[3];
+} SpriteBatchUniforms;
+
+// Cull pass uniforms (matches CullUniforms in sprite_cull.wgsl)
+typedef struct {
+    float center[2];
+    float half_extent[2];
+    uint32_t entity_count;
+    uint32_t image_count;
+    float camera_distance;
+    uint32_t padding;
+} SpriteCullUniforms;
+
+// Atlas image as the cull pass reads it (matches Image in sprite_cull.wgsl)
+typedef struct {
+    float uv_rect[4];
+    float size[2];
+    float radius;
+    uint32_t layer;
+} SpriteCullImage;
+
+// On-disk image record (see tools/build_atlas.py)
+typedef struct {
+    char name[ATLAS_NAME_LENGTH];
+    uint32_t layer;
+    uint32_t x, y, width, height;
+} AtlasFileImage;
+
+// Sprite batch WebGPU objects
+static WGPUDevice batch_device = NULL;
+static WGPUQueue batch_queue = NULL;
+static WGPUTextureFormat batch_surface_format = WGPUTextureFormat_BGRA8Unorm;
+static WGPURenderPipeline batch_pipeline = NULL;
+static WGPUBuffer mesh_buffer = NULL;
+static WGPUBuffer instance_buffer = NULL;
+static WGPUBuffer batch_uniform_buffer = NULL;
+static WGPUBindGroup batch_bind_group = NULL;
+static WGPUTexture atlas_texture = NULL;
+static WGPUTextureView atlas_texture_view = NULL;
+static WGPUSampler atlas_sampler = NULL;
+
+// GPU culling objects
+static WGPUComputePipeline cull_pipeline = NULL;
+static WGPUBindGroup cull_bind_group = NULL;
+static WGPUBuffer cull_uniform_buffer = NULL;
+static WGPUBuffer entity_buffer = NULL;      // entity records, uploaded each frame
+static WGPUBuffer frame_buffer = NULL;       // atlas image per entity (u16), uploaded each frame
+static WGPUBuffer cull_image_buffer = NULL;  // SpriteCullImage per atlas image
+static WGPUBuffer culled_buffer = NULL;      // surviving instances (storage + vertex)
+static WGPUBuffer draw_args_buffer = NULL;   // DrawIndirect arguments
+static int culled_this_frame = 0;
+
+// Atlas table
+static AtlasImage atlas_images[MAX_ATLAS_IMAGES];
+static int atlas_image_count = 0;
+static uint32_t mesh_vertices = 0;  // corners per image mesh
+static size_t mesh_bytes = 0;
+
+// Instances queued this frame (persistent arena, reused every frame)
+static SpriteInstance* instances = NULL;
+static int instance_count = 0;
+
+void sprite_batch_init(WGPUDevice device, WGPUQueue queue, WGPUTextureFormat format) {
+    batch_device = device;
+    batch_queue = queue;
+    batch_surface_format = format;
+    
+    instances = (SpriteInstance*)arena_alloc(arena_persistent(), MAX_SPRITE_INSTANCES * sizeof(SpriteInstance));
+    instance_count = 0;
+}
+
+int sprite_batch_load_atlas(const char* path) {
+    size_t size = assets_size(path);
+    uint32_t header[5];
+    if (size < 4 + sizeof(header)) {
+        printf("Missing or truncated sprite atlas: %s\n", path);
+        return 1;
+    }
+    
+    // Decode the whole file straight into a mapped staging buffer; the
+    // pixels are then copied to the texture on the GPU, so they never need
+    // a CPU-side scratch copy
+    WGPUBufferDescriptor staging_desc = {
+        .usage = WGPUBufferUsage_CopySrc,
+        .size = (size + 3) & ~(size_t)3,  // mapped sizes must be a multiple of 4
+        .mappedAtCreation = 1,
+    };
+    WGPUBuffer staging = gpu_create_buffer(batch_device, &staging_desc, "sprites");
+    uint8_t* data = (uint8_t*)wgpuBufferGetMappedRange(staging, 0, staging_desc.size);
+    if (!data || assets_read(path, data, size)) {
+        wgpuBufferUnmap(staging);
+        gpu_release_buffer(staging);
+        return 1;
+    }
+    
+    if (memcmp(data, ATLAS_MAGIC, 4) != 0) {
+        printf("Not a sprite atlas: %s\n", path);
+        wgpuBufferUnmap(staging);
+        gpu_release_buffer(staging);
+        return 1;
+    }
+    memcpy(header, data + 4, sizeof(header));
+    uint32_t version = header[0], layer_size = header[1], layer_count = header[2], image_count = header[3];
+    mesh_vertices = header[4];
+    
+    size_t table_offset = 4 + sizeof(header);
+    size_t mesh_offset = table_offset + image_count * sizeof(AtlasFileImage);
+    mesh_bytes = (size_t)image_count * mesh_vertices * 2 * sizeof(float);
+    size_t pixel_offset = mesh_offset + mesh_bytes;
+    size_t layer_bytes = (size_t)layer_size * layer_size * 4;
+    if (version != ATLAS_VERSION || image_count == 0 || image_count > MAX_ATLAS_IMAGES || layer_count == 0 ||
+        mesh_vertices < 3 || mesh_vertices > MAX_MESH_VERTICES ||
+        layer_size % 64 != 0 || size < pixel_offset + layer_bytes * layer_count) {
+        printf("Unsupported or truncated sprite atlas: %s\n", path);
+        wgpuBufferUnmap(staging);
+        gpu_release_buffer(staging);
+        return 1;
+    }
+    
+    // Convert pixel rects to normalized UV rects
+    for (uint32_t i = 0; i < image_count; i++) {
+        AtlasFileImage rec;
+        memcpy(&rec, data + table_offset + i * sizeof(rec), sizeof(rec));
+        AtlasImage* img = &atlas_images[i];
+        memcpy(img->name, rec.name, ATLAS_NAME_LENGTH);
+        img->name[ATLAS_NAME_LENGTH - 1] = '\0';
+        img->layer = rec.layer;
+        img->uv_rect[0] = rec.x / (float)layer_size;
+        img->uv_rect[1] = rec.y / (float)layer_size;
+        img->uv_rect[2] = (rec.x + rec.width) / (float)layer_size;
+        img->uv_rect[3] = (rec.y + rec.height) / (float)layer_size;
+        img->width = (float)rec.width;
+        img->height = (float)rec.height;
+    }
+    atlas_image_count = (int)image_count;
+    
+    // Mesh corners go to a storage buffer the vertex shader indexes by
+    // instance mesh and vertex index
+    WGPUBufferDescriptor mesh_desc = {
+        .usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst,
+        .size = mesh_bytes,
+        .mappedAtCreation = true,
+    };
+    mesh_buffer = gpu_create_buffer(batch_device, &mesh_desc, "sprites");
+    memcpy(wgpuBufferGetMappedRange(mesh_buffer, 0, mesh_bytes), data + mesh_offset, mesh_bytes);
+    wgpuBufferUnmap(mesh_buffer);
+    wgpuBufferUnmap(staging);
+    
+    // Create texture array and copy all layers at once
+    WGPUTextureDescriptor tex_desc = {
+        .usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst,
+        .dimension = WGPUTextureDimension_2D,
+        .size = {layer_size, layer_size, layer_count},
+        .format = WGPUTextureFormat_RGBA8Unorm,
+        .mipLevelCount = 1,
+        .sampleCount = 1,
+    };
+    atlas_texture = gpu_create_texture(batch_device, &tex_desc, "sprites");
+    
+    // Rows are 4 * layer_size bytes, which the layer_size check above keeps
+    // a multiple of the 256-byte buffer copy pitch
+    WGPUTexelCopyBufferInfo source = {
+        .layout = {
+            .offset = pixel_offset,
+            .bytesPerRow = 4 * layer_size,
+            .rowsPerImage = layer_size,
+        },
+        .buffer = staging,
+    };
+    WGPUTexelCopyTextureInfo dest = {
+        .texture = atlas_texture,
+        .mipLevel = 0,
+        .origin = {0, 0, 0},
+        .aspect = WGPUTextureAspect_All,
+    };
+    WGPUExtent3D copy_size = {layer_size, layer_size, layer_count};
+    
+    WGPUCommandEncoderDescriptor enc_desc = {0};
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(batch_device, &enc_desc);
+    wgpuCommandEncoderCopyBufferToTexture(encoder, &source, &dest, &copy_size);
+    WGPUCommandBufferDescriptor cmd_desc = {0};
+    WGPUCommandBuffer commands = wgpuCommandEncoderFinish(encoder, &cmd_desc);
+    wgpuQueueSubmit(batch_queue, 1, &commands);
+    
+    // Cleanup
+    wgpuCommandBufferRelease(commands);
+    wgpuCommandEncoderRelease(encoder);
+    gpu_release_buffer(staging);
+    
+    WGPUTextureViewDescriptor view_desc = {
+        .format = WGPUTextureFormat_RGBA8Unorm,
+        .dimension = WGPUTextureViewDimension_2DArray,
+        .baseMipLevel = 0,
+        .mipLevelCount = 1,
+        .baseArrayLayer = 0,
+        .arrayLayerCount = layer_count,
+        .aspect = WGPUTextureAspect_All,
+    };
+    atlas_texture_view = gpu_create_view(atlas_texture, &view_desc, "sprites");
+    
+    WGPUSamplerDescriptor sampler_desc = {
+        .addressModeU = WGPUAddressMode_ClampToEdge,
+        .addressModeV = WGPUAddressMode_ClampToEdge,
+        .addressModeW = WGPUAddressMode_ClampToEdge,
+        .magFilter = WGPUFilterMode_Linear,
+        .minFilter = WGPUFilterMode_Linear,
+        .mipmapFilter = WGPUMipmapFilterMode_Nearest,
+        .lodMinClamp = 0.0f,
+        .lodMaxClamp = 1.0f,
+        .maxAnisotropy = 1,
+    };
+    atlas_sampler = gpu_create_sampler(batch_device, &sampler_desc, "sprites");
+    
+    printf("Sprite atlas loaded: %u images in %u layer(s) of %ux%u, %u-vertex meshes\n",
+           image_count, layer_count, layer_size, layer_size, mesh_vertices);
+    return 0;
+}
+
+void sprite_batch_create_pipeline(const char* shader_source) {
+    if (!batch_device || !atlas_texture_view || !lighting_bind_group_layout() || !shader_source || batch_pipeline) return;
+    
+    // Create shader module
+    WGPUShaderSourceWGSL wgsl_source = {
+        .chain = {.sType = WGPUSType_ShaderSourceWGSL},
+        .code = {.data = shader_source, .length = strlen(shader_source)},
+    };
+    WGPUShaderModuleDescriptor shader_desc = {
+        .nextInChain = (WGPUChainedStruct*)&wgsl_source,
+    };
+    WGPUShaderModule shader = gpu_create_shader_module(batch_device, &shader_desc, "sprites");
+    
+    // Create instance buffer
+    WGPUBufferDescriptor ib_desc = {
+        .usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst,
+        .size = MAX_SPRITE_INSTANCES * sizeof(SpriteInstance),
+    };
+    instance_buffer = gpu_create_buffer(batch_device, &ib_desc, "sprites");
+    
+    // Create uniform buffer
+    WGPUBufferDescriptor ub_desc = {
+        .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+        .size = sizeof(SpriteBatchUniforms),
+    };
+    batch_uniform_buffer = gpu_create_buffer(batch_device, &ub_desc, "sprites");
+    
+    // Create bind group layout (uniform + texture array + sampler + meshes)
+    WGPUBindGroupLayoutEntry bgl_entries[] = {
+        {
+            .binding = 0,
+            .visibility = WGPUShaderStage_Vertex,
+            .buffer = {
+                .type = WGPUBufferBindingType_Uniform,
+                .minBindingSize = sizeof(SpriteBatchUniforms),
+            },
+        },
+        {
+            .binding = 1,
+            .visibility = WGPUShaderStage_Fragment,
+            .texture = {
+                .sampleType = WGPUTextureSampleType_Float,
+                .viewDimension = WGPUTextureViewDimension_2DArray,
+                .multisampled = false,
+            },
+        },
+        {
+            .binding = 2,
+            .visibility = WGPUShaderStage_Fragment,
+            .sampler = {
+                .type = WGPUSamplerBindingType_Filtering,
+            },
+        },
+        {
+            .binding = 3,
+            .visibility = WGPUShaderStage_Vertex,
+            .buffer = {
+                .type = WGPUBufferBindingType_ReadOnlyStorage,
+                .minBindingSize = mesh_bytes,
+            },
+        },
+    };
+    WGPUBindGroupLayoutDescriptor bgl_desc = {
+        .entryCount = 4,
+        .entries = bgl_entries,
+    };
+    WGPUBindGroupLayout bind_group_layout = gpu_create_bind_group_layout(batch_device, &bgl_desc, "sprites");
+    
+    // Create bind group
+    WGPUBindGroupEntry bg_entries[] = {
+        {
+            .binding = 0,
+            .buffer = batch_uniform_buffer,
+            .offset = 0,
+            .size = sizeof(SpriteBatchUniforms),
+        },
+        {
+            .binding = 1,
+            .textureView = atlas_texture_view,
+        },
+        {
+            .binding = 2,
+            .sampler = atlas_sampler,
+        },
+        {
+            .binding = 3,
+            .buffer = mesh_buffer,
+            .offset = 0,
+            .size = mesh_bytes,
+        },
+    };
+    WGPUBindGroupDescriptor bg_desc = {
+        .layout = bind_group_layout,
+        .entryCount = 4,
+        .entries = bg_entries,
+    };
+    batch_bind_group = gpu_create_bind_group(batch_device, &bg_desc, "sprites");
+    
+    // Create pipeline layout (the fragment shader's tile lights are group 1)
+    WGPUBindGroupLayout layouts[] = {bind_group_layout, lighting_bind_group_layout()};
+    WGPUPipelineLayoutDescriptor pl_desc = {
+        .bindGroupLayoutCount = 2,
+        .bindGroupLayouts = layouts,
+    };
+    WGPUPipelineLayout pipeline_layout = gpu_create_pipeline_layout(batch_device, &pl_desc, "sprites");
+    
+    // Vertex buffer 0: per-instance sprite data (mesh corners come from the
+    // storage buffer, indexed by vertex_index)
+    WGPUVertexAttribute instance_attrs[] = {
+        {.format = WGPUVertexFormat_Float32x3, .offset = 0, .shaderLocation = 0},
+        {.format = WGPUVertexFormat_Float32, .offset = 12, .shaderLocation = 1},
+        {.format = WGPUVertexFormat_Float32x2, .offset = 16, .shaderLocation = 2},
+        {.format = WGPUVertexFormat_Float32x4, .offset = 24, .shaderLocation = 3},
+        {.format = WGPUVertexFormat_Uint16x2, .offset = 40, .shaderLocation = 4},
+        {.format = WGPUVertexFormat_Unorm8x4, .offset = 44, .shaderLocation = 5},
+    };
+    WGPUVertexBufferLayout vb_layout = {
+        .arrayStride = sizeof(SpriteInstance),
+        .stepMode = WGPUVertexStepMode_Instance,
+        .attributeCount = 6,
+        .attributes = instance_attrs,
+    };
+    
+    WGPUBlendState blend_state = {
+        .color = {
+            .srcFactor = WGPUBlendFactor_SrcAlpha,
+            .dstFactor = WGPUBlendFactor_OneMinusSrcAlpha,
+            .operation = WGPUBlendOperation_Add,
+        },
+        .alpha = {
+            .srcFactor = WGPUBlendFactor_One,
+            .dstFactor = WGPUBlendFactor_OneMinusSrcAlpha,
+            .operation = WGPUBlendOperation_Add,
+        },
+    };
+    
+    WGPUColorTargetState color_target = {
+        .format = batch_surface_format,
+        .blend = &blend_state,
+        .writeMask = WGPUColorWriteMask_All,
+    };
+    
+    WGPUFragmentState fragment = {
+        .module = shader,
+        .entryPoint = {.data = "fs_main", .length = 7},
+        .targetCount = 1,
+        .targets = &color_target,
+    };
+    
+    WGPURenderPipelineDescriptor rp_desc = {
+        .layout = pipeline_layout,
+        .vertex = {
+            .module = shader,
+            .entryPoint = {.data = "vs_main", .length = 7},
+            .bufferCount = 1,
+            .buffers = &vb_layout,
+        },
+        .fragment = &fragment,
+        .primitive = {
+            .topology = WGPUPrimitiveTopology_TriangleList,
+            .frontFace = WGPUFrontFace_CCW,
+            .cullMode = WGPUCullMode_None,
+        },
+        .multisample = {
+            .count = 1,
+            .mask = 0xFFFFFFFF,
+        },
+    };
+    batch_pipeline = gpu_create_render_pipeline(batch_device, &rp_desc, "sprites");
+    
+    // Cleanup
+    gpu_release_shader_module(shader);
+    gpu_release_bind_group_layout(bind_group_layout);
+    gpu_release_pipeline_layout(pipeline_layout);
+    
+    printf("Sprite batch pipeline created\n");
+}
+
+void sprite_batch_shutdown(void) {
+    gpu_release_compute_pipeline(cull_pipeline);
+    gpu_release_bind_group(cull_bind_group);
+    gpu_release_buffer(cull_uniform_buffer);
+    gpu_release_buffer(entity_buffer);
+    gpu_release_buffer(frame_buffer);
+    gpu_release_buffer(cull_image_buffer);
+    gpu_release_buffer(culled_buffer);
+    gpu_release_buffer(draw_args_buffer);
+    cull_pipeline = NULL;
+    cull_bind_group = NULL;
+    cull_uniform_buffer = NULL;
+    entity_buffer = NULL;
+    frame_buffer = NULL;
+    cull_image_buffer = NULL;
+    culled_buffer = NULL;
+    draw_args_buffer = NULL;
+    culled_this_frame = 0;
+    gpu_release_render_pipeline(batch_pipeline);
+    gpu_release_bind_group(batch_bind_group);
+    gpu_release_buffer(mesh_buffer);
+    gpu_release_buffer(instance_buffer);
+    gpu_release_buffer(batch_uniform_buffer);
+    gpu_release_sampler(atlas_sampler);
+    gpu_release_view(atlas_texture_view);
+    gpu_release_texture(atlas_texture);
+    batch_pipeline = NULL;
+    batch_bind_group = NULL;
+    mesh_buffer = NULL;
+    instance_buffer = NULL;
+    batch_uniform_buffer = NULL;
+    atlas_sampler = NULL;
+    atlas_texture_view = NULL;
+    atlas_texture = NULL;
+    atlas_image_count = 0;
+}
+
+int sprite_batch_is_ready(void) {
+    return batch_pipeline != NULL && instances != NULL;
+}
+
+int sprite_atlas_image_count(void) {
+    return atlas_image_count;
+}
+
+const AtlasImage* sprite_atlas_image(int index) {
+    if (index < 0 || index >= atlas_image_count) return NULL;
+    return &atlas_images[index];
+}
+
+int sprite_atlas_find(const char* name) {
+    for (int i = 0; i < atlas_image_count; i++) {
+        if (strcmp(atlas_images[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+void sprite_batch_add(const SpriteInstance* instance) {
+    if (!instances || instance_count >= MAX_SPRITE_INSTANCES) return;
+    instances[instance_count++] = *instance;
+}
+
+void sprite_batch_add_image(int image, float x, float y, float z, float rotation, float scale, uint32_t color) {
+    const AtlasImage* img = sprite_atlas_image(image);
+    if (!img || !instances || instance_count >= MAX_SPRITE_INSTANCES) return;
+    
+    SpriteInstance* inst = &instances[instance_count++];
+    inst->position[0] = x;
+    inst->position[1] = y;
+    inst->position[2] = z;
+    inst->rotation = rotation;
+    inst->size[0] = img->width * scale;
+    inst->size[1] = img->height * scale;
+    memcpy(inst->uv_rect, img->uv_rect, sizeof(inst->uv_rect));
+    inst->layer = (uint16_t)img->layer;
+    inst->mesh = (uint16_t)image;
+    inst->color = color;
+}
+
+void sprite_batch_flush(WGPURenderPassEncoder pass, const float* view_proj) {
+    if (!batch_pipeline || instance_count == 0) {
+        instance_count = 0;
+        return;
+    }
+    
+    SpriteBatchUniforms uniforms = {0};
+    memcpy(uniforms.view_proj, view_proj, sizeof(uniforms.view_proj));
+    uniforms.mesh_vertices = mesh_vertices;
+    gpu_write_buffer(batch_queue, batch_uniform_buffer, 0, &uniforms, sizeof(uniforms));
+    gpu_write_buffer(batch_queue, instance_buffer, 0, instances, instance_count * sizeof(SpriteInstance));
+    
+    // One draw for every queued sprite, whichever atlas image it uses; each
+    // mesh is a fan of mesh_vertices - 2 triangles
+    gpu_set_pipeline(pass, batch_pipeline);
+    gpu_set_bind_group(pass, 0, batch_bind_group);
+    gpu_set_bind_group(pass, LIGHTING_BIND_GROUP, lighting_bind_group());
+    gpu_set_vertex_buffer(pass, 0, instance_buffer, 0, instance_count * sizeof(SpriteInstance));
+    gpu_draw(pass, 3 * (mesh_vertices - 2), instance_count);
+    
+    instance_count = 0;
+}
+
+void sprite_batch_draw_ranges(WGPURenderPassEncoder pass, const float* view_proj, WGPUBuffer buffer,
+                              const uint64_t* offsets, const int* counts, int range_count) {
+    if (!batch_pipeline || range_count <= 0) return;
+    
+    SpriteBatchUniforms uniforms = {0};
+    memcpy(uniforms.view_proj, view_proj, sizeof(uniforms.view_proj));
+    uniforms.mesh_vertices = mesh_vertices;
+    gpu_write_buffer(batch_queue, batch_uniform_buffer, 0, &uniforms, sizeof(uniforms));
+    
+    gpu_set_pipeline(pass, batch_pipeline);
+    gpu_set_bind_group(pass, 0, batch_bind_group);
+    gpu_set_bind_group(pass, LIGHTING_BIND_GROUP, lighting_bind_group());
+    for (int i = 0; i < range_count; i++) {
+        gpu_set_vertex_buffer(pass, 0, buffer, offsets[i], (uint64_t)counts[i] * sizeof(SpriteInstance));
+        gpu_draw(pass, 3 * (mesh_vertices - 2), counts[i]);
+    }
+}
+
+void sprite_batch_create_cull_pipeline(const char* shader_source) {
+    if (!batch_pipeline || !shader_source || cull_pipeline) return;
+    
+    // Create shader module
+    WGPUShaderSourceWGSL wgsl_source = {
+        .chain = {.sType = WGPUSType_ShaderSourceWGSL},
+        .code = {.data = shader_source, .length = strlen(shader_source)},
+    };
+    WGPUShaderModuleDescriptor shader_desc = {
+        .nextInChain = (WGPUChainedStruct*)&wgsl_source,
+    };
+    WGPUShaderModule shader = gpu_create_shader_module(batch_device, &shader_desc, "sprite cull");
+    
+    // Create buffers: entities in, instances and draw arguments out
+    WGPUBufferDescriptor ub_desc = {
+        .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+        .size = sizeof(SpriteCullUniforms),
+    };
+    cull_uniform_buffer = gpu_create_buffer(batch_device, &ub_desc, "sprite cull");
+    
+    WGPUBufferDescriptor entity_desc = {
+        .usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst,
+        .size = (uint64_t)MAX_CULL_SPRITES * SPRITE_CULL_RECORD_BYTES,
+    };
+    entity_buffer = gpu_create_buffer(batch_device, &entity_desc, "sprite cull");
+    
+    WGPUBufferDescriptor frame_desc = {
+        .usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst,
+        .size = (uint64_t)MAX_CULL_SPRITES * sizeof(uint16_t),
+    };
+    frame_buffer = gpu_create_buffer(batch_device, &frame_desc, "sprite cull");
+    
+    WGPUBufferDescriptor culled_desc = {
+        .usage = WGPUBufferUsage_Storage | WGPUBufferUsage_Vertex,
+        .size = (uint64_t)MAX_CULL_SPRITES * sizeof(SpriteInstance),
+    };
+    culled_buffer = gpu_create_buffer(batch_device, &culled_desc, "sprite cull");
+    
+    WGPUBufferDescriptor args_desc = {
+        .usage = WGPUBufferUsage_Storage | WGPUBufferUsage_Indirect | WGPUBufferUsage_CopyDst,
+        .size = 4 * sizeof(uint32_t),
+    };
+    draw_args_buffer = gpu_create_buffer(batch_device, &args_desc, "sprite cull");
+    
+    // The image table never changes after the atlas is loaded
+    SpriteCullImage images[MAX_ATLAS_IMAGES];
+    for (int i = 0; i < atlas_image_count; i++) {
+        const AtlasImage* img = &atlas_images[i];
+        memcpy(images[i].uv_rect, img->uv_rect, sizeof(images[i].uv_rect));
+        images[i].size[0] = img->width;
+        images[i].size[1] = img->height;
+        images[i].radius = 0.5f * sqrtf(img->width * img->width + img->height * img->height);
+        images[i].layer = img->layer;
+    }
+    WGPUBufferDescriptor image_desc = {
+        .usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst,
+        .size = atlas_image_count * sizeof(SpriteCullImage),
+        .mappedAtCreation = true,
+    };
+    cull_image_buffer = gpu_create_buffer(batch_device, &image_desc, "sprite cull");
+    memcpy(wgpuBufferGetMappedRange(cull_image_buffer, 0, image_desc.size), images, image_desc.size);
+    wgpuBufferUnmap(cull_image_buffer);
+    
+    // Create bind group layout (uniform + entities + images + instances +
+    // args + frames)
+    WGPUBindGroupLayoutEntry bgl_entries[] = {
+        {
+            .binding = 0,
+            .visibility = WGPUShaderStage_Compute,
+            .buffer = {
+                .type = WGPUBufferBindingType_Uniform,
+                .minBindingSize = sizeof(SpriteCullUniforms),
+            },
+        },
+        {
+            .binding = 1,
+            .visibility = WGPUShaderStage_Compute,
+            .buffer = {.type = WGPUBufferBindingType_ReadOnlyStorage},
+        },
+        {
+            .binding = 2,
+            .visibility = WGPUShaderStage_Compute,
+            .buffer = {.type = WGPUBufferBindingType_ReadOnlyStorage},
+        },
+        {
+            .binding = 3,
+            .visibility = WGPUShaderStage_Compute,
+            .buffer = {.type = WGPUBufferBindingType_Storage},
+        },
+        {
+            .binding = 4,
+            .visibility = WGPUShaderStage_Compute,
+            .buffer = {.type = WGPUBufferBindingType_Storage},
+        },
+        {
+            .binding = 5,
+            .visibility = WGPUShaderStage_Compute,
+            .buffer = {.type = WGPUBufferBindingType_ReadOnlyStorage},
+        },
+    };
+    WGPUBindGroupLayoutDescriptor bgl_desc = {
+        .entryCount = 6,
+        .entries = bgl_entries,
+    };
+    WGPUBindGroupLayout bind_group_layout = gpu_create_bind_group_layout(batch_device, &bgl_desc, "sprite cull");
+    
+    // Create bind group
+    WGPUBindGroupEntry bg_entries[] = {
+        {.binding = 0, .buffer = cull_uniform_buffer, .offset = 0, .size = sizeof(SpriteCullUniforms)},
+        {.binding = 1, .buffer = entity_buffer, .offset = 0, .size = entity_desc.size},
+        {.binding = 2, .buffer = cull_image_buffer, .offset = 0, .size = image_desc.size},
+        {.binding = 3, .buffer = culled_buffer, .offset = 0, .size = culled_desc.size},
+        {.binding = 4, .buffer = draw_args_buffer, .offset = 0, .size = args_desc.size},
+        {.binding = 5, .buffer = frame_buffer, .offset = 0, .size = frame_desc.size},
+    };
+    WGPUBindGroupDescriptor bg_desc = {
+        .layout = bind_group_layout,
+        .entryCount = 6,
+        .entries = bg_entries,
+    };
+    cull_bind_group = gpu_create_bind_group(batch_device, &bg_desc, "sprite cull");
+    
+    // Create pipeline
+    WGPUPipelineLayoutDescriptor pl_desc = {
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &bind_group_layout,
+    };
+    WGPUPipelineLayout pipeline_layout = gpu_create_pipeline_layout(batch_device, &pl_desc, "sprite cull");
+    
+    WGPUComputePipelineDescriptor cp_desc = {
+        .layout = pipeline_layout,
+        .compute = {
+            .module = shader,
+            .entryPoint = {.data = "cs_main", .length = 7},
+        },
+    };
+    cull_pipeline = gpu_create_compute_pipeline(batch_device, &cp_desc, "sprite cull");
+    
+    // Cleanup
+    gpu_release_shader_module(shader);
+    gpu_release_bind_group_layout(bind_group_layout);
+    gpu_release_pipeline_layout(pipeline_layout);
+    
+    printf("Sprite cull pipeline created\n");
+}
+
+int sprite_batch_cull_is_ready(void) {
+    return cull_pipeline != NULL;
+}
+
+void sprite_batch_cull(WGPUCommandEncoder encoder, const void* entities, const uint16_t* frames, int count,
+                       const Camera* cam) {
+    culled_this_frame = 0;
+    if (!cull_pipeline) return;
+    if (count > MAX_CULL_SPRITES) count = MAX_CULL_SPRITES;
+    
+    // Queue writes land before this frame's command buffer runs: the args
+    // start at zero instances and the pass appends to them
+    uint32_t args[4] = {3 * (mesh_vertices - 2), 0, 0, 0};
+    gpu_write_buffer(batch_queue, draw_args_buffer, 0, args, sizeof(args));
+    culled_this_frame = 1;
+    if (count <= 0) return;
+    
+    gpu_write_buffer(batch_queue, entity_buffer, 0, entities, (size_t)count * SPRITE_CULL_RECORD_BYTES);
+    // Whole u32 words: an odd count takes the pair's unused half along
+    gpu_write_buffer(batch_queue, frame_buffer, 0, frames, (size_t)(count + 1) / 2 * sizeof(uint32_t));
+    
+    SpriteCullUniforms uniforms = {
+        .center = {cam->x, cam->y},
+        .half_extent = {(cam->max_x - cam->min_x) * 0.5f, (cam->max_y - cam->min_y) * 0.5f},
+        .entity_count = (uint32_t)count,
+        .image_count = (uint32_t)atlas_image_count,
+        .camera_distance = CAMERA_DISTANCE,
+    };
+    gpu_write_buffer(batch_queue, cull_uniform_buffer, 0, &uniforms, sizeof(uniforms));
+    
+    WGPUComputePassDescriptor pass_desc = {0};
+    WGPUComputePassEncoder pass = wgpuCommandEncoderBeginComputePass(encoder, &pass_desc);
+    wgpuComputePassEncoderSetPipeline(pass, cull_pipeline);
+    wgpuComputePassEncoderSetBindGroup(pass, 0, cull_bind_group, 0, NULL);
+    gpu_dispatch(pass, (count + SPRITE_CULL_WORKGROUP - 1) / SPRITE_CULL_WORKGROUP, 1, 1);
+    wgpuComputePassEncoderEnd(pass);
+    wgpuComputePassEncoderRelease(pass);
+}
+
+void sprite_batch_draw_culled(WGPURenderPassEncoder pass, const float* view_proj) {
+    if (!culled_this_frame) return;
+    culled_this_frame = 0;
+    
+    SpriteBatchUniforms uniforms = {0};
+    memcpy(uniforms.view_proj, view_proj, sizeof(uniforms.view_proj));
+    uniforms.mesh_vertices = mesh_vertices;
+    gpu_write_buffer(batch_queue, batch_uniform_buffer, 0, &uniforms, sizeof(uniforms));
+    
+    // Same pipeline as the CPU batch, fed from the culled instance buffer
+    gpu_set_pipeline(pass, batch_pipeline);
+    gpu_set_bind_group(pass, 0, batch_bind_group);
+    gpu_set_bind_group(pass, LIGHTING_BIND_GROUP, lighting_bind_group());
+    gpu_set_vertex_buffer(pass, 0, culled_buffer, 0, (uint64_t)MAX_CULL_SPRITES * sizeof(SpriteInstance));
+    gpu_draw_indirect(pass, draw_args_buffer, 0);
+}
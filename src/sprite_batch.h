@@ -0,0 +1,99 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <stdint.h>
+#include <webgpu/webgpu.h>
+#include "camera.h"
+
+// Batched textured sprites
+// Sprite images are packed offline (tools/build_atlas.py) into layers of a
+// 2D texture array. Every sprite queued during a frame becomes one instance
+// in a single instanced draw, whatever image it uses. Instead of a full quad
+// each instance is drawn with its image's convex alpha mesh (built offline,
+// at most mesh_vertices corners), so transparent space is not shaded.
+
+#define MAX_ATLAS_IMAGES 256
+#define MAX_SPRITE_INSTANCES 16384
+#define ATLAS_NAME_LENGTH 32
+#define MAX_MESH_VERTICES 16  // upper bound for an atlas's mesh_vertices
+#define MAX_CULL_SPRITES 131072  // entities the GPU cull pass takes per frame
+#define SPRITE_CULL_RECORD_BYTES 20  // x, y, z, angle, speed (the layout of Sprite)
+#define SPRITE_CULL_WORKGROUP 64     // matches @workgroup_size in sprite_cull.wgsl
+
+// Location of one sprite image in the texture array
+typedef struct {
+    char name[ATLAS_NAME_LENGTH];
+    uint32_t layer;
+    float uv_rect[4];  // u0, v0, u1, v1 (normalized, v0 = top row)
+    float width;       // source size in pixels
+    float height;
+} AtlasImage;
+
+// Per-instance vertex data (matches sprite_batch.wgsl)
+typedef struct {
+    float position[3];  // center in world space
+    float rotation;     // radians, same convention as Sprite.angle
+    float size[2];      // width, height in world units
+    float uv_rect[4];
+    uint16_t layer;
+    uint16_t mesh;      // atlas image whose mesh outlines the sprite
+    uint32_t color;     // RGBA8 tint, 0xAABBGGRR
+} SpriteInstance;
+
+// Initialize sprite batching (after the WebGPU device is ready)
+void sprite_batch_init(WGPUDevice device, WGPUQueue queue, WGPUTextureFormat format);
+
+// Load a packed atlas file and create the texture array. Returns 0 on success.
+int sprite_batch_load_atlas(const char* path);
+
+// Create the pipeline from WGSL source (after the atlas is loaded and
+// lighting_init)
+void sprite_batch_create_pipeline(const char* shader_source);
+
+// Release the atlas, pipeline and buffers
+void sprite_batch_shutdown(void);
+
+// Whether the atlas and pipeline are ready
+int sprite_batch_is_ready(void);
+
+// Atlas lookup
+int sprite_atlas_image_count(void);
+const AtlasImage* sprite_atlas_image(int index);
+int sprite_atlas_find(const char* name);  // index or -1
+
+// Queue a sprite for this frame's batch
+void sprite_batch_add(const SpriteInstance* instance);
+
+// Queue a sprite using an atlas image at its native pixel size times scale
+void sprite_batch_add_image(int image, float x, float y, float z, float rotation, float scale, uint32_t color);
+
+// Upload queued instances and draw them all with one call, then clear the batch
+void sprite_batch_flush(WGPURenderPassEncoder pass, const float* view_proj);
+
+// Draw instances that already live in a GPU buffer: range_count ranges, each
+// counts[i] instances starting at byte offsets[i], one draw per range
+void sprite_batch_draw_ranges(WGPURenderPassEncoder pass, const float* view_proj, WGPUBuffer buffer,
+                              const uint64_t* offsets, const int* counts, int range_count);
+
+// GPU-driven culling
+// A whole entity population is uploaded as is, with one bulk write. A
+// compute pass tests every entity against the camera, appends the visible
+// ones as instances to a GPU buffer and counts them into indirect draw
+// arguments, so no per-entity work is left on the CPU. Entity i is drawn
+// with atlas image frames[i] at its native size.
+
+// Create the cull pipeline from WGSL source (after the batch pipeline)
+void sprite_batch_create_cull_pipeline(const char* shader_source);
+
+int sprite_batch_cull_is_ready(void);
+
+// Upload count entity records (SPRITE_CULL_RECORD_BYTES each) and their
+// atlas images (frames, readable up to an even count) and record the cull
+// pass into encoder; call before any pass of the frame begins
+void sprite_batch_cull(WGPUCommandEncoder encoder, const void* entities, const uint16_t* frames, int count,
+                       const Camera* cam);
+
+// Draw the survivors of this frame's sprite_batch_cull with one indirect draw
+void sprite_batch_draw_culled(WGPURenderPassEncoder pass, const float* view_proj);
+
+#endif // SPRITE_BATCH_H
@@ -0,0 +1,182 @@
+#include "state_ring.h"
+#include "game.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Grow a buffer to at least size bytes (only when the state grows, so steady
+// state saves never allocate)
+static int reserve(uint8_t** data, size_t* capacity, size_t size) {
+    if (size <= *capacity) return 1;
+    uint8_t* grown = (uint8_t*)realloc(*data, size);
+    if (!grown) {
+        printf("State ring out of memory (%zu bytes)\n", size);
+        return 0;
+    }
+    *data = grown;
+    *capacity = size;
+    return 1;
+}
+
+int state_ring_init(StateRing* ring, int slot_count, StateRingMode mode) {
+    memset(ring, 0, sizeof(*ring));
+    ring->slots = (StateSlot*)calloc(slot_count, sizeof(StateSlot));
+    if (!ring->slots) return 1;
+    ring->slot_count = slot_count;
+    ring->mode = mode;
+    return 0;
+}
+
+void state_ring_free(StateRing* ring) {
+    for (int i = 0; i < ring->slot_count; i++) {
+        free(ring->slots[i].data);
+    }
+    free(ring->slots);
+    free(ring->shadow);
+    memset(ring, 0, sizeof(*ring));
+}
+
+// Ring index of the snapshot frames_back saves ago
+static int slot_index(const StateRing* ring, int frames_back) {
+    return (ring->head - 1 - frames_back + 2 * ring->slot_count) % ring->slot_count;
+}
+
+// Both savers fail before touching the slot or the shadow, so on failure the
+// slot still holds its previous snapshot. Return 0 on success.
+static int save_full(StateSlot* slot, const uint8_t* src, size_t size) {
+    if (!reserve(&slot->data, &slot->capacity, size)) return 1;
+    memcpy(slot->data, src, size);
+    slot->size = size;
+    slot->keyframe = 1;
+    return 0;
+}
+
+// Delta layout: u32 page count, u32 page indices, then the page contents
+static int save_delta(StateRing* ring, StateSlot* slot, const uint8_t* src, size_t size) {
+    size_t page_count = (size + STATE_RING_PAGE_SIZE - 1) / STATE_RING_PAGE_SIZE;
+    size_t header = sizeof(uint32_t) * (1 + page_count);
+    if (!reserve(&slot->data, &slot->capacity, header + size)) return 1;
+    
+    uint32_t* index = (uint32_t*)slot->data;
+    uint8_t* out = slot->data + header;
+    uint32_t changed = 0;
+    
+    for (size_t p = 0; p < page_count; p++) {
+        size_t offset = p * STATE_RING_PAGE_SIZE;
+        size_t len = size - offset < STATE_RING_PAGE_SIZE ? size - offset : STATE_RING_PAGE_SIZE;
+        
+        if (offset + len <= ring->shadow_size && memcmp(src + offset, ring->shadow + offset, len) == 0) {
+            continue;
+        }
+        index[1 + changed++] = (uint32_t)p;
+        memcpy(out, src + offset, len);
+        memcpy(ring->shadow + offset, src + offset, len);
+        out += len;
+    }
+    
+    index[0] = changed;
+    // Move page data down to sit right after the used part of the index
+    size_t data_size = (size_t)(out - (slot->data + header));
+    size_t used_header = sizeof(uint32_t) * (1 + changed);
+    memmove(slot->data + used_header, slot->data + header, data_size);
+    slot->size = used_header + data_size;
+    slot->keyframe = 0;
+    return 0;
+}
+
+// Apply a delta slot's pages on top of the shadow state
+static void apply_delta(StateRing* ring, const StateSlot* slot) {
+    const uint32_t* index = (const uint32_t*)slot->data;
+    uint32_t changed = index[0];
+    const uint8_t* in = slot->data + sizeof(uint32_t) * (1 + changed);
+    
+    for (uint32_t i = 0; i < changed; i++) {
+        size_t offset = (size_t)index[1 + i] * STATE_RING_PAGE_SIZE;
+        size_t len = slot->state_size - offset < STATE_RING_PAGE_SIZE ? slot->state_size - offset : STATE_RING_PAGE_SIZE;
+        memcpy(ring->shadow + offset, in, len);
+        in += len;
+    }
+    ring->shadow_size = slot->state_size;
+}
+
+int state_ring_save(StateRing* ring) {
+    const uint8_t* src = (const uint8_t*)game_state_data();
+    size_t size = game_state_size();
+    StateSlot* slot = &ring->slots[ring->head];
+    
+    if (ring->mode == STATE_RING_FULL) {
+        if (save_full(slot, src, size)) return 1;
+    } else {
+        if (!reserve(&ring->shadow, &ring->shadow_capacity, size)) return 1;
+        if (ring->since_keyframe == 0) {
+            if (save_full(slot, src, size)) return 1;
+            memcpy(ring->shadow, src, size);
+        } else if (save_delta(ring, slot, src, size)) {
+            return 1;
+        }
+        ring->shadow_size = size;
+        ring->since_keyframe = (ring->since_keyframe + 1) % STATE_RING_KEYFRAME_INTERVAL;
+    }
+    
+    slot->state_size = size;
+    slot->tick = game_tick();
+    ring->bytes_saved += slot->size;
+    ring->head = (ring->head + 1) % ring->slot_count;
+    if (ring->count < ring->slot_count) ring->count++;
+    return 0;
+}
+
+int state_ring_restore(StateRing* ring, int frames_back) {
+    if (frames_back < 0 || frames_back >= ring->count) return 1;
+    
+    int target = slot_index(ring, frames_back);
+    const StateSlot* slot = &ring->slots[target];
+    
+    if (slot->keyframe) {
+        game_state_restore(slot->data, slot->state_size);
+        if (ring->mode == STATE_RING_DELTA) {
+            if (!reserve(&ring->shadow, &ring->shadow_capacity, slot->state_size)) return 1;
+            memcpy(ring->shadow, slot->data, slot->state_size);
+            ring->shadow_size = slot->state_size;
+        }
+    } else {
+        // Find the keyframe this delta builds on, then replay deltas forward
+        int back = frames_back;
+        while (back < ring->count && !ring->slots[slot_index(ring, back)].keyframe) back++;
+        if (back >= ring->count) return 1;  // Keyframe already overwritten
+        
+        const StateSlot* key = &ring->slots[slot_index(ring, back)];
+        size_t max_size = key->state_size;
+        for (int b = back - 1; b >= frames_back; b--) {
+            size_t s = ring->slots[slot_index(ring, b)].state_size;
+            if (s > max_size) max_size = s;
+        }
+        if (!reserve(&ring->shadow, &ring->shadow_capacity, max_size)) return 1;
+        
+        memcpy(ring->shadow, key->data, key->state_size);
+        ring->shadow_size = key->state_size;
+        for (int b = back - 1; b >= frames_back; b--) {
+            apply_delta(ring, &ring->slots[slot_index(ring, b)]);
+        }
+        game_state_restore(ring->shadow, ring->shadow_size);
+    }
+    
+    // Drop the snapshots newer than the restored one
+    ring->head = (target + 1) % ring->slot_count;
+    ring->count -= frames_back;
+    
+    // Next save continues the delta chain from the restored state
+    int chain = 0;
+    while (chain < ring->count && !ring->slots[slot_index(ring, chain)].keyframe) chain++;
+    ring->since_keyframe = (chain + 1) % STATE_RING_KEYFRAME_INTERVAL;
+    return 0;
+}
+
+int state_ring_count(const StateRing* ring) {
+    return ring->count;
+}
+
+uint64_t state_ring_tick(const StateRing* ring, int frames_back) {
+    if (frames_back < 0 || frames_back >= ring->count) return 0;
+    return ring->slots[slot_index(ring, frames_back)].tick;
+}
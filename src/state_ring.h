@@ -0,0 +1,65 @@
+#ifndef STATE_RING_H
+#define STATE_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Ring of recent simulation snapshots for rewind and rollback.
+//
+// FULL mode stores each snapshot as a straight memcpy of the live game
+// state. DELTA mode stores a full keyframe every STATE_RING_KEYFRAME_INTERVAL
+// saves and otherwise only the pages that changed since the previous save,
+// which is much smaller when most of the world is static.
+
+#define STATE_RING_PAGE_SIZE 4096
+#define STATE_RING_KEYFRAME_INTERVAL 8
+
+typedef enum {
+    STATE_RING_FULL,
+    STATE_RING_DELTA,
+} StateRingMode;
+
+typedef struct {
+    uint8_t* data;      // full state (keyframe) or packed changed pages
+    size_t size;        // bytes used in data
+    size_t capacity;    // bytes allocated for data
+    size_t state_size;  // game_state_size() at save time
+    uint64_t tick;      // game_tick() at save time
+    int keyframe;       // data is a full copy
+} StateSlot;
+
+typedef struct {
+    StateSlot* slots;
+    int slot_count;
+    int head;           // index of the next slot to write
+    int count;          // number of valid snapshots
+    StateRingMode mode;
+    int since_keyframe;
+    uint8_t* shadow;    // DELTA: full copy of the last saved/restored state
+    size_t shadow_size;
+    size_t shadow_capacity;
+    uint64_t bytes_saved;  // total bytes written into slots
+} StateRing;
+
+// Allocate a ring holding up to slot_count snapshots. Returns 0 on success.
+int state_ring_init(StateRing* ring, int slot_count, StateRingMode mode);
+
+// Free all slot memory
+void state_ring_free(StateRing* ring);
+
+// Capture the current game state as the newest snapshot. Returns 0 on
+// success; on failure (out of memory) the ring is left as it was.
+int state_ring_save(StateRing* ring);
+
+// Restore the snapshot frames_back saves ago (0 = newest) and drop every
+// newer snapshot, since the timeline diverges from there.
+// Returns 0 on success, nonzero if no such restorable snapshot exists.
+int state_ring_restore(StateRing* ring, int frames_back);
+
+// Number of snapshots currently held
+int state_ring_count(const StateRing* ring);
+
+// Tick of the snapshot frames_back saves ago, or 0 if out of range
+uint64_t state_ring_tick(const StateRing* ring, int frames_back);
+
+#endif // STATE_RING_H
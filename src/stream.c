@@ -0,0 +1,425 @@
+#include "stream.h"
+#include "archive.h"
+#include "arena.h"
+#include "platform.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef GAME_THREADED
+#include <pthread.h>
+#endif
+
+#define LEVEL_MAGIC "PFLV"
+#define LEVEL_VERSION 1
+#define LEVEL_HEADER_BYTES 20
+#define REGION_NONE -1
+#define REGION_FAILED -2         // could not be decoded; never requested again
+#define STREAM_MAX_CANDIDATES 64  // nearest unloaded regions considered per frame
+
+typedef enum {
+    SLOT_FREE,
+    SLOT_QUEUED,     // the decode thread owns the slot until it leaves this state
+    SLOT_DECODED,
+    SLOT_FAILED,
+    SLOT_UPLOADING,
+    SLOT_RESIDENT,
+} SlotState;
+
+typedef struct {
+    atomic_int state;  // SlotState
+    int region;        // index in the level grid
+    uint32_t order;    // request order; earlier requests upload first
+    int size;          // decoded bytes, or -1
+    int uploaded;      // bytes handed to the upload hook so far
+    double decode_ms;
+    uint8_t* data;     // STREAM_SLOT_BYTES from the level arena
+} StreamSlot;
+
+// Level
+static Archive level;
+static int level_open = 0;
+static StreamHooks hooks;
+static int region_size = 0;
+static int regions_x = 0;
+static int regions_y = 0;
+static const ArchiveEntry** region_entries = NULL;  // per region, NULL if absent
+static int16_t* region_slot = NULL;                 // per region: slot, REGION_NONE or REGION_FAILED
+
+static StreamSlot slots[STREAM_MAX_RESIDENT];
+static uint8_t* raw_buffer = NULL;  // compressed record scratch (decode thread)
+static uint32_t next_order = 0;
+static StreamStats stats;
+
+#ifdef GAME_THREADED
+// Decode thread and its request queue (slot indices)
+static pthread_t decode_thread;
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_wake = PTHREAD_COND_INITIALIZER;
+static int queue[STREAM_MAX_RESIDENT];
+static int queue_head = 0;
+static int queue_count = 0;
+static int decode_running = 0;
+#endif
+
+// Read and decode a slot's region, then hand the slot back
+static void decode_slot(StreamSlot* slot) {
+    double start = platform_now_ms();
+    const ArchiveEntry* entry = region_entries[slot->region];
+    int size = -1;
+    if (entry && entry->size <= STREAM_RAW_BYTES && archive_read(&level, entry, raw_buffer) == 0) {
+        size = hooks.decode(hooks.user, raw_buffer, entry->size, slot->data, STREAM_SLOT_BYTES);
+    }
+    slot->size = size;
+    slot->decode_ms = platform_now_ms() - start;
+    atomic_store_explicit(&slot->state, size >= 0 ? SLOT_DECODED : SLOT_FAILED, memory_order_release);
+}
+
+#ifdef GAME_THREADED
+static void* decode_main(void* arg) {
+    (void)arg;
+    for (;;) {
+        pthread_mutex_lock(&queue_lock);
+        while (decode_running && queue_count == 0) pthread_cond_wait(&queue_wake, &queue_lock);
+        if (!decode_running) {
+            pthread_mutex_unlock(&queue_lock);
+            break;
+        }
+        int index = queue[queue_head];
+        queue_head = (queue_head + 1) % STREAM_MAX_RESIDENT;
+        queue_count--;
+        pthread_mutex_unlock(&queue_lock);
+        
+        decode_slot(&slots[index]);
+    }
+    return NULL;
+}
+#endif
+
+static void request_decode(int index) {
+#ifdef GAME_THREADED
+    pthread_mutex_lock(&queue_lock);
+    queue[(queue_head + queue_count) % STREAM_MAX_RESIDENT] = index;
+    queue_count++;
+    pthread_cond_signal(&queue_wake);
+    pthread_mutex_unlock(&queue_lock);
+#else
+    decode_slot(&slots[index]);
+#endif
+}
+
+static SlotState slot_state(int index) {
+    return (SlotState)atomic_load_explicit(&slots[index].state, memory_order_acquire);
+}
+
+static void free_slot(int index) {
+    region_slot[slots[index].region] = REGION_NONE;
+    atomic_store_explicit(&slots[index].state, SLOT_FREE, memory_order_relaxed);
+}
+
+int stream_open(const char* path, const StreamHooks* config) {
+    if (level_open) stream_close();
+    Arena* arena = arena_level();
+    if (archive_open(&level, path, arena)) return 1;
+    
+    // Header: magic, version, region size, grid size
+    uint8_t header[LEVEL_HEADER_BYTES];
+    uint32_t fields[4];
+    const ArchiveEntry* entry = archive_find(&level, "level");
+    if (!entry || entry->size != LEVEL_HEADER_BYTES || archive_read(&level, entry, header) ||
+        memcmp(header, LEVEL_MAGIC, 4) != 0) {
+        printf("Not a level: %s\n", path);
+        archive_close(&level);
+        return 1;
+    }
+    memcpy(fields, header + 4, sizeof(fields));
+    region_size = (int)fields[1];
+    regions_x = (int)fields[2];
+    regions_y = (int)fields[3];
+    if (fields[0] != LEVEL_VERSION || region_size <= 0 || regions_x <= 0 || regions_y <= 0 ||
+        (int64_t)regions_x * regions_y > STREAM_MAX_REGIONS) {
+        printf("Unsupported level: %s\n", path);
+        archive_close(&level);
+        return 1;
+    }
+    
+    // Index regions by grid position with one pass over the entry names
+    int region_count = regions_x * regions_y;
+    region_entries = (const ArchiveEntry**)arena_calloc(arena, region_count * sizeof(*region_entries));
+    region_slot = (int16_t*)arena_alloc(arena, region_count * sizeof(*region_slot));
+    raw_buffer = (uint8_t*)arena_alloc(arena, STREAM_RAW_BYTES);
+    for (int i = 0; i < STREAM_MAX_RESIDENT; i++) {
+        slots[i].data = (uint8_t*)arena_alloc(arena, STREAM_SLOT_BYTES);
+        if (!slots[i].data) break;
+        atomic_store_explicit(&slots[i].state, SLOT_FREE, memory_order_relaxed);
+    }
+    if (!region_entries || !region_slot || !raw_buffer || !slots[STREAM_MAX_RESIDENT - 1].data) {
+        printf("Level arena too small for streaming\n");
+        archive_close(&level);
+        return 1;
+    }
+    for (int i = 0; i < region_count; i++) region_slot[i] = REGION_NONE;
+    for (uint32_t i = 0; i < level.entry_count; i++) {
+        int x, y;
+        if (sscanf(level.entries[i].name, "region_%d_%d", &x, &y) == 2 &&
+            x >= 0 && x < regions_x && y >= 0 && y < regions_y) {
+            region_entries[y * regions_x + x] = &level.entries[i];
+        }
+    }
+    
+    hooks = *config;
+    memset(&stats, 0, sizeof(stats));
+    next_order = 0;
+    level_open = 1;
+
+#ifdef GAME_THREADED
+    queue_head = queue_count = 0;
+    decode_running = 1;
+    if (pthread_create(&decode_thread, NULL, decode_main, NULL) != 0) {
+        decode_running = 0;
+        stream_close();
+        return 1;
+    }
+#endif
+
+    printf("Level streaming: %dx%d regions of %d units, %d slots of %d KB\n",
+           regions_x, regions_y, region_size, STREAM_MAX_RESIDENT, STREAM_SLOT_BYTES / 1024);
+    return 0;
+}
+
+void stream_close(void) {
+    if (!level_open) return;
+#ifdef GAME_THREADED
+    if (decode_running) {
+        pthread_mutex_lock(&queue_lock);
+        decode_running = 0;
+        pthread_cond_broadcast(&queue_wake);
+        pthread_mutex_unlock(&queue_lock);
+        pthread_join(decode_thread, NULL);
+    }
+#endif
+    archive_close(&level);
+    for (int i = 0; i < STREAM_MAX_RESIDENT; i++) {
+        atomic_store_explicit(&slots[i].state, SLOT_FREE, memory_order_relaxed);
+    }
+    level_open = 0;
+}
+
+int stream_is_open(void) {
+    return level_open;
+}
+
+float stream_region_size(void) {
+    return (float)region_size;
+}
+
+// Regions overlapping the view grown by margin regions, clamped to the grid:
+// min x, min y, max x, max y (inclusive)
+static void region_range(float x, float y, float half_width, float half_height, int margin, int range[4]) {
+    range[0] = (int)floorf((x - half_width) / region_size) - margin;
+    range[1] = (int)floorf((y - half_height) / region_size) - margin;
+    range[2] = (int)floorf((x + half_width) / region_size) + margin;
+    range[3] = (int)floorf((y + half_height) / region_size) + margin;
+    if (range[0] < 0) range[0] = 0;
+    if (range[1] < 0) range[1] = 0;
+    if (range[2] > regions_x - 1) range[2] = regions_x - 1;
+    if (range[3] > regions_y - 1) range[3] = regions_y - 1;
+}
+
+static int in_range(int region, const int range[4]) {
+    int rx = region % regions_x, ry = region / regions_x;
+    return rx >= range[0] && rx <= range[2] && ry >= range[1] && ry <= range[3];
+}
+
+// Squared distance from (x, y) to a region's center
+static float region_distance(int region, float x, float y) {
+    float dx = (region % regions_x + 0.5f) * region_size - x;
+    float dy = (region / regions_x + 0.5f) * region_size - y;
+    return dx * dx + dy * dy;
+}
+
+// Take finished decodes from the decode thread
+static void collect_decoded(void) {
+    for (int i = 0; i < STREAM_MAX_RESIDENT; i++) {
+        SlotState state = slot_state(i);
+        if (state == SLOT_DECODED) {
+            stats.decode_ms += slots[i].decode_ms;
+            slots[i].uploaded = 0;
+            atomic_store_explicit(&slots[i].state, SLOT_UPLOADING, memory_order_relaxed);
+        } else if (state == SLOT_FAILED) {
+            stats.decode_ms += slots[i].decode_ms;
+            stats.regions_failed++;
+            int region = slots[i].region;
+            free_slot(i);
+            region_slot[region] = REGION_FAILED;
+        }
+    }
+}
+
+// Hand decoded bytes to the upload hook, earliest request first, until this
+// frame's budget is spent. A region only becomes drawable once complete.
+// Returns the number of regions completed.
+static int upload_decoded(void) {
+    int completed = 0;
+    int budget = STREAM_UPLOAD_BUDGET;
+    while (budget > 0) {
+        int next = -1;
+        for (int i = 0; i < STREAM_MAX_RESIDENT; i++) {
+            if (slot_state(i) != SLOT_UPLOADING) continue;
+            if (next < 0 || slots[i].order < slots[next].order) next = i;
+        }
+        if (next < 0) break;
+        
+        StreamSlot* slot = &slots[next];
+        int chunk = slot->size - slot->uploaded;
+        if (chunk > budget) chunk = budget;
+        if (chunk > 0) hooks.upload(hooks.user, next, slot->data + slot->uploaded, slot->uploaded, chunk);
+        slot->uploaded += chunk;
+        budget -= chunk;
+        stats.bytes_uploaded += chunk;
+        if (slot->uploaded == slot->size) {
+            atomic_store_explicit(&slot->state, SLOT_RESIDENT, memory_order_relaxed);
+            stats.regions_loaded++;
+            completed++;
+        }
+    }
+    int frame_bytes = STREAM_UPLOAD_BUDGET - budget;
+    if (frame_bytes > stats.peak_frame_bytes) stats.peak_frame_bytes = frame_bytes;
+    return completed;
+}
+
+// Free a slot for a region at distance: a free one if any, else the one
+// farthest away, provided that is farther than distance. Returns -1 if none.
+static int claim_slot(float x, float y, float distance) {
+    int farthest = -1;
+    float farthest_distance = distance;
+    for (int i = 0; i < STREAM_MAX_RESIDENT; i++) {
+        SlotState state = slot_state(i);
+        if (state == SLOT_FREE) return i;
+        if (state != SLOT_UPLOADING && state != SLOT_RESIDENT) continue;
+        float d = region_distance(slots[i].region, x, y);
+        if (d > farthest_distance) {
+            farthest = i;
+            farthest_distance = d;
+        }
+    }
+    if (farthest >= 0) {
+        stats.regions_evicted++;
+        free_slot(farthest);
+    }
+    return farthest;
+}
+
+// Request the nearest regions in range that are not loaded or queued
+static void request_regions(float x, float y, const int range[4]) {
+    int in_flight = 0;
+    for (int i = 0; i < STREAM_MAX_RESIDENT; i++) {
+        if (slot_state(i) == SLOT_QUEUED) in_flight++;
+    }
+#ifdef GAME_THREADED
+    int requests = STREAM_MAX_IN_FLIGHT - in_flight;
+#else
+    int requests = STREAM_INLINE_DECODES - in_flight;
+#endif
+    if (requests <= 0) return;
+    
+    // Nearest candidates, kept sorted by insertion
+    int candidates[STREAM_MAX_CANDIDATES];
+    float distances[STREAM_MAX_CANDIDATES];
+    int count = 0;
+    for (int ry = range[1]; ry <= range[3]; ry++) {
+        for (int rx = range[0]; rx <= range[2]; rx++) {
+            int region = ry * regions_x + rx;
+            if (region_slot[region] != REGION_NONE) continue;
+            float d = region_distance(region, x, y);
+            if (count == STREAM_MAX_CANDIDATES && d >= distances[count - 1]) continue;
+            int k = count < STREAM_MAX_CANDIDATES ? count++ : count - 1;
+            while (k > 0 && distances[k - 1] > d) {
+                candidates[k] = candidates[k - 1];
+                distances[k] = distances[k - 1];
+                k--;
+            }
+            candidates[k] = region;
+            distances[k] = d;
+        }
+    }
+    
+    for (int c = 0; c < count && requests > 0; c++) {
+        int index = claim_slot(x, y, distances[c]);
+        if (index < 0) break;
+        StreamSlot* slot = &slots[index];
+        slot->region = candidates[c];
+        slot->order = next_order++;
+        slot->size = 0;
+        region_slot[candidates[c]] = (int16_t)index;
+        atomic_store_explicit(&slot->state, SLOT_QUEUED, memory_order_release);
+        request_decode(index);
+        requests--;
+    }
+}
+
+int stream_update(float x, float y, float half_width, float half_height) {
+    if (!level_open) return 0;
+    
+    collect_decoded();
+    int completed = upload_decoded();
+    
+    // Evict regions past the keep margin; regions being decoded are left to
+    // finish and go on the next update
+    int keep[4], want[4];
+    region_range(x, y, half_width, half_height, STREAM_KEEP_REGIONS, keep);
+    for (int i = 0; i < STREAM_MAX_RESIDENT; i++) {
+        SlotState state = slot_state(i);
+        if ((state == SLOT_UPLOADING || state == SLOT_RESIDENT) && !in_range(slots[i].region, keep)) {
+            stats.regions_evicted++;
+            free_slot(i);
+        }
+    }
+    
+    region_range(x, y, half_width, half_height, STREAM_PREFETCH_REGIONS, want);
+    request_regions(x, y, want);
+    
+    stats.resident = 0;
+    for (int i = 0; i < STREAM_MAX_RESIDENT; i++) {
+        if (slot_state(i) == SLOT_RESIDENT) stats.resident++;
+    }
+    if (stats.resident > stats.peak_resident) stats.peak_resident = stats.resident;
+    return completed;
+}
+
+int stream_slot_ready(int slot, float rect[4]) {
+    if (!level_open || slot < 0 || slot >= STREAM_MAX_RESIDENT || slot_state(slot) != SLOT_RESIDENT) return 0;
+    int region = slots[slot].region;
+    rect[0] = (float)(region % regions_x * region_size);
+    rect[1] = (float)(region / regions_x * region_size);
+    rect[2] = rect[0] + region_size;
+    rect[3] = rect[1] + region_size;
+    return slots[slot].size;
+}
+
+int stream_missing(float x, float y, float half_width, float half_height) {
+    if (!level_open) return 0;
+    int range[4], missing = 0;
+    region_range(x, y, half_width, half_height, 0, range);
+    for (int ry = range[1]; ry <= range[3]; ry++) {
+        for (int rx = range[0]; rx <= range[2]; rx++) {
+            int index = region_slot[ry * regions_x + rx];
+            if (index == REGION_FAILED) continue;
+            if (index == REGION_NONE || slot_state(index) != SLOT_RESIDENT) missing++;
+        }
+    }
+    return missing;
+}
+
+const StreamStats* stream_stats(void) {
+    return &stats;
+}
+
+void stream_report(void) {
+    if (!level_open) return;
+    printf("Streaming: %d/%d regions resident (peak %d), %d loaded, %d evicted, %d failed, "
+           "%.1f KB uploaded (peak %.1f KB/frame), %.1f ms decoding\n",
+           stats.resident, STREAM_MAX_RESIDENT, stats.peak_resident, stats.regions_loaded,
+           stats.regions_evicted, stats.regions_failed, stats.bytes_uploaded / 1024.0,
+           stats.peak_frame_bytes / 1024.0, stats.decode_ms);
+}
@@ -0,0 +1,82 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Camera-driven level streaming
+//
+// A level (written by tools/build_level.py) is an archive of square regions.
+// Each frame stream_update is given the view rectangle: regions around it
+// are requested nearest first, decoded off the main thread (a worker thread
+// in GAME_THREADED builds, otherwise at most STREAM_INLINE_DECODES per
+// frame), then handed to the upload hook in pieces of at most
+// STREAM_UPLOAD_BUDGET bytes per frame. Regions that drift out of range are
+// evicted. Every region lives in one of STREAM_MAX_RESIDENT fixed slots
+// allocated when the level is opened, so memory stays constant however
+// large the level is.
+
+#define STREAM_MAX_RESIDENT 32           // region slots
+#define STREAM_SLOT_BYTES (32 * 1024)     // decoded data per region
+#define STREAM_RAW_BYTES (16 * 1024)      // region record as stored
+#define STREAM_UPLOAD_BUDGET (64 * 1024)  // bytes handed to upload per frame
+#define STREAM_MAX_IN_FLIGHT 4            // regions queued for decoding at once
+#define STREAM_INLINE_DECODES 1           // per frame without a worker thread
+#define STREAM_PREFETCH_REGIONS 1         // regions beyond the view to request
+#define STREAM_KEEP_REGIONS 2             // regions beyond the view to keep
+#define STREAM_MAX_REGIONS 65536          // regions per level
+
+typedef struct {
+    // Turn a region record into upload-ready bytes in out (capacity bytes).
+    // Returns the size, a multiple of 4, or -1 on failure. Runs on the
+    // decode thread.
+    int (*decode)(void* user, const void* raw, size_t raw_size, void* out, size_t capacity);
+    
+    // Copy size bytes, starting at offset into the slot's data, to the GPU
+    // (main thread). Offsets and sizes are multiples of 4.
+    void (*upload)(void* user, int slot, const void* data, size_t offset, size_t size);
+    
+    void* user;
+} StreamHooks;
+
+typedef struct {
+    int regions_loaded;
+    int regions_evicted;
+    int regions_failed;
+    int resident;            // slots holding an uploaded region now
+    int peak_resident;
+    uint64_t bytes_uploaded;
+    int peak_frame_bytes;    // most bytes uploaded in one frame
+    double decode_ms;        // total time spent decoding, on any thread
+} StreamStats;
+
+// Open a level archive and allocate the region slots from the level arena.
+// Returns 0 on success.
+int stream_open(const char* path, const StreamHooks* hooks);
+
+// Stop the decode thread and close the level (the level arena is not reset)
+void stream_close(void);
+
+int stream_is_open(void);
+
+// Level geometry in world units
+float stream_region_size(void);
+
+// Request, upload and evict regions for a view centered at (x, y) with the
+// given half extents in world units. Returns the number of regions whose
+// upload completed.
+int stream_update(float x, float y, float half_width, float half_height);
+
+// Bytes of a fully uploaded region in slot (0 if the slot holds none), and
+// its world rectangle: min x, min y, max x, max y
+int stream_slot_ready(int slot, float rect[4]);
+
+// Number of regions overlapping a view that are not uploaded yet
+int stream_missing(float x, float y, float half_width, float half_height);
+
+const StreamStats* stream_stats(void);
+
+// Print the stats
+void stream_report(void);
+
+#endif // STREAM_H
@@ -1,15 +1,16 @@
 #include "text.h"
-#include <emscripten.h>
+#include "arena.h"
+#include "archive.h"
+#include "gpu_resources.h"
+#include "gpu_trace.h"
+#include "platform.h"
+#ifndef GAME_HEADLESS
+#include "image_upload.h"
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-// Vertex data (position + uv)
-typedef struct {
-    float position[2];
-    float uv[2];
-} TextVertex;
-
 // Uniform data
 typedef struct {
     float transform[16];  // 4x4 matrix
@@ -34,6 +35,15 @@ static FontData font_data = {0};
 static int text_vertex_count = 0;
 static int font_texture_loaded = 0;
 static int font_data_loaded = 0;
+static uint32_t font_generation = 0;  // bumped each time the font texture is replaced
+
+// Label batch (vertices in the persistent arena, reused every flush)
+static TextVertex* label_vertices = NULL;
+static int label_vertex_count = 0;
+static WGPUBuffer label_vertex_buffer = NULL;
+static WGPUBuffer label_uniform_buffer = NULL;
+static WGPUBindGroup label_bind_group = NULL;
+static uint32_t label_font_generation = 0;  // font texture the bind group was made for
 
 // Shader source (set via text_create_pipeline)
 static const char* text_shader_source = NULL;
@@ -158,6 +168,36 @@ void text_parse_fnt_data(const char* data) {
            (int)font_data.scale_w, (int)font_data.scale_h);
 }
 
+// Emit the two triangles of one glyph with its top-left pen position at
+// (cursor_x, cursor_y). Returns the number of vertices written (0 or 6).
+static int emit_glyph(const Glyph* g, float cursor_x, float cursor_y, float scale, TextVertex* vertices) {
+    if (g->width == 0 || g->height == 0) return 0;  // Space or unknown character
+    
+    // Calculate vertex positions (screen space)
+    float x0 = cursor_x + g->xoffset * scale;
+    float y0 = cursor_y - g->yoffset * scale;  // Flip Y for top-left origin
+    float x1 = x0 + g->width * scale;
+    float y1 = y0 - g->height * scale;
+    
+    // Calculate UV coordinates (normalized 0-1)
+    float u0 = g->x / font_data.scale_w;
+    float v0 = g->y / font_data.scale_h;
+    float u1 = (g->x + g->width) / font_data.scale_w;
+    float v1 = (g->y + g->height) / font_data.scale_h;
+    
+    // Two triangles per glyph (6 vertices)
+    // Triangle 1: top-left, top-right, bottom-right
+    vertices[0] = (TextVertex){{x0, y0}, {u0, v0}};
+    vertices[1] = (TextVertex){{x1, y0}, {u1, v0}};
+    vertices[2] = (TextVertex){{x1, y1}, {u1, v1}};
+    
+    // Triangle 2: top-left, bottom-right, bottom-left
+    vertices[3] = (TextVertex){{x0, y0}, {u0, v0}};
+    vertices[4] = (TextVertex){{x1, y1}, {u1, v1}};
+    vertices[5] = (TextVertex){{x0, y1}, {u0, v1}};
+    return 6;
+}
+
 // Build text vertices for a string
 // Returns the number of vertices generated
 static int build_text_vertices(const char* text, float x, float y, float scale, TextVertex* vertices) {
@@ -172,35 +212,8 @@ static int build_text_vertices(const char* text, float x, float y, float scale,
         
         if (ch >= MAX_GLYPHS) continue;
         
-        Glyph* g = &font_data.glyphs[ch];
-        if (g->width == 0 || g->height == 0) {
-            // Space or unknown character - just advance
-            cursor_x += g->xadvance * scale;
-            continue;
-        }
-        
-        // Calculate vertex positions (screen space)
-        float x0 = cursor_x + g->xoffset * scale;
-        float y0 = cursor_y - g->yoffset * scale;  // Flip Y for top-left origin
-        float x1 = x0 + g->width * scale;
-        float y1 = y0 - g->height * scale;
-        
-        // Calculate UV coordinates (normalized 0-1)
-        float u0 = g->x / font_data.scale_w;
-        float v0 = g->y / font_data.scale_h;
-        float u1 = (g->x + g->width) / font_data.scale_w;
-        float v1 = (g->y + g->height) / font_data.scale_h;
-        
-        // Two triangles per glyph (6 vertices)
-        // Triangle 1: top-left, top-right, bottom-right
-        vertices[vertex_count++] = (TextVertex){{x0, y0}, {u0, v0}};
-        vertices[vertex_count++] = (TextVertex){{x1, y0}, {u1, v0}};
-        vertices[vertex_count++] = (TextVertex){{x1, y1}, {u1, v1}};
-        
-        // Triangle 2: top-left, bottom-right, bottom-left
-        vertices[vertex_count++] = (TextVertex){{x0, y0}, {u0, v0}};
-        vertices[vertex_count++] = (TextVertex){{x1, y1}, {u1, v1}};
-        vertices[vertex_count++] = (TextVertex){{x0, y1}, {u0, v1}};
+        const Glyph* g = &font_data.glyphs[ch];
+        vertex_count += emit_glyph(g, cursor_x, cursor_y, scale, vertices + vertex_count);
         
         // Advance cursor
         cursor_x += g->xadvance * scale;
@@ -226,10 +239,90 @@ float calculate_text_width(const char* text, float scale) {
     return width;
 }
 
+// Line height at a given scale
+float text_line_height(float scale) {
+    return font_data.loaded ? font_data.line_height * scale : 0;
+}
+
 // Forward declaration
 static void create_text_pipeline_internal(void);
 
-// Called from JavaScript when the font texture image is loaded
+// Bind group for a uniform buffer and the current font texture
+static WGPUBindGroup create_font_bind_group(WGPUBuffer uniform_buffer, const char* owner) {
+    WGPUBindGroupEntry bg_entries[] = {
+        {
+            .binding = 0,
+            .buffer = uniform_buffer,
+            .offset = 0,
+            .size = sizeof(TextUniforms),
+        },
+        {
+            .binding = 1,
+            .textureView = font_texture_view,
+        },
+        {
+            .binding = 2,
+            .sampler = font_sampler,
+        },
+    };
+    WGPUBindGroupDescriptor bg_desc = {
+        .layout = text_bind_group_layout,
+        .entryCount = 3,
+        .entries = bg_entries,
+    };
+    return gpu_create_bind_group(text_device, &bg_desc, owner);
+}
+
+// Make texture (RGBA8, already filled) the font texture. A new font
+// replaces the old texture; bind groups that reference it are rebuilt
+// (layouts and labels notice the generation change when drawn).
+static void set_font_texture(WGPUTexture texture) {
+    gpu_release_bind_group(text_bind_group);
+    gpu_release_view(font_texture_view);
+    gpu_release_texture(font_texture);
+    text_bind_group = NULL;
+    font_texture = texture;
+    font_generation++;
+    
+    // Create texture view
+    WGPUTextureViewDescriptor view_desc = {
+        .format = WGPUTextureFormat_RGBA8Unorm,
+        .dimension = WGPUTextureViewDimension_2D,
+        .baseMipLevel = 0,
+        .mipLevelCount = 1,
+        .baseArrayLayer = 0,
+        .arrayLayerCount = 1,
+        .aspect = WGPUTextureAspect_All,
+    };
+    font_texture_view = gpu_create_view(font_texture, &view_desc, "text");
+    
+    // Create sampler (once; it does not depend on the texture)
+    if (!font_sampler) {
+        WGPUSamplerDescriptor sampler_desc = {
+            .addressModeU = WGPUAddressMode_ClampToEdge,
+            .addressModeV = WGPUAddressMode_ClampToEdge,
+            .addressModeW = WGPUAddressMode_ClampToEdge,
+            .magFilter = WGPUFilterMode_Linear,
+            .minFilter = WGPUFilterMode_Linear,
+            .mipmapFilter = WGPUMipmapFilterMode_Linear,
+            .lodMinClamp = 0.0f,
+            .lodMaxClamp = 1.0f,
+            .maxAnisotropy = 1,
+        };
+        font_sampler = gpu_create_sampler(text_device, &sampler_desc, "text");
+    }
+    
+    font_texture_loaded = 1;
+    
+    if (text_pipeline) {
+        text_bind_group = create_font_bind_group(text_uniform_buffer, "text");
+    } else {
+        create_text_pipeline_internal();
+    }
+}
+
+// Called from JavaScript with the font's RGBA pixels in the WASM heap
+// (fallback where ImageBitmaps cannot be copied to textures)
 EMSCRIPTEN_KEEPALIVE
 void upload_font_texture(unsigned char* data, int width, int height) {
     printf("Uploading font texture: %dx%d\n", width, height);
@@ -243,7 +336,7 @@ void upload_font_texture(unsigned char* data, int width, int height) {
         .mipLevelCount = 1,
         .sampleCount = 1,
     };
-    font_texture = wgpuDeviceCreateTexture(text_device, &tex_desc);
+    WGPUTexture texture = gpu_create_texture(text_device, &tex_desc, "text");
     
     // Upload data
     WGPUTexelCopyBufferLayout data_layout = {
@@ -253,45 +346,31 @@ void upload_font_texture(unsigned char* data, int width, int height) {
     };
     WGPUExtent3D write_size = {width, height, 1};
     WGPUTexelCopyTextureInfo dest = {
-        .texture = font_texture,
+        .texture = texture,
         .mipLevel = 0,
         .origin = {0, 0, 0},
         .aspect = WGPUTextureAspect_All,
     };
-    wgpuQueueWriteTexture(text_queue, &dest, data, width * height * 4, &data_layout, &write_size);
-    
-    // Create texture view
-    WGPUTextureViewDescriptor view_desc = {
-        .format = WGPUTextureFormat_RGBA8Unorm,
-        .dimension = WGPUTextureViewDimension_2D,
-        .baseMipLevel = 0,
-        .mipLevelCount = 1,
-        .baseArrayLayer = 0,
-        .arrayLayerCount = 1,
-        .aspect = WGPUTextureAspect_All,
-    };
-    font_texture_view = wgpuTextureCreateView(font_texture, &view_desc);
-    
-    // Create sampler
-    WGPUSamplerDescriptor sampler_desc = {
-        .addressModeU = WGPUAddressMode_ClampToEdge,
-        .addressModeV = WGPUAddressMode_ClampToEdge,
-        .addressModeW = WGPUAddressMode_ClampToEdge,
-        .magFilter = WGPUFilterMode_Linear,
-        .minFilter = WGPUFilterMode_Linear,
-        .mipmapFilter = WGPUMipmapFilterMode_Linear,
-        .lodMinClamp = 0.0f,
-        .lodMaxClamp = 1.0f,
-        .maxAnisotropy = 1,
-    };
-    font_sampler = wgpuDeviceCreateSampler(text_device, &sampler_desc);
+    gpu_write_texture(text_queue, &dest, data, width * height * 4, &data_layout, &write_size);
     
-    font_texture_loaded = 1;
+    set_font_texture(texture);
     printf("Font texture created and uploaded\n");
-    
-    create_text_pipeline_internal();
 }
 
+#ifndef GAME_HEADLESS
+// Called from JavaScript with the handle of the decoded font image; it is
+// copied straight to the GPU and then released
+EMSCRIPTEN_KEEPALIVE
+void upload_font_image(int image) {
+    WGPUTexture texture = image_upload_texture(text_device, text_queue, image, "text");
+    if (texture) {
+        printf("Font texture copied from image: %dx%d\n", image_width(image), image_height(image));
+        set_font_texture(texture);
+    }
+    image_release(image);
+}
+#endif
+
 // Called from JavaScript when font data file is loaded
 EMSCRIPTEN_KEEPALIVE
 void load_font_data(const char* data) {
@@ -301,30 +380,16 @@ void load_font_data(const char* data) {
 
 // Load font data from a .fnt file path
 void text_load_font_file(const char* fnt_path) {
-    FILE* f = fopen(fnt_path, "rb");
-    if (!f) {
-        printf("Failed to open font file: %s\n", fnt_path);
-        return;
-    }
+    // The file text is only needed while parsing
+    Arena* scratch = arena_frame();
+    ArenaMark mark = arena_mark(scratch);
     
-    fseek(f, 0, SEEK_END);
-    long size = ftell(f);
-    fseek(f, 0, SEEK_SET);
-    
-    char* buffer = (char*)malloc(size + 1);
-    if (!buffer) {
-        printf("Failed to allocate memory for font file: %s\n", fnt_path);
-        fclose(f);
-        return;
+    char* buffer = assets_load(scratch, fnt_path, NULL);
+    if (buffer) {
+        text_parse_fnt_data(buffer);
     }
     
-    size_t read = fread(buffer, 1, size, f);
-    buffer[read] = '\0';
-    fclose(f);
-    
-    printf("Loaded font file: %s (%ld bytes)\n", fnt_path, size);
-    text_parse_fnt_data(buffer);
-    free(buffer);
+    arena_rewind(scratch, mark);
 }
 
 // Set shader source and try to create pipeline
@@ -348,21 +413,21 @@ static void create_text_pipeline_internal(void) {
     WGPUShaderModuleDescriptor shader_desc = {
         .nextInChain = (WGPUChainedStruct*)&wgsl_source,
     };
-    WGPUShaderModule shader = wgpuDeviceCreateShaderModule(text_device, &shader_desc);
+    WGPUShaderModule shader = gpu_create_shader_module(text_device, &shader_desc, "text");
     
     // Create text vertex buffer
     WGPUBufferDescriptor vb_desc = {
         .usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst,
         .size = MAX_TEXT_VERTICES * sizeof(TextVertex),
     };
-    text_vertex_buffer = wgpuDeviceCreateBuffer(text_device, &vb_desc);
+    text_vertex_buffer = gpu_create_buffer(text_device, &vb_desc, "text");
     
     // Create text uniform buffer
     WGPUBufferDescriptor ub_desc = {
         .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
         .size = sizeof(TextUniforms),
     };
-    text_uniform_buffer = wgpuDeviceCreateBuffer(text_device, &ub_desc);
+    text_uniform_buffer = gpu_create_buffer(text_device, &ub_desc, "text");
     
     // Create bind group layout for text (uniform + texture + sampler)
     WGPUBindGroupLayoutEntry bgl_entries[] = {
@@ -395,38 +460,17 @@ static void create_text_pipeline_internal(void) {
         .entryCount = 3,
         .entries = bgl_entries,
     };
-    text_bind_group_layout = wgpuDeviceCreateBindGroupLayout(text_device, &bgl_desc);
+    text_bind_group_layout = gpu_create_bind_group_layout(text_device, &bgl_desc, "text");
     
     // Create bind group
-    WGPUBindGroupEntry bg_entries[] = {
-        {
-            .binding = 0,
-            .buffer = text_uniform_buffer,
-            .offset = 0,
-            .size = sizeof(TextUniforms),
-        },
-        {
-            .binding = 1,
-            .textureView = font_texture_view,
-        },
-        {
-            .binding = 2,
-            .sampler = font_sampler,
-        },
-    };
-    WGPUBindGroupDescriptor bg_desc = {
-        .layout = text_bind_group_layout,
-        .entryCount = 3,
-        .entries = bg_entries,
-    };
-    text_bind_group = wgpuDeviceCreateBindGroup(text_device, &bg_desc);
+    text_bind_group = create_font_bind_group(text_uniform_buffer, "text");
     
     // Create pipeline layout
     WGPUPipelineLayoutDescriptor pl_desc = {
         .bindGroupLayoutCount = 1,
         .bindGroupLayouts = &text_bind_group_layout,
     };
-    WGPUPipelineLayout pipeline_layout = wgpuDeviceCreatePipelineLayout(text_device, &pl_desc);
+    WGPUPipelineLayout pipeline_layout = gpu_create_pipeline_layout(text_device, &pl_desc, "text");
     
     // Create render pipeline
     WGPUVertexAttribute attrs[] = {
@@ -485,15 +529,42 @@ static void create_text_pipeline_internal(void) {
             .mask = 0xFFFFFFFF,
         },
     };
-    text_pipeline = wgpuDeviceCreateRenderPipeline(text_device, &rp_desc);
+    text_pipeline = gpu_create_render_pipeline(text_device, &rp_desc, "text");
     
     // Cleanup
-    wgpuShaderModuleRelease(shader);
-    wgpuPipelineLayoutRelease(pipeline_layout);
+    gpu_release_shader_module(shader);
+    gpu_release_pipeline_layout(pipeline_layout);
     
     printf("Text rendering pipeline created\n");
 }
 
+void text_shutdown(void) {
+    gpu_release_bind_group(label_bind_group);
+    gpu_release_buffer(label_vertex_buffer);
+    gpu_release_buffer(label_uniform_buffer);
+    label_bind_group = NULL;
+    label_vertex_buffer = NULL;
+    label_uniform_buffer = NULL;
+    label_vertex_count = 0;
+    gpu_release_render_pipeline(text_pipeline);
+    gpu_release_bind_group(text_bind_group);
+    gpu_release_bind_group_layout(text_bind_group_layout);
+    gpu_release_buffer(text_vertex_buffer);
+    gpu_release_buffer(text_uniform_buffer);
+    gpu_release_sampler(font_sampler);
+    gpu_release_view(font_texture_view);
+    gpu_release_texture(font_texture);
+    text_pipeline = NULL;
+    text_bind_group = NULL;
+    text_bind_group_layout = NULL;
+    text_vertex_buffer = NULL;
+    text_uniform_buffer = NULL;
+    font_sampler = NULL;
+    font_texture_view = NULL;
+    font_texture = NULL;
+    font_texture_loaded = 0;
+}
+
 // Check if text rendering is ready
 int text_is_ready(void) {
     return text_pipeline != NULL && font_data.loaded;
@@ -503,14 +574,15 @@ int text_is_ready(void) {
 void render_text(WGPURenderPassEncoder pass, const char* text, float x, float y, float scale, float r, float g, float b) {
     if (!text_pipeline || !font_data.loaded) return;
     
-    // Build vertices for the text
-    TextVertex vertices[MAX_TEXT_VERTICES];
+    // Build vertices for the text (scratch memory, freed with the frame)
+    TextVertex* vertices = (TextVertex*)arena_alloc(arena_frame(), MAX_TEXT_VERTICES * sizeof(TextVertex));
+    if (!vertices) return;
     text_vertex_count = build_text_vertices(text, x, y, scale, vertices);
     
     if (text_vertex_count == 0) return;
     
     // Upload vertices
-    wgpuQueueWriteBuffer(text_queue, text_vertex_buffer, 0, vertices, text_vertex_count * sizeof(TextVertex));
+    gpu_write_buffer(text_queue, text_vertex_buffer, 0, vertices, text_vertex_count * sizeof(TextVertex));
     
     // Update uniforms - just use orthographic projection (no rotation/scale for text)
     TextUniforms uniforms;
@@ -520,11 +592,290 @@ void render_text(WGPURenderPassEncoder pass, const char* text, float x, float y,
     uniforms.color[2] = b;
     uniforms.color[3] = 1.0f;
     
-    wgpuQueueWriteBuffer(text_queue, text_uniform_buffer, 0, &uniforms, sizeof(TextUniforms));
+    gpu_write_buffer(text_queue, text_uniform_buffer, 0, &uniforms, sizeof(TextUniforms));
     
     // Draw text
-    wgpuRenderPassEncoderSetPipeline(pass, text_pipeline);
-    wgpuRenderPassEncoderSetBindGroup(pass, 0, text_bind_group, 0, NULL);
-    wgpuRenderPassEncoderSetVertexBuffer(pass, 0, text_vertex_buffer, 0, text_vertex_count * sizeof(TextVertex));
-    wgpuRenderPassEncoderDraw(pass, text_vertex_count, 1, 0, 0);
+    gpu_set_pipeline(pass, text_pipeline);
+    gpu_set_bind_group(pass, 0, text_bind_group);
+    gpu_set_vertex_buffer(pass, 0, text_vertex_buffer, 0, text_vertex_count * sizeof(TextVertex));
+    gpu_draw(pass, text_vertex_count, 1);
+}
+
+// Label batch
+
+void text_label_add(const char* text, float x, float y, float scale) {
+    if (!text_is_ready()) return;
+    if (!label_vertices) {
+        label_vertices = (TextVertex*)arena_alloc(arena_persistent(), MAX_LABEL_VERTICES * sizeof(TextVertex));
+        if (!label_vertices) return;
+    }
+    
+    float cursor_x = x;
+    for (const char* c = text; *c; c++) {
+        int ch = (unsigned char)*c;
+        if (ch >= MAX_GLYPHS) continue;
+        if (label_vertex_count > MAX_LABEL_VERTICES - 6) break;
+        
+        const Glyph* g = &font_data.glyphs[ch];
+        label_vertex_count += emit_glyph(g, cursor_x, y, scale, label_vertices + label_vertex_count);
+        cursor_x += g->xadvance * scale;
+    }
+}
+
+void text_label_flush(WGPURenderPassEncoder pass, float r, float g, float b) {
+    if (!text_is_ready() || label_vertex_count == 0) return;
+    
+    // GPU objects are created on first use
+    if (!label_vertex_buffer) {
+        WGPUBufferDescriptor vb_desc = {
+            .usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst,
+            .size = MAX_LABEL_VERTICES * sizeof(TextVertex),
+        };
+        label_vertex_buffer = gpu_create_buffer(text_device, &vb_desc, "text labels");
+        
+        WGPUBufferDescriptor ub_desc = {
+            .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+            .size = sizeof(TextUniforms),
+        };
+        label_uniform_buffer = gpu_create_buffer(text_device, &ub_desc, "text labels");
+    }
+    
+    // A replaced font texture invalidates the bind group
+    if (!label_bind_group || label_font_generation != font_generation) {
+        gpu_release_bind_group(label_bind_group);
+        label_bind_group = create_font_bind_group(label_uniform_buffer, "text labels");
+        label_font_generation = font_generation;
+    }
+    
+    gpu_write_buffer(text_queue, label_vertex_buffer, 0, label_vertices, label_vertex_count * sizeof(TextVertex));
+    
+    TextUniforms uniforms;
+    mat4_ortho(uniforms.transform, 0, (float)text_canvas_width, 0, (float)text_canvas_height);
+    uniforms.color[0] = r;
+    uniforms.color[1] = g;
+    uniforms.color[2] = b;
+    uniforms.color[3] = 1.0f;
+    gpu_write_buffer(text_queue, label_uniform_buffer, 0, &uniforms, sizeof(TextUniforms));
+    
+    gpu_set_pipeline(pass, text_pipeline);
+    gpu_set_bind_group(pass, 0, label_bind_group);
+    gpu_set_vertex_buffer(pass, 0, label_vertex_buffer, 0, label_vertex_count * sizeof(TextVertex));
+    gpu_draw(pass, label_vertex_count, 1);
+    label_vertex_count = 0;
+}
+
+// Paragraph layout
+
+int text_layout_init(TextLayout* layout, Arena* arena, int capacity, float max_width, float scale, TextAlign align) {
+    memset(layout, 0, sizeof(*layout));
+    
+    // Every byte could start a line and every byte could be a glyph
+    layout->text = (char*)arena_alloc(arena, capacity + 1);
+    layout->lines = (TextLine*)arena_alloc(arena, (capacity + 1) * sizeof(TextLine));
+    layout->vertices = (TextVertex*)arena_alloc(arena, capacity * 6 * sizeof(TextVertex));
+    if (!layout->text || !layout->lines || !layout->vertices) return 1;
+    
+    layout->text[0] = '\0';
+    layout->capacity = capacity;
+    layout->max_width = max_width;
+    layout->scale = scale;
+    layout->align = align;
+    return 0;
+}
+
+void text_layout_release(TextLayout* layout) {
+    gpu_release_bind_group(layout->bind_group);
+    gpu_release_buffer(layout->uniform_buffer);
+    gpu_release_buffer(layout->vertex_buffer);
+    layout->bind_group = NULL;
+    layout->uniform_buffer = NULL;
+    layout->vertex_buffer = NULL;
+}
+
+static float glyph_advance(const TextLayout* layout, char c) {
+    int ch = (unsigned char)c;
+    return ch < MAX_GLYPHS ? font_data.glyphs[ch].xadvance * layout->scale : 0.0f;
+}
+
+// Measure one line starting at pos: greedy, breaking after the last space
+// that keeps the line within max_width. Returns the start of the next line.
+static int measure_line(const TextLayout* layout, int pos, TextLine* line) {
+    const char* text = layout->text;
+    float width = 0.0f;
+    int break_at = -1;         // a space the line may end before
+    float break_width = 0.0f;
+    int i = pos;
+    
+    while (i < layout->length && text[i] != '\n') {
+        float advance = glyph_advance(layout, text[i]);
+        if (text[i] == ' ') {
+            // Spaces never force a wrap; they hang past the edge instead
+            if (i > pos && text[i - 1] != ' ') {
+                break_at = i;
+                break_width = width;
+            }
+        } else if (width + advance > layout->max_width && i > pos) {
+            int next;
+            if (break_at > pos) {
+                line->end = break_at;
+                line->width = break_width;
+                next = break_at;
+            } else {
+                // A single word wider than the line: split it here
+                line->end = i;
+                line->width = width;
+                next = i;
+            }
+            while (next < layout->length && text[next] == ' ') next++;
+            line->start = pos;
+            return next;
+        }
+        width += advance;
+        i++;
+    }
+    
+    // End of text or hard break; trailing spaces do not count for alignment
+    int end = i;
+    while (end > pos && text[end - 1] == ' ') {
+        end--;
+        width -= glyph_advance(layout, ' ');
+    }
+    line->start = pos;
+    line->end = end;
+    line->width = width;
+    return i < layout->length ? i + 1 : i;
+}
+
+// Build the vertices of one line (layout-local, top-left origin, y up)
+static void build_line_vertices(TextLayout* layout, int index) {
+    TextLine* line = &layout->lines[index];
+    float x = 0.0f;
+    if (layout->align == TEXT_ALIGN_CENTER) x = (layout->max_width - line->width) / 2.0f;
+    if (layout->align == TEXT_ALIGN_RIGHT) x = layout->max_width - line->width;
+    float y = -index * font_data.line_height * layout->scale;
+    
+    line->first_vertex = layout->vertex_count;
+    for (int i = line->start; i < line->end; i++) {
+        int ch = (unsigned char)layout->text[i];
+        if (ch >= MAX_GLYPHS) continue;
+        const Glyph* g = &font_data.glyphs[ch];
+        layout->vertex_count += emit_glyph(g, x, y, layout->scale, layout->vertices + layout->vertex_count);
+        x += g->xadvance * layout->scale;
+    }
+    line->vertex_count = layout->vertex_count - line->first_vertex;
+}
+
+// Drop lines from first_line on and lay the rest of the text out again
+static void relayout_from(TextLayout* layout, int first_line) {
+    if (first_line > layout->line_count) first_line = layout->line_count;
+    int pos = first_line < layout->line_count ? layout->lines[first_line].start : 0;
+    
+    layout->line_count = first_line;
+    layout->vertex_count = first_line > 0 ? layout->lines[first_line - 1].first_vertex +
+                                            layout->lines[first_line - 1].vertex_count : 0;
+    if (layout->vertex_count < layout->dirty_vertex) layout->dirty_vertex = layout->vertex_count;
+    layout->lines_relaid = 0;
+    if (!font_data.loaded) return;
+    
+    for (;;) {
+        TextLine* line = &layout->lines[layout->line_count];
+        int next = measure_line(layout, pos, line);
+        build_line_vertices(layout, layout->line_count);
+        layout->line_count++;
+        layout->lines_relaid++;
+        
+        // A text ending in '\n' gets an empty last line for the next
+        // append to continue on
+        int open_line = next == layout->length && next > line->start && layout->text[next - 1] == '\n';
+        if (next >= layout->length && !open_line) break;
+        pos = next;
+    }
+}
+
+void text_layout_set(TextLayout* layout, const char* text) {
+    size_t length = strlen(text);
+    if (length > (size_t)layout->capacity) length = layout->capacity;
+    memcpy(layout->text, text, length);
+    layout->text[length] = '\0';
+    layout->length = (int)length;
+    relayout_from(layout, 0);
+}
+
+void text_layout_append(TextLayout* layout, const char* text, size_t length) {
+    size_t space = layout->capacity - layout->length;
+    if (length > space) length = space;
+    if (length == 0) return;
+    memcpy(layout->text + layout->length, text, length);
+    layout->length += (int)length;
+    layout->text[layout->length] = '\0';
+    
+    // Lines before the last one ended where the next word did not fit or at
+    // a newline, and appending cannot change either
+    relayout_from(layout, layout->line_count > 0 ? layout->line_count - 1 : 0);
+}
+
+void text_layout_set_width(TextLayout* layout, float max_width, TextAlign align) {
+    if (max_width == layout->max_width && align == layout->align) return;
+    layout->max_width = max_width;
+    layout->align = align;
+    relayout_from(layout, 0);
+}
+
+float text_layout_height(const TextLayout* layout) {
+    return layout->line_count * font_data.line_height * layout->scale;
+}
+
+void render_text_layout(WGPURenderPassEncoder pass, TextLayout* layout, float x, float y, float r, float g, float b) {
+    if (!text_pipeline || !font_data.loaded) return;
+    
+    // Text set before the font finished loading is laid out now
+    if (layout->length > 0 && layout->line_count == 0) relayout_from(layout, 0);
+    if (layout->vertex_count == 0) return;
+    
+    if (!layout->vertex_buffer) {
+        WGPUBufferDescriptor vb_desc = {
+            .usage = WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst,
+            .size = layout->capacity * 6 * sizeof(TextVertex),
+        };
+        layout->vertex_buffer = gpu_create_buffer(text_device, &vb_desc, "text layout");
+        
+        WGPUBufferDescriptor ub_desc = {
+            .usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst,
+            .size = sizeof(TextUniforms),
+        };
+        layout->uniform_buffer = gpu_create_buffer(text_device, &ub_desc, "text layout");
+        
+        layout->dirty_vertex = 0;
+    }
+    
+    // A replaced font texture invalidates the bind group
+    if (!layout->bind_group || layout->font_generation != font_generation) {
+        gpu_release_bind_group(layout->bind_group);
+        layout->bind_group = create_font_bind_group(layout->uniform_buffer, "text layout");
+        layout->font_generation = font_generation;
+    }
+    
+    // Upload only the vertices of lines laid out since the last draw
+    if (layout->dirty_vertex < layout->vertex_count) {
+        gpu_write_buffer(text_queue, layout->vertex_buffer, layout->dirty_vertex * sizeof(TextVertex),
+                             layout->vertices + layout->dirty_vertex,
+                             (layout->vertex_count - layout->dirty_vertex) * sizeof(TextVertex));
+    }
+    layout->dirty_vertex = layout->vertex_count;
+    
+    // Orthographic projection, translated to the layout's position
+    TextUniforms uniforms;
+    mat4_ortho(uniforms.transform, 0, (float)text_canvas_width, 0, (float)text_canvas_height);
+    uniforms.transform[12] += uniforms.transform[0] * x;
+    uniforms.transform[13] += uniforms.transform[5] * y;
+    uniforms.color[0] = r;
+    uniforms.color[1] = g;
+    uniforms.color[2] = b;
+    uniforms.color[3] = 1.0f;
+    gpu_write_buffer(text_queue, layout->uniform_buffer, 0, &uniforms, sizeof(TextUniforms));
+    
+    gpu_set_pipeline(pass, text_pipeline);
+    gpu_set_bind_group(pass, 0, layout->bind_group);
+    gpu_set_vertex_buffer(pass, 0, layout->vertex_buffer, 0, layout->vertex_count * sizeof(TextVertex));
+    gpu_draw(pass, layout->vertex_count, 1);
 }
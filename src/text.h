@@ -2,10 +2,12 @@
 #define TEXT_H
 
 #include <webgpu/webgpu.h>
+#include "arena.h"
 
 // Text rendering constants
 #define MAX_GLYPHS 256
 #define MAX_TEXT_VERTICES 1024  // Max characters * 6 vertices per char
+#define MAX_LABEL_VERTICES 32768  // Label batch: glyphs queued per flush * 6
 
 // Glyph data from .fnt file
 typedef struct {
@@ -16,6 +18,12 @@ typedef struct {
     float xadvance;
 } Glyph;
 
+// Vertex data (position + uv)
+typedef struct {
+    float position[2];
+    float uv[2];
+} TextVertex;
+
 // Font data
 typedef struct {
     Glyph glyphs[MAX_GLYPHS];
@@ -36,9 +44,16 @@ void text_load_font_file(const char* fnt_path);
 // Parse font data directly from string
 void text_parse_fnt_data(const char* data);
 
-// Upload font texture (called from JavaScript when image is loaded)
+// Upload font texture from RGBA pixels in memory (called from JavaScript
+// when the image cannot be copied to the GPU directly)
 void upload_font_texture(unsigned char* data, int width, int height);
 
+#ifndef GAME_HEADLESS
+// Copy a decoded font image (a handle, see image_upload.h) to the font
+// texture and release the image (called from JavaScript)
+void upload_font_image(int image);
+#endif
+
 // Load font data (called from JavaScript)
 void load_font_data(const char* data);
 
@@ -49,13 +64,92 @@ void text_create_pipeline(const char* shader_source);
 // Render text at a specific position
 void render_text(WGPURenderPassEncoder pass, const char* text, float x, float y, float scale, float r, float g, float b);
 
+// Queue a single-line label for the next text_label_flush. Labels share
+// one vertex buffer and draw call; glyphs past MAX_LABEL_VERTICES are
+// dropped.
+void text_label_add(const char* text, float x, float y, float scale);
+
+// Draw all queued labels in one color and empty the batch
+void text_label_flush(WGPURenderPassEncoder pass, float r, float g, float b);
+
 // Calculate text width for centering
 float calculate_text_width(const char* text, float scale);
 
+// Line height at a given scale (for layout and culling)
+float text_line_height(float scale);
+
 // Check if text rendering is ready
 int text_is_ready(void);
 
+// Release all text GPU objects (layouts are released separately)
+void text_shutdown(void);
+
 // Update canvas dimensions (call when canvas resizes)
 void text_set_canvas_size(int width, int height);
 
+// Paragraph layout
+//
+// A TextLayout wraps text greedily at word boundaries to max_width (words
+// longer than a line are split), honours '\n', and aligns each line. Glyph
+// vertices are kept per layout in their own GPU buffer. Appending text only
+// re-lays out the last line: greedy breaks before it cannot change, so their
+// vertices are neither rebuilt nor re-uploaded.
+
+typedef enum {
+    TEXT_ALIGN_LEFT,
+    TEXT_ALIGN_CENTER,
+    TEXT_ALIGN_RIGHT,
+} TextAlign;
+
+typedef struct {
+    int start;         // first byte of the line
+    int end;           // one past the last byte drawn (trailing spaces excluded)
+    float width;
+    int first_vertex;
+    int vertex_count;
+} TextLine;
+
+typedef struct {
+    char* text;
+    int length;
+    int capacity;          // bytes of text, not counting the terminator
+    float max_width;       // in pixels
+    float scale;
+    TextAlign align;
+    
+    TextLine* lines;
+    int line_count;
+    TextVertex* vertices;
+    int vertex_count;
+    int dirty_vertex;      // first vertex not yet uploaded
+    int lines_relaid;      // lines laid out by the last change (for stats)
+    
+    WGPUBuffer vertex_buffer;
+    WGPUBuffer uniform_buffer;
+    WGPUBindGroup bind_group;
+    uint32_t font_generation;  // font texture the bind group was made for
+} TextLayout;
+
+// Reserve storage for up to capacity bytes of text from arena.
+// Returns 0 on success.
+int text_layout_init(TextLayout* layout, Arena* arena, int capacity, float max_width, float scale, TextAlign align);
+
+// Release the layout's GPU objects (its arena memory goes with the arena)
+void text_layout_release(TextLayout* layout);
+
+// Replace the whole text
+void text_layout_set(TextLayout* layout, const char* text);
+
+// Append length bytes of text, re-laying out only from the last line
+void text_layout_append(TextLayout* layout, const char* text, size_t length);
+
+// Change wrap width or alignment (full relayout)
+void text_layout_set_width(TextLayout* layout, float max_width, TextAlign align);
+
+// Height of all lines in pixels
+float text_layout_height(const TextLayout* layout);
+
+// Draw with the top-left corner of the layout box at (x, y), y up
+void render_text_layout(WGPURenderPassEncoder pass, TextLayout* layout, float x, float y, float r, float g, float b);
+
 #endif // TEXT_H
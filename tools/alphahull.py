@@ -0,0 +1,104 @@
+"""Tight convex meshes around the visible pixels of a sprite.
+
+A sprite drawn as a full quad shades every transparent pixel in its
+rectangle. alpha_hull returns a convex polygon that still covers every
+pixel with non-zero alpha (plus the half-texel fringe bilinear filtering
+can reach) using at most a given number of vertices, so the rasterizer
+skips most of the empty space.
+"""
+
+
+def _cross(o, a, b):
+    return (a[0] - o[0]) * (b[1] - o[1]) - (a[1] - o[1]) * (b[0] - o[0])
+
+
+def polygon_area(points):
+    area = 0.0
+    for i in range(len(points)):
+        x0, y0 = points[i]
+        x1, y1 = points[(i + 1) % len(points)]
+        area += x0 * y1 - x1 * y0
+    return abs(area) / 2.0
+
+
+def convex_hull(points):
+    """Andrew's monotone chain; collinear points are dropped."""
+    points = sorted(set(points))
+    if len(points) < 3:
+        return points
+    lower, upper = [], []
+    for p in points:
+        while len(lower) >= 2 and _cross(lower[-2], lower[-1], p) <= 0:
+            lower.pop()
+        lower.append(p)
+    for p in reversed(points):
+        while len(upper) >= 2 and _cross(upper[-2], upper[-1], p) <= 0:
+            upper.pop()
+        upper.append(p)
+    return lower[:-1] + upper[:-1]
+
+
+def _remove_edge(hull, i, width, height):
+    """Replace edge i with the point where its neighbouring edges meet.
+
+    Returns (area added, new point), or None if the neighbours diverge or
+    meet outside the image rectangle.
+    """
+    n = len(hull)
+    a0, a1 = hull[(i - 1) % n], hull[i]
+    b0, b1 = hull[(i + 2) % n], hull[(i + 1) % n]
+    da = (a1[0] - a0[0], a1[1] - a0[1])
+    db = (b1[0] - b0[0], b1[1] - b0[1])
+    denom = da[0] * db[1] - da[1] * db[0]
+    if abs(denom) < 1e-9:
+        return None
+    t = ((b0[0] - a0[0]) * db[1] - (b0[1] - a0[1]) * db[0]) / denom
+    s = ((b0[0] - a0[0]) * da[1] - (b0[1] - a0[1]) * da[0]) / denom
+    if t <= 1.0 or s <= 1.0:
+        return None
+    q = (a0[0] + t * da[0], a0[1] + t * da[1])
+    if not (-1e-6 <= q[0] <= width + 1e-6 and -1e-6 <= q[1] <= height + 1e-6):
+        return None
+    return polygon_area([a1, q, b1]), q
+
+
+def alpha_hull(width, height, rgba, max_vertices):
+    """Convex polygon in pixel coordinates (y down) covering all alpha > 0.
+
+    Falls back to the full rectangle when no polygon within the budget is
+    smaller than it.
+    """
+    rect = [(0.0, 0.0), (float(width), 0.0), (float(width), float(height)), (0.0, float(height))]
+    points = []
+    for y in range(height):
+        row = rgba[(y * width) * 4 + 3:((y + 1) * width) * 4:4]
+        opaque = [x for x, a in enumerate(row) if a]
+        if not opaque:
+            continue
+        # Bilinear sampling reaches half a texel past the last visible pixel
+        x0 = max(opaque[0] - 0.5, 0.0)
+        x1 = min(opaque[-1] + 1.5, float(width))
+        y0 = max(y - 0.5, 0.0)
+        y1 = min(y + 1.5, float(height))
+        points += [(x0, y0), (x1, y0), (x0, y1), (x1, y1)]
+    if not points:
+        return rect
+
+    hull = convex_hull(points)
+    # Drop one edge at a time, always the one that grows the hull least
+    while len(hull) > max_vertices:
+        best = None
+        for i in range(len(hull)):
+            result = _remove_edge(hull, i, width, height)
+            if result and (best is None or result[0] < best[0]):
+                best = (result[0], i, result[1])
+        if best is None:
+            return rect
+        _, i, q = best
+        n = len(hull)
+        hull[i] = q
+        del hull[(i + 1) % n]
+
+    if polygon_area(hull) >= polygon_area(rect) * 0.98:
+        return rect
+    return hull
@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""Pack a directory of PNG sprites into texture-array layers.
+
+Usage: build_atlas.py <sprite_dir> <output.atlas> [--layer-size N] [--mesh-vertices N]
+
+Sprites are shelf-packed (tallest first) into square RGBA8 layers with a
+1-pixel extruded border to stop filtering from bleeding between neighbours.
+Each sprite also gets a convex mesh around its visible pixels with at most
+--mesh-vertices corners (default 8), drawn instead of the full quad.
+The output is loaded by src/sprite_batch.c; layout (little endian):
+
+    char[4]  magic "PFAT"
+    u32      version
+    u32      layer_size
+    u32      layer_count
+    u32      image_count
+    u32      mesh_vertices
+    image_count x { char name[32]; u32 layer; u32 x, y, width, height; }
+    image_count x mesh_vertices x { f32 u, v; }  (0..1 over the image, v down)
+    layer_count x layer_size * layer_size * 4 bytes of RGBA8 pixels
+
+Meshes with fewer corners than mesh_vertices repeat their last one.
+"""
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import alphahull  # noqa: E402
+import pngio  # noqa: E402
+
+ATLAS_MAGIC = b"PFAT"
+ATLAS_VERSION = 2
+MAX_MESH_VERTICES = 16  # must match src/sprite_batch.h
+NAME_LENGTH = 32
+PADDING = 1
+
+
+def pack(images, layer_size):
+    """Assign (layer, x, y) to each image using shelf packing."""
+    placements = {}
+    layer, shelf_x, shelf_y, shelf_h = 0, 0, 0, 0
+    for name, (w, h, _) in sorted(images.items(), key=lambda kv: (-kv[1][1], kv[0])):
+        pw, ph = w + 2 * PADDING, h + 2 * PADDING
+        if pw > layer_size or ph > layer_size:
+            raise ValueError(f"{name}: {w}x{h} does not fit in a {layer_size} layer")
+        if shelf_x + pw > layer_size:
+            shelf_x, shelf_y, shelf_h = 0, shelf_y + shelf_h, 0
+        if shelf_y + ph > layer_size:
+            layer, shelf_x, shelf_y, shelf_h = layer + 1, 0, 0, 0
+        placements[name] = (layer, shelf_x + PADDING, shelf_y + PADDING)
+        shelf_x += pw
+        shelf_h = max(shelf_h, ph)
+    return placements, layer + 1
+
+
+def blit(layer, layer_size, x0, y0, w, h, rgba):
+    """Copy an image into a layer, extruding its edge pixels into the padding."""
+    for y in range(-PADDING, h + PADDING):
+        sy = min(max(y, 0), h - 1)
+        for x in range(-PADDING, w + PADDING):
+            sx = min(max(x, 0), w - 1)
+            src = (sy * w + sx) * 4
+            dst = ((y0 + y) * layer_size + (x0 + x)) * 4
+            layer[dst:dst + 4] = rgba[src:src + 4]
+
+
+def report_overdraw(images, meshes):
+    """Compare shaded fragments for one instance of every sprite at 1:1."""
+    quad_total = mesh_total = visible_total = 0.0
+    for name in sorted(images):
+        w, h, rgba = images[name]
+        visible = sum(1 for a in rgba[3::4] if a)
+        quad = float(w * h)
+        mesh = alphahull.polygon_area(meshes[name])
+        quad_total += quad
+        mesh_total += mesh
+        visible_total += visible
+        print(f"  {name:<16} quad {quad:8.0f}  mesh {mesh:8.0f}  visible {visible:8d}  "
+              f"({100.0 * (1.0 - mesh / quad):4.1f}% fewer fragments)")
+    if quad_total:
+        print(f"Test scene (one of each): {quad_total:.0f} -> {mesh_total:.0f} fragments, "
+              f"empty fragments {quad_total - visible_total:.0f} -> {max(mesh_total - visible_total, 0):.0f} "
+              f"({100.0 * (1.0 - mesh_total / quad_total):.1f}% less overdraw)")
+
+
+def main():
+    args = sys.argv[1:]
+    layer_size = 512
+    if "--layer-size" in args:
+        i = args.index("--layer-size")
+        layer_size = int(args[i + 1])
+        del args[i:i + 2]
+    mesh_vertices = 8
+    if "--mesh-vertices" in args:
+        i = args.index("--mesh-vertices")
+        mesh_vertices = int(args[i + 1])
+        del args[i:i + 2]
+    if not 4 <= mesh_vertices <= MAX_MESH_VERTICES:
+        print(f"--mesh-vertices must be between 4 and {MAX_MESH_VERTICES}")
+        return 1
+    if layer_size % 64 != 0:
+        # Rows must be a multiple of 256 bytes for GPU buffer-to-texture copies
+        print("--layer-size must be a multiple of 64")
+        return 1
+    if len(args) != 2:
+        print(__doc__)
+        return 1
+    src_dir, out_path = args
+
+    images = {}
+    for filename in sorted(os.listdir(src_dir)):
+        if filename.lower().endswith(".png"):
+            name = os.path.splitext(filename)[0]
+            if len(name.encode()) >= NAME_LENGTH:
+                raise ValueError(f"{filename}: name longer than {NAME_LENGTH - 1} bytes")
+            images[name] = pngio.read_png(os.path.join(src_dir, filename))
+
+    placements, layer_count = pack(images, layer_size)
+    layers = [bytearray(layer_size * layer_size * 4) for _ in range(layer_count)]
+    for name, (layer, x, y) in placements.items():
+        w, h, rgba = images[name]
+        blit(layers[layer], layer_size, x, y, w, h, rgba)
+
+    meshes = {}
+    for name, (w, h, rgba) in images.items():
+        hull = alphahull.alpha_hull(w, h, rgba, mesh_vertices)
+        meshes[name] = hull + [hull[-1]] * (mesh_vertices - len(hull))
+
+    os.makedirs(os.path.dirname(out_path) or ".", exist_ok=True)
+    with open(out_path, "wb") as f:
+        f.write(ATLAS_MAGIC)
+        f.write(struct.pack("<IIIII", ATLAS_VERSION, layer_size, layer_count, len(images), mesh_vertices))
+        for name in sorted(images):
+            layer, x, y = placements[name]
+            w, h, _ = images[name]
+            f.write(name.encode().ljust(NAME_LENGTH, b"\0"))
+            f.write(struct.pack("<IIIII", layer, x, y, w, h))
+        for name in sorted(images):
+            w, h, _ = images[name]
+            for px, py in meshes[name]:
+                f.write(struct.pack("<ff", px / w, py / h))
+        for layer in layers:
+            f.write(layer)
+
+    print(f"Packed {len(images)} sprites into {layer_count} layer(s) of {layer_size}x{layer_size}: {out_path}")
+    report_overdraw(images, meshes)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
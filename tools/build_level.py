@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""Generate a streamed level: ground decorations split into square regions.
+
+Usage: build_level.py <output.pak> [--size N] [--region N] [--density N] [--seed N]
+
+The level covers --size x --size world units (default 4096, the size of the
+game world) cut into --region square regions (default 512). Each region gets
+a seeded scatter of about --density decorations (default 200), so every run
+produces the same level. The output is an archive (see build_pak.py) read by
+src/stream.c, with the entries (little endian):
+
+    "level"
+        char[4]  magic "PFLV"
+        u32      version
+        u32      region_size
+        u32      regions_x
+        u32      regions_y
+    "region_<x>_<y>", one per region
+        u32      decoration_count
+        decoration_count x { f32 x, y, rotation, scale; u32 image; u32 color; }
+
+image is taken modulo the sprite atlas's image count when the region is
+decoded; color is RGBA8 (0xAABBGGRR).
+"""
+import os
+import random
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from build_pak import write_pak  # noqa: E402
+
+LEVEL_MAGIC = b"PFLV"
+LEVEL_VERSION = 1
+MAX_REGION_DECORATIONS = 512  # must match src/level.h
+
+
+def option(args, name, default):
+    if name in args:
+        return int(args[args.index(name) + 1])
+    return default
+
+
+def region_bytes(rng, x0, y0, region_size, density):
+    count = min(MAX_REGION_DECORATIONS, int(density * rng.uniform(0.6, 1.4)))
+    data = bytearray(struct.pack("<I", count))
+    for _ in range(count):
+        shade = rng.randint(70, 130)
+        color = 0xFF000000 | (shade << 16) | (shade << 8) | shade
+        data += struct.pack(
+            "<4f2I",
+            x0 + rng.random() * region_size,
+            y0 + rng.random() * region_size,
+            rng.random() * 6.2831853,
+            rng.uniform(0.3, 0.7),
+            rng.randrange(1 << 16),
+            color,
+        )
+    return bytes(data)
+
+
+def main():
+    args = sys.argv[1:]
+    if not args or args[0].startswith("--"):
+        print(__doc__)
+        sys.exit(1)
+    out_path = args[0]
+    size = option(args, "--size", 4096)
+    region_size = option(args, "--region", 512)
+    density = option(args, "--density", 200)
+    rng = random.Random(option(args, "--seed", 1))
+
+    regions = (size + region_size - 1) // region_size
+    files = [("level", LEVEL_MAGIC + struct.pack("<4I", LEVEL_VERSION, region_size, regions, regions))]
+    for y in range(regions):
+        for x in range(regions):
+            data = region_bytes(rng, x * region_size, y * region_size, region_size, density)
+            files.append((f"region_{x}_{y}", data))
+    write_pak(out_path, files)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""Pack game assets into one indexed archive with per-entry compression.
+
+Usage: build_pak.py <output.pak> [--store] <file>@<name> ...
+
+Each <file> is stored under <name>, the path the game opens it by (the same
+syntax as emcc --preload-file). Entries are LZ4-compressed unless that does
+not make them smaller, or --store is given. The output is read by
+src/archive.c; layout (little endian):
+
+    char[4]  magic "PFPK"
+    u32      version
+    u32      entry_count
+    u32      reserved (0)
+    entry_count x { char name[48]; u32 codec; u32 offset; u32 packed_size; u32 size; }
+    entry data, each starting on a 16-byte boundary
+
+codec is 0 for stored bytes, 1 for an LZ4 block.
+"""
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import lz4block  # noqa: E402
+
+PAK_MAGIC = b"PFPK"
+PAK_VERSION = 1
+NAME_LENGTH = 48
+ALIGN = 16
+CODEC_STORED = 0
+CODEC_LZ4 = 1
+ENTRY_FORMAT = f"<{NAME_LENGTH}s4I"
+
+
+def align_up(value):
+    return (value + ALIGN - 1) & ~(ALIGN - 1)
+
+
+def write_pak(out_path, files, store_only=False):
+    """Write (name, bytes) pairs to out_path as an archive."""
+    entries = []
+    for name, raw in files:
+        if len(name.encode()) >= NAME_LENGTH:
+            raise ValueError(f"{name}: name longer than {NAME_LENGTH - 1} bytes")
+        codec, payload = CODEC_STORED, raw
+        if not store_only and raw:
+            packed = lz4block.compress(raw)
+            if len(packed) < len(raw):
+                lz4block.decompress(packed, len(raw))  # round-trip check
+                codec, payload = CODEC_LZ4, packed
+        entries.append((name, codec, payload, len(raw)))
+
+    header_size = 16 + len(entries) * struct.calcsize(ENTRY_FORMAT)
+    offset = align_up(header_size)
+    index = bytearray()
+    for name, codec, payload, size in entries:
+        index += struct.pack(ENTRY_FORMAT, name.encode(), codec, offset, len(payload), size)
+        offset = align_up(offset + len(payload))
+
+    os.makedirs(os.path.dirname(out_path) or ".", exist_ok=True)
+    with open(out_path, "wb") as f:
+        f.write(PAK_MAGIC + struct.pack("<3I", PAK_VERSION, len(entries), 0))
+        f.write(index)
+        for _, _, payload, _ in entries:
+            f.write(b"\0" * (align_up(f.tell()) - f.tell()))
+            f.write(payload)
+
+    raw_total = sum(e[3] for e in entries)
+    print(f"Packed {len(entries)} entries, {raw_total} -> {os.path.getsize(out_path)} bytes: {out_path}")
+
+
+def main():
+    args = sys.argv[1:]
+    store_only = "--store" in args
+    args = [a for a in args if a != "--store"]
+    if len(args) < 2:
+        print(__doc__)
+        sys.exit(1)
+    out_path, specs = args[0], args[1:]
+
+    files = []
+    for spec in specs:
+        path, _, name = spec.partition("@")
+        with open(path, "rb") as f:
+            files.append((name or path, f.read()))
+    write_pak(out_path, files, store_only)
+
+
+if __name__ == "__main__":
+    main()
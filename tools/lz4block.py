@@ -0,0 +1,91 @@
+"""LZ4 block format compressor/decompressor with no dependencies.
+
+Produces standard LZ4 blocks (no frame header), so any LZ4 decoder can read
+them. The compressor is a greedy single-probe hash matcher: slower and a
+little weaker than liblz4, which is fine for offline asset packing.
+"""
+MIN_MATCH = 4
+LAST_LITERALS = 5    # the block must end with at least this many literals
+MATCH_LIMIT = 12     # no match may start within this many bytes of the end
+MAX_OFFSET = 65535
+
+
+def _write_length(out, value):
+    while value >= 255:
+        out.append(255)
+        value -= 255
+    out.append(value)
+
+
+def _emit(out, literals, offset=0, match_length=0):
+    lit = len(literals)
+    ml = match_length - MIN_MATCH if match_length else 0
+    out.append((min(lit, 15) << 4) | (min(ml, 15) if match_length else 0))
+    if lit >= 15:
+        _write_length(out, lit - 15)
+    out += literals
+    if match_length:
+        out += offset.to_bytes(2, "little")
+        if ml >= 15:
+            _write_length(out, ml - 15)
+
+
+def compress(data):
+    data = bytes(data)
+    n = len(data)
+    out = bytearray()
+    table = {}
+    anchor = 0
+    i = 0
+    while i < n - MATCH_LIMIT:
+        key = data[i:i + MIN_MATCH]
+        ref = table.get(key)
+        table[key] = i
+        if ref is None or i - ref > MAX_OFFSET:
+            i += 1
+            continue
+        length = MIN_MATCH
+        limit = n - LAST_LITERALS - i
+        while length < limit and data[ref + length] == data[i + length]:
+            length += 1
+        _emit(out, data[anchor:i], i - ref, length)
+        i += length
+        anchor = i
+    _emit(out, data[anchor:])
+    return bytes(out)
+
+
+def decompress(block, size):
+    out = bytearray()
+    pos = 0
+    while True:
+        token = block[pos]
+        pos += 1
+        lit = token >> 4
+        if lit == 15:
+            while True:
+                b = block[pos]
+                pos += 1
+                lit += b
+                if b != 255:
+                    break
+        out += block[pos:pos + lit]
+        pos += lit
+        if pos >= len(block):
+            break
+        offset = block[pos] | (block[pos + 1] << 8)
+        pos += 2
+        ml = token & 15
+        if ml == 15:
+            while True:
+                b = block[pos]
+                pos += 1
+                ml += b
+                if b != 255:
+                    break
+        start = len(out) - offset
+        for k in range(ml + MIN_MATCH):
+            out.append(out[start + k])
+    if len(out) != size:
+        raise ValueError(f"decoded {len(out)} bytes, expected {size}")
+    return bytes(out)
@@ -0,0 +1,108 @@
+"""Minimal PNG reader/writer (8/16-bit, non-interlaced) with no dependencies."""
+import struct
+import zlib
+
+PNG_SIGNATURE = b"\x89PNG\r\n\x1a\n"
+CHANNELS = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}
+
+
+def _paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def _unfilter(raw, width, height, bpp):
+    stride = width * bpp
+    out = bytearray(stride * height)
+    prev = bytearray(stride)
+    pos = 0
+    for y in range(height):
+        ftype = raw[pos]
+        line = bytearray(raw[pos + 1:pos + 1 + stride])
+        pos += 1 + stride
+        for x in range(stride):
+            a = line[x - bpp] if x >= bpp else 0
+            b = prev[x]
+            c = prev[x - bpp] if x >= bpp else 0
+            if ftype == 1:
+                line[x] = (line[x] + a) & 0xFF
+            elif ftype == 2:
+                line[x] = (line[x] + b) & 0xFF
+            elif ftype == 3:
+                line[x] = (line[x] + ((a + b) >> 1)) & 0xFF
+            elif ftype == 4:
+                line[x] = (line[x] + _paeth(a, b, c)) & 0xFF
+        out[y * stride:(y + 1) * stride] = line
+        prev = line
+    return out
+
+
+def read_png(path):
+    """Return (width, height, rgba_bytes)."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:8] != PNG_SIGNATURE:
+        raise ValueError(f"{path}: not a PNG file")
+
+    pos = 8
+    idat = bytearray()
+    palette = b""
+    trns = b""
+    width = height = depth = ctype = interlace = None
+    while pos < len(data):
+        length, tag = struct.unpack(">I4s", data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if tag == b"IHDR":
+            width, height, depth, ctype, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+        elif tag == b"PLTE":
+            palette = chunk
+        elif tag == b"tRNS":
+            trns = chunk
+        elif tag == b"IDAT":
+            idat += chunk
+        elif tag == b"IEND":
+            break
+
+    if depth not in (8, 16) or (depth == 16 and ctype == 3) or interlace != 0 or ctype not in CHANNELS:
+        raise ValueError(f"{path}: only 8/16-bit non-interlaced PNGs are supported")
+
+    bpp = CHANNELS[ctype]
+    pixels = _unfilter(zlib.decompress(bytes(idat)), width, height, bpp * depth // 8)
+    if depth == 16:
+        pixels = pixels[0::2]  # keep the high byte of each sample
+    rgba = bytearray(width * height * 4)
+    for i in range(width * height):
+        px = pixels[i * bpp:(i + 1) * bpp]
+        if ctype == 6:
+            rgba[i * 4:i * 4 + 4] = px
+        elif ctype == 2:
+            rgba[i * 4:i * 4 + 4] = bytes((px[0], px[1], px[2], 255))
+        elif ctype == 0:
+            rgba[i * 4:i * 4 + 4] = bytes((px[0], px[0], px[0], 255))
+        elif ctype == 4:
+            rgba[i * 4:i * 4 + 4] = bytes((px[0], px[0], px[0], px[1]))
+        else:
+            idx = px[0]
+            alpha = trns[idx] if idx < len(trns) else 255
+            rgba[i * 4:i * 4 + 4] = palette[idx * 3:idx * 3 + 3] + bytes((alpha,))
+    return width, height, bytes(rgba)
+
+
+def write_png(path, width, height, rgba):
+    """Write RGBA pixels as an 8-bit PNG."""
+    stride = width * 4
+    raw = b"".join(b"\x00" + rgba[y * stride:(y + 1) * stride] for y in range(height))
+
+    def chunk(tag, body):
+        crc = zlib.crc32(tag + body) & 0xFFFFFFFF
+        return struct.pack(">I", len(body)) + tag + body + struct.pack(">I", crc)
+
+    with open(path, "wb") as f:
+        f.write(PNG_SIGNATURE)
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 6, 0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(raw, 9)))
+        f.write(chunk(b"IEND", b""))
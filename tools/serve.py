@@ -0,0 +1,29 @@
+#!/usr/bin/env python3
+"""Static file server for the build directory.
+
+Sends the COOP/COEP headers browsers require before they expose
+SharedArrayBuffer, which the threaded (THREADS=1) build depends on.
+"""
+import functools
+import http.server
+import sys
+
+
+class IsolatedHandler(http.server.SimpleHTTPRequestHandler):
+    def end_headers(self):
+        self.send_header("Cross-Origin-Opener-Policy", "same-origin")
+        self.send_header("Cross-Origin-Embedder-Policy", "require-corp")
+        super().end_headers()
+
+
+def main():
+    directory = sys.argv[1] if len(sys.argv) > 1 else "build"
+    port = int(sys.argv[2]) if len(sys.argv) > 2 else 8080
+    handler = functools.partial(IsolatedHandler, directory=directory)
+    with http.server.ThreadingHTTPServer(("", port), handler) as server:
+        print(f"Serving {directory} on http://localhost:{port}")
+        server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()